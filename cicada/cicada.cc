@@ -33,6 +33,21 @@
 
 using namespace std;
 
+/**
+ * @brief Work of a worker which runs snapshot scans in the HTAP mix.
+ * @detail A scan is a read-only transaction, which reads at rts without
+ * validation. A partial scan starts at a random key.
+ */
+void scanWork(TxExecutor& trans, Xoroshiro128Plus& rnd, const bool& quit) {
+  uint64_t scan_size = FLAGS_scan_size ? FLAGS_scan_size : FLAGS_tuple_num;
+  while (!loadAcquire(quit)) {
+    trans.tbegin();
+    trans.tscan(scan_size == FLAGS_tuple_num ? 0 : rnd.next() % FLAGS_tuple_num,
+                scan_size, quit);
+    trans.mainte();
+  }
+}
+
 void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
   Xoroshiro128Plus rnd;
   rnd.init();
@@ -54,8 +69,18 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
   // printf("Thread %d on CPU %d\n", *myid, nowcpu);
 #endif  // Darwin
 
+#if REUSE_VERSION
+  SlabAllocator<Version>& slab = VersionAllocators[thid];
+  slab.reserve(FLAGS_pre_reserve_version);
+#endif
+
   storeRelease(ready, 1);
   while (!loadAcquire(start)) _mm_pause();
+  // the last scan_thread_num workers scan.
+  if (thid >= FLAGS_thread_num - FLAGS_scan_thread_num) {
+    scanWork(trans, rnd, quit);
+    return;
+  }
   while (!loadAcquire(quit)) {
     /* シングル実行で絶対に競合を起こさないワークロードにおいて，
      * 自トランザクションで read した後に write するのは複雑になる．
@@ -81,7 +106,9 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
 
   RETRY:
     if (thid == 0) {
+#if !MAINTENANCE_THREAD
       leaderWork(std::ref(backoff));
+#endif
 #if BACK_OFF
       leaderBackoffWork(backoff, CicadaResult);
 #endif
@@ -133,6 +160,15 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
        */
       storeRelease(myres.local_commit_counts_,
                    loadAcquire(myres.local_commit_counts_) + 1);
+
+      /**
+       * Maintenance phase
+       * A read-only transaction is a quiescent state, too.
+       */
+#if SINGLE_EXEC
+#else
+      trans.mainte();
+#endif
     } else {
       /**
        * Validation phase
@@ -170,6 +206,20 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
     }
   }
 
+  // the others may wait for the versions of this worker in the last group.
+  if (FLAGS_group_commit) trans.gcpv();
+
+#if REUSE_VERSION && ADD_ANALYSIS
+  myres.local_version_malloc_ += slab.fresh_;
+  myres.local_version_remote_frees_ += slab.remote_frees_;
+  myres.local_version_reuse_ += slab.reuses_;
+  myres.local_version_slab_bytes_ += slab.chunks_ * slab.kChunkSize;
+#endif
+#if ADD_ANALYSIS
+  myres.local_reclaim_lag_ += trans.limbo_.lag_sum_;
+  myres.local_reclaim_lag_max_ = trans.limbo_.lag_max_;
+#endif
+
   return;
 }
 
@@ -191,17 +241,36 @@ int main(int argc, char* argv[]) try {
                      std::ref(quit));
   waitForReady(readys);
   storeRelease(start, true);
+  HtapSampler sampler;
+  sampler.start();
+#if MAINTENANCE_THREAD
+  MaintenanceThread maintainer;
+  maintainer.start(FLAGS_maintenance_tick_us, FLAGS_clocks_per_us,
+                   [backoff = Backoff(FLAGS_clocks_per_us)]() mutable {
+                     leaderWork(backoff);
+                   });
+#endif
   for (size_t i = 0; i < FLAGS_extime; ++i) {
     sleepMs(1000);
+    if (FLAGS_scan_thread_num) htapSample(sampler);
   }
   storeRelease(quit, true);
   for (auto& th : thv) th.join();
+#if MAINTENANCE_THREAD
+  maintainer.stop();
+#endif
 
   for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
     CicadaResult[0].addLocalAllResult(CicadaResult[i]);
   }
   ShowOptParameters();
   CicadaResult[0].displayAllResult(FLAGS_clocks_per_us, FLAGS_extime, FLAGS_thread_num);
+  WatermarkStat.display("watermark", FLAGS_clocks_per_us);
+  Reclaimer.display();
+  if (FLAGS_scan_thread_num) displayHtap(sampler);
+#if MAINTENANCE_THREAD
+  maintainer.display();
+#endif
   deleteDB();
 
   return 0;
@@ -7,8 +7,13 @@
 
 #include "../../include/cache_line_size.hh"
 #include "../../include/int64byte.hh"
+#include "../../include/maintenance.hh"
 #include "../../include/masstree_wrapper.hh"
+#include "../../include/reclaim.hh"
+#include "../../include/slab.hh"
+#include "htap.hh"
 #include "lock.hh"
+#include "log.hh"
 #include "tuple.hh"
 #include "version.hh"
 
@@ -17,7 +22,6 @@
 
 #ifdef GLOBAL_VALUE_DEFINE
 #define GLOBAL
-alignas(CACHE_LINE_SIZE) GLOBAL std::atomic<uint64_t> MinRts(0);
 alignas(CACHE_LINE_SIZE) GLOBAL std::atomic<uint64_t> MinWts(0);
 alignas(
     CACHE_LINE_SIZE) GLOBAL std::atomic<unsigned int> FirstAllocateTimestamp(0);
@@ -26,7 +30,6 @@ alignas(CACHE_LINE_SIZE) GLOBAL MasstreeWrapper<Tuple> MT;
 #endif
 #else
 #define GLOBAL extern
-alignas(CACHE_LINE_SIZE) GLOBAL std::atomic<uint64_t> MinRts;
 alignas(CACHE_LINE_SIZE) GLOBAL std::atomic<uint64_t> MinWts;
 alignas(
     CACHE_LINE_SIZE) GLOBAL std::atomic<unsigned int> FirstAllocateTimestamp;
@@ -41,7 +44,16 @@ DEFINE_uint64(extime, 3, "Execution time[sec].");
 DEFINE_uint64(gc_inter_us, 10, "GC interval[us].");
 DEFINE_uint64(group_commit, 0, "Group commit number of transactions.");
 DEFINE_uint64(group_commit_timeout_us, 2, "Timeout used for deadlock resolution when performing group commit[us].");
-DEFINE_uint64(io_time_ns, 5, "Delay inserted instead of IO.");
+DEFINE_string(log_dirs, "",
+              "Comma-separated log directories. Log segments are "
+              "spread over them. Empty means ./log .");
+DEFINE_bool(log_recycle, false,
+            "Recycle log segments written before. There is no checkpoint, so "
+            "the log loses committed frames.");
+DEFINE_uint64(log_segment_num, 4,
+              "Number of log segments preallocated per log writer.");
+DEFINE_uint64(log_segment_size, 64 << 20, "Size of a log segment[byte].");
+DEFINE_uint64(maintenance_tick_us, 10, "Tick of the maintenance thread[us]. It is used by MAINTENANCE_THREAD.");
 DEFINE_uint64(max_ope, 10,
               "Total number of operations per single transaction.");
 DEFINE_uint64(pre_reserve_version, 10000, "Pre-allocating memory for the version.");
@@ -50,8 +62,16 @@ DEFINE_bool(rmw, false,
             "True means read modify write, false means blind write.");
 DEFINE_uint64(rratio, 50, "read ratio of single transaction.");
 DEFINE_bool(s_wal, false, "Normal write-ahead logging.");
+DEFINE_uint64(scan_size, 0,
+              "Number of records a scan reads. 0 means the whole table.");
+DEFINE_uint64(scan_thread_num, 0,
+              "Number of worker threads which run snapshot scans instead of "
+              "YCSB transactions.");
 DEFINE_uint64(thread_num, 10, "Total number of worker threads.");
 DEFINE_uint64(tuple_num, 1000000, "Total number of records.");
+DEFINE_bool(version_numa_local, false,
+            "Bind version slabs to the NUMA node of their worker. It is used "
+            "by REUSE_VERSION.");
 DEFINE_bool(ycsb, true,
             "True uses zipf_skew, false uses faster random generator.");
 DEFINE_uint64(worker1_insert_delay_rphase_us, 0, "Worker 1 insert delay in the end of read phase[us].");
@@ -62,15 +82,22 @@ DECLARE_uint64(extime);
 DECLARE_uint64(gc_inter_us);
 DECLARE_uint64(group_commit);
 DECLARE_uint64(group_commit_timeout_us);
-DECLARE_uint64(io_time_ns);
+DECLARE_string(log_dirs);
+DECLARE_bool(log_recycle);
+DECLARE_uint64(log_segment_num);
+DECLARE_uint64(log_segment_size);
+DECLARE_uint64(maintenance_tick_us);
 DECLARE_uint64(max_ope);
 DECLARE_uint64(pre_reserve_version);
 DECLARE_bool(p_wal);
 DECLARE_bool(rmw);
 DECLARE_uint64(rratio);
 DECLARE_bool(s_wal);
+DECLARE_uint64(scan_size);
+DECLARE_uint64(scan_thread_num);
 DECLARE_uint64(thread_num);
 DECLARE_uint64(tuple_num);
+DECLARE_bool(version_numa_local);
 DECLARE_bool(ycsb);
 DECLARE_uint64(worker1_insert_delay_rphase_us);
 DECLARE_double(zipf_skew);
@@ -81,20 +108,28 @@ alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte *ThreadRtsArray;
 alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte
     *ThreadRtsArrayForGroup;  // グループコミットをする時，これが必要である．
 
-alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte *GROUP_COMMIT_INDEX;
-alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte
-    *GROUP_COMMIT_COUNTER;  // s-walの時は[0]のみ使用。全スレッドで共有。
-
-alignas(
-    CACHE_LINE_SIZE) GLOBAL Version ***PLogSet;  // [thID][index] pointer array
-alignas(CACHE_LINE_SIZE) GLOBAL Version **SLogSet;  // [index] pointer array
+// p-wal log buffer of each worker. [thID]
+alignas(CACHE_LINE_SIZE) GLOBAL LogBuffer *PLogSet;
+// s-wal log buffer shared by all workers.
+GLOBAL LogBuffer SLogSet;
+// SwalLock protects the group in SLogSet, SwalFlushLock its log segments.
 GLOBAL RWLock SwalLock;
+GLOBAL RWLock SwalFlushLock;
 GLOBAL RWLock CtrLock;
 
-alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte *GCFlag;
-alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte *GCExecuteFlag;
+// reclamation of versions. Its watermark is the minimum rts (MinRts).
+GLOBAL EpochReclaimer Reclaimer;
+GLOBAL MaintenanceStat WatermarkStat;  // MinRts and MinWts
+
+// progress of each worker read during the run. [thID]
+alignas(CACHE_LINE_SIZE) GLOBAL HtapCounter *HtapCounters;
+
+// version slab of each worker [thID], then of each loader.
+alignas(CACHE_LINE_SIZE) GLOBAL SlabAllocator<Version> *VersionAllocators;
 
 alignas(CACHE_LINE_SIZE) GLOBAL Tuple *Table;
 alignas(CACHE_LINE_SIZE) GLOBAL uint64_t InitialWts;
 
 #define SPIN_WAIT_TIMEOUT_US 2
+// a scan checks quit and quiescent states at every this number of records.
+#define SCAN_CHECK_INTERVAL 1024
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+#include "../../include/cache_line_size.hh"
+#include "../../include/tsc.hh"
+
+/**
+ * @brief Progress of a worker which the main thread reads during the run.
+ * @detail Only the worker writes it, so an increment is a load and a store.
+ */
+class alignas(CACHE_LINE_SIZE) HtapCounter {
+ public:
+  std::atomic<uint64_t> scans_{0};
+  std::atomic<uint64_t> scan_records_{0};
+  std::atomic<uint64_t> installs_{0};  // versions linked into version lists
+  std::atomic<uint64_t> frees_{0};     // versions freed by garbage collection
+
+  static void add(std::atomic<uint64_t> &counter, uint64_t num) {
+    counter.store(counter.load(std::memory_order_relaxed) + num,
+                  std::memory_order_relaxed);
+  }
+};
+
+/**
+ * @brief Time series of the HTAP mix, that is, OLTP throughput, scan
+ * bandwidth, length of version lists and lag of garbage collection.
+ * @detail sample() is called by the main thread at every second and prints
+ * the rates since the previous sample.
+ */
+class HtapSampler {
+ public:
+  uint64_t start_ = 0;  // [clocks]
+  uint64_t prev_time_ = 0;
+  uint64_t prev_commits_ = 0;
+  uint64_t prev_scan_records_ = 0;
+  long double versions_per_record_max_ = 0;
+  uint64_t gc_lag_max_ = 0;  // [clocks]
+
+  void start() { start_ = prev_time_ = rdtscp(); }
+
+  /**
+   * @param [in] commits committed OLTP transactions so far.
+   * @param [in] scan_records records read by scans so far.
+   * @param [in] versions_per_record live versions per record.
+   * @param [in] gc_lag how far the GC watermark is behind MinWts [clocks].
+   * @return void
+   */
+  void sample(std::size_t clocks_per_us, std::size_t record_size,
+              uint64_t commits, uint64_t scan_records,
+              long double versions_per_record, uint64_t gc_lag) {
+    uint64_t now = rdtscp();
+    long double sec = (long double)(now - prev_time_) /
+                      (long double)clocks_per_us / 1000000.0;
+    if (versions_per_record > versions_per_record_max_)
+      versions_per_record_max_ = versions_per_record;
+    if (gc_lag > gc_lag_max_) gc_lag_max_ = gc_lag;
+
+    std::cout << std::fixed << std::setprecision(2) << "htap["
+              << (long double)(now - start_) / (long double)clocks_per_us /
+                     1000000.0
+              << "s]\toltp_tps: " << (commits - prev_commits_) / sec
+              << "\tscan_bandwidth[MB/s]: "
+              << (scan_records - prev_scan_records_) * record_size / sec /
+                     1000000.0
+              << "\tversions_per_record: " << versions_per_record
+              << "\tgc_lag[ms]: "
+              << (long double)gc_lag / (long double)clocks_per_us / 1000.0
+              << std::endl;
+
+    prev_time_ = now;
+    prev_commits_ = commits;
+    prev_scan_records_ = scan_records;
+  }
+
+  void display(std::size_t clocks_per_us, std::size_t extime,
+               std::size_t record_size, uint64_t scans,
+               uint64_t scan_records) {
+    std::cout << "htap_scans:\t" << scans << std::endl;
+    std::cout << "htap_scan_records:\t" << scan_records << std::endl;
+    std::cout << std::fixed << std::setprecision(2)
+              << "htap_scan_bandwidth[MB/s]:\t"
+              << (long double)scan_records * record_size / extime / 1000000.0
+              << std::endl;
+    std::cout << std::setprecision(4) << "htap_versions_per_record_max:\t"
+              << versions_per_record_max_ << std::endl;
+    std::cout << "htap_gc_lag_max[ms]:\t"
+              << (long double)gc_lag_max_ / (long double)clocks_per_us / 1000.0
+              << std::endl;
+  }
+};
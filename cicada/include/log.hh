@@ -0,0 +1,133 @@
+#pragma once
+
+#include <string.h>
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "../../include/cache_line_size.hh"
+#include "../../include/log_segment.hh"
+#include "version.hh"
+
+class LogHeader {
+ public:
+  int chkSum_ = 0;
+  unsigned int logRecNum_ = 0;
+  const std::size_t len_val_ = VAL_SIZE;
+
+  void init() {
+    chkSum_ = 0;
+    logRecNum_ = 0;
+  }
+
+  void convertChkSumIntoComplementOnTwo() {
+    chkSum_ ^= 0xffffffff;
+    ++chkSum_;
+  }
+};
+
+/**
+ * @brief After-image of a record written by a committed transaction.
+ * wts_ is the commit timestamp of the transaction.
+ */
+class LogRecord {
+ public:
+  uint64_t wts_;
+  uint64_t key_;
+  char val_[VAL_SIZE];
+
+  LogRecord() : wts_(0), key_(0) {}
+
+  LogRecord(uint64_t wts, uint64_t key, const char *val)
+      : wts_(wts), key_(key) {
+    memcpy(this->val_, val, VAL_SIZE);
+  }
+
+  int computeChkSum() {
+    // compute checksum
+    int chkSum = 0;
+    int *itr = (int *)this;
+    for (unsigned int i = 0; i < sizeof(LogRecord) / sizeof(int); ++i) {
+      chkSum += (*itr);
+      ++itr;
+    }
+
+    return chkSum;
+  }
+};
+
+/**
+ * @brief Log records of a group of committed transactions and their pending
+ * versions.
+ * @detail p-wal gives each worker its own buffer and log segments. s-wal
+ * shares a buffer and log segments among all workers. The pending versions
+ * are committed only after write() made the records durable, so no
+ * transaction reads a version which may be lost.
+ */
+class alignas(CACHE_LINE_SIZE) LogBuffer {
+ public:
+  LogSegmentManager logseg_;
+  LogHeader header_;
+  std::vector<LogRecord> records_;
+  std::vector<Version *> pending_;
+  uint64_t tx_num_ = 0;
+  uint64_t max_wts_ = 0;
+  uint64_t start_ = 0;  // when the first transaction of the group came.
+
+  void add(uint64_t wts, uint64_t key, const char *val, Version *ver) {
+    records_.emplace_back(wts, key, val);
+    header_.chkSum_ += records_.back().computeChkSum();
+    ++header_.logRecNum_;
+    pending_.emplace_back(ver);
+    if (max_wts_ < wts) max_wts_ = wts;
+  }
+
+  void clear() {
+    header_.init();
+    records_.clear();
+    pending_.clear();
+    tx_num_ = 0;
+    max_wts_ = 0;
+  }
+
+  /**
+   * @brief take the group of other. other gets the empty buffers of this.
+   * @pre this is empty.
+   * @return void
+   */
+  void take(LogBuffer &other) {
+    std::swap(header_.chkSum_, other.header_.chkSum_);
+    std::swap(header_.logRecNum_, other.header_.logRecNum_);
+    records_.swap(other.records_);
+    pending_.swap(other.pending_);
+    std::swap(tx_num_, other.tx_num_);
+    std::swap(max_wts_, other.max_wts_);
+    start_ = other.start_;
+  }
+
+  /**
+   * @brief write the records to logseg as a frame and make them durable.
+   * @param [in] logseg log segments of the log writer.
+   * @param [in] recycle whether full segments written before are recycled.
+   * @return the number of bytes written.
+   */
+  std::size_t write(LogSegmentManager &logseg, bool recycle) {
+    if (records_.empty()) return 0;
+    header_.convertChkSumIntoComplementOnTwo();
+    struct iovec iov[2] = {
+        {&header_, sizeof(LogHeader)},
+        {&(records_[0]), sizeof(LogRecord) * records_.size()}};
+    // there is no checkpoint, so recycling drops committed frames.
+    if (recycle) logseg.setReclaimEpoch(max_wts_);
+    logseg.write(iov, 2, max_wts_);
+    logseg.fdatasync();
+    return sizeof(LogHeader) + sizeof(LogRecord) * records_.size();
+  }
+
+  void commitPending() {
+    for (auto itr = pending_.begin(); itr != pending_.end(); ++itr)
+      (*itr)->status_.store(VersionStatus::committed, memory_order_release);
+  }
+};
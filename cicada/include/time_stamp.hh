@@ -1,14 +1,26 @@
 #pragma once
 
+#include <cstdint>
+
 #include "../../include/cache_line_size.hh"
 #include "../../include/tsc.hh"
 
+/**
+ * @brief Timestamp of a worker. The low kTidBits bits are the thread id and
+ * the rest is the local clock.
+ * @detail The local clock counts from the first timestamp of the process
+ * rather than from the boot, so the clock doesn't overflow even though the
+ * thread id takes more bits.
+ */
 class TimeStamp {
  public:
+  static constexpr unsigned int kTidBits = 10;
+  static constexpr uint64_t kMaxThreads = 1ULL << kTidBits;
+
   alignas(CACHE_LINE_SIZE) uint64_t ts_ = 0;
   uint64_t localClock_ = 0;
   uint64_t clockBoost_ = 0;
-  uint8_t thid_;
+  uint16_t thid_;
 
   TimeStamp() {}
   inline uint64_t get_ts() { return ts_; }
@@ -19,14 +31,14 @@ class TimeStamp {
     clockBoost_ = CLOCK_PER_US;
   }
 
-  inline void generateTimeStampFirst(uint8_t tid) {
-    localClock_ = rdtscp();
-    ts_ = (localClock_ << (sizeof(tid) * 8)) | tid;
+  inline void generateTimeStampFirst(uint16_t tid) {
+    localClock_ = clock();
+    ts_ = (localClock_ << kTidBits) | tid;
     thid_ = tid;
   }
 
-  inline void generateTimeStamp(uint8_t tid) {
-    uint64_t tmp = rdtscp();
+  inline void generateTimeStamp(uint16_t tid) {
+    uint64_t tmp = clock();
     uint64_t elapsedTime = tmp - localClock_;
     if (tmp < localClock_) elapsedTime = 0;
 
@@ -34,6 +46,14 @@ class TimeStamp {
     localClock_ += elapsedTime;
     localClock_ += clockBoost_;
 
-    ts_ = (localClock_ << (sizeof(tid) * 8)) | tid;
+    ts_ = (localClock_ << kTidBits) | tid;
+  }
+
+ private:
+  static uint64_t clock() {
+    static const uint64_t base = rdtscp();
+    uint64_t now = rdtscp();
+    // the clock of another core may be a little behind.
+    return now > base ? now - base : 0;
   }
 };
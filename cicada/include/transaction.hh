@@ -16,6 +16,7 @@
 #include "../../include/util.hh"
 #include "cicada_op_element.hh"
 #include "common.hh"
+#include "log.hh"
 #include "time_stamp.hh"
 #include "tuple.hh"
 #include "version.hh"
@@ -36,21 +37,23 @@ class TxExecutor {
   std::vector<ReadElement<Tuple>> read_set_;
   std::vector<WriteElement<Tuple>> write_set_;
   std::deque<GCElement<Tuple>> gcq_;
-  std::deque<Version*> reuse_version_from_gc_;
+  LimboList<GCElement<Tuple>> limbo_;  // detached version lists
   std::vector<Procedure> pro_set_;
   Result* cres_ = nullptr;
 
   bool ronly_;
-  uint8_t thid_ = 0;
+  uint16_t thid_ = 0;
   uint64_t rts_;
   uint64_t start_, stop_;                // for one-sided synchronization
-  uint64_t grpcmt_start_, grpcmt_stop_;  // for group commit
   uint64_t gcstart_, gcstop_;            // for garbage collection
+  uint64_t gc_epoch_ = 0;  // epoch of Reclaimer at the last collection
+
+  LogBuffer swal_group_;  // s-wal group which this worker flushes
 
   char return_val_[VAL_SIZE] = {};
   char write_val_[VAL_SIZE] = {};
 
-  TxExecutor(uint8_t thid, Result* cres) : cres_(cres), thid_(thid) {
+  TxExecutor(uint16_t thid, Result* cres) : cres_(cres), thid_(thid) {
     // wait to initialize MinWts
     while (MinWts.load(memory_order_acquire) == 0)
       ;
@@ -71,23 +74,15 @@ class TxExecutor {
     write_set_.reserve(FLAGS_max_ope);
     pro_set_.reserve(FLAGS_max_ope);
 
-    if (FLAGS_pre_reserve_version) {
-      for (size_t i = 0; i < FLAGS_pre_reserve_version; ++i)
-        reuse_version_from_gc_.emplace_back(new Version());
-    }
-
     genStringRepeatedNumber(write_val_, VAL_SIZE, thid_);
 
     start_ = rdtscp();
     gcstart_ = start_;
+    Reclaimer.enter(thid_, rts_);
   }
 
   ~TxExecutor() {
-    for (auto itr = reuse_version_from_gc_.begin();
-         itr != reuse_version_from_gc_.end(); ++itr) {
-      if ((*itr)->status_ == VersionStatus::unused) delete (*itr);
-    }
-    reuse_version_from_gc_.clear();
+    Reclaimer.leave(thid_);
     read_set_.clear();
     write_set_.clear();
     gcq_.clear();
@@ -106,10 +101,23 @@ class TxExecutor {
   void swal();
   void tbegin();
   void tread(const uint64_t key);
+  uint64_t tscan(uint64_t key, uint64_t num, const bool& quit);
   void twrite(const uint64_t key);
   bool validation();
   void writePhase();
 
+  /**
+   * @brief wait for the result of the pending version.
+   * @detail With group commit, the version may wait for the flush of the
+   * group which has transactions of this worker, so it checks the timeout
+   * of the group to avoid dead lock.
+   */
+  void waitPending(Version* ver) {
+    while (ver->ldAcqStatus() == VersionStatus::pending) {
+      if (FLAGS_group_commit) chkGcpvTimeout();
+    }
+  }
+
   void backoff() {
 #if ADD_ANALYSIS
     uint64_t start = rdtscp();
@@ -122,7 +130,26 @@ class TxExecutor {
 #endif
   }
 
+#if ADD_ANALYSIS
+  /**
+   * @brief record the length of the version list of tuple before garbage
+   * collection truncates it.
+   * @return void
+   */
+  void countChainLength(Tuple* tuple) {
+    uint64_t len = 0;
+    for (Version* ver = tuple->ldAcqLatest(); ver != nullptr;
+         ver = ver->next_.load(std::memory_order_acquire))
+      ++len;
+    ++cres_->local_gc_chains_;
+    cres_->local_gc_chain_length_ += len;
+    if (cres_->local_gc_chain_length_max_ < len)
+      cres_->local_gc_chain_length_max_ = len;
+  }
+#endif
+
   void gcAfterThisVersion([[maybe_unused]] Tuple* tuple, Version* delTarget) {
+    uint64_t freed = 0;
     while (delTarget != nullptr) {
       // escape next pointer
       Version* tmp = delTarget->next_.load(std::memory_order_acquire);
@@ -135,7 +162,7 @@ class TxExecutor {
 #endif  // if INLINE_VERSION_OPT
 
 #if REUSE_VERSION
-      reuse_version_from_gc_.emplace_back(delTarget);
+      VersionAllocators[thid_].free(delTarget);
 #else   // if REUSE_VERSION
       delete delTarget;
 #endif  // if REUSE_VERSION
@@ -144,8 +171,10 @@ class TxExecutor {
 #if ADD_ANALYSIS
           ++cres_->local_gc_version_counts_;
 #endif
+      ++freed;
       delTarget = tmp;
     }
+    HtapCounter::add(HtapCounters[thid_].frees_, freed);
   }
 
 #if INLINE_VERSION_OPT
@@ -153,7 +182,7 @@ class TxExecutor {
   void inlineVersionPromotion(const uint64_t key, Tuple* tuple,
                               Version* later_ver, Version* ver) {
     if (ver != &(tuple->inline_ver_) &&
-        MinRts.load(std::memory_order_acquire) > ver->ldAcqWts() &&
+        Reclaimer.watermark() > ver->ldAcqWts() &&
         tuple->inline_ver_.status_.load(std::memory_order_acquire) ==
             VersionStatus::unused) {
       twrite(key);
@@ -178,21 +207,15 @@ class TxExecutor {
 #endif  // if INLINE_VERSION_OPT
 
 #if REUSE_VERSION
-    if (!reuse_version_from_gc_.empty()) {
-#if ADD_ANALYSIS
-      ++cres_->local_version_reuse_;
-#endif
-      Version* newVersion = reuse_version_from_gc_.back();
-      reuse_version_from_gc_.pop_back();
-      newVersion->set(0, this->wts_.ts_);
-      return newVersion;
-    }
-#endif
-
+    Version* newVersion = VersionAllocators[thid_].allocate();
+    newVersion->set(0, this->wts_.ts_);
+    return newVersion;
+#else
 #if ADD_ANALYSIS
     ++cres_->local_version_malloc_;
 #endif
     return new Version(0, this->wts_.ts_);
+#endif
   }
 
   bool precheckInValidation() {
@@ -303,9 +326,7 @@ class TxExecutor {
 #endif
 
 #if REUSE_VERSION
-        (*itr).new_ver_->status_.store(VersionStatus::unused,
-                                       std::memory_order_release);
-        reuse_version_from_gc_.emplace_back((*itr).new_ver_);
+        VersionAllocators[thid_].free((*itr).new_ver_);
 #else
         delete (*itr).new_ver_;
 #endif
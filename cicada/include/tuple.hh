@@ -17,14 +17,14 @@ class Tuple {
   atomic<Version *> latest_;
   atomic<uint64_t> min_wts_;
   atomic<uint64_t> continuing_commit_;
-  atomic<uint8_t> gc_lock_;
+  atomic<uint16_t> gc_lock_;  // thread id + 1 of the holder
 
   Tuple() : latest_(nullptr), gc_lock_(0) {}
 
   Version *ldAcqLatest() { return latest_.load(std::memory_order_acquire); }
 
-  bool getGCRight(uint8_t thid) {
-    uint8_t expected, desired(thid);
+  bool getGCRight(uint16_t thid) {
+    uint16_t expected, desired(thid);
     expected = this->gc_lock_.load(std::memory_order_acquire);
     for (;;) {
       if (expected != 0) return false;
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "../../include/backoff.hh"
+#include "htap.hh"
 
 extern void chkArg();
 
@@ -10,6 +11,8 @@ extern void deleteDB();
 
 extern void displayDB();
 
+extern void displayHtap(HtapSampler &sampler);
+
 extern void displayMinRts();
 
 extern void displayMinWts();
@@ -22,6 +25,8 @@ extern void displayThreadWtsArray();
 
 extern void displayThreadRtsArray();
 
+extern void htapSample(HtapSampler &sampler);
+
 extern void leaderWork([[maybe_unused]] Backoff &backoff);
 
 extern void makeDB(uint64_t *initial_wts);
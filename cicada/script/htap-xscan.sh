@@ -0,0 +1,39 @@
+#htap-xscan.sh(cicada)
+# YCSB updates concurrent with snapshot scans. It varies the number of scan
+# threads and keeps the time series of each run.
+tuple=1000000
+maxope=10
+rratio=50
+skew=0.9
+cpu_mhz=2100
+gci=10
+extime=10
+scan_size=0
+
+host=`hostname`
+dbs11="dbs11"
+
+#basically
+thread=24
+if  test $host = $dbs11 ; then
+thread=224
+fi
+
+cd ../
+make clean; make -j
+cd script/
+
+result=result_cicada_htap_tuple1m_ope10_rmw_skew09_xscan.dat
+rm $result
+echo "#scan_thread_num, oltp_tps, scan_bandwidth[MB/s], versions_per_record_max, gc_lag_max[ms]" >> $result
+
+for scan_thread in 0 1 2 4 8
+do
+  numactl --interleave=all ../cicada.exe -clocks_per_us=$cpu_mhz -extime=$extime -gc_inter_us=$gci -max_ope=$maxope -rmw=1 -rratio=$rratio -scan_size=$scan_size -scan_thread_num=$scan_thread -thread_num=$thread -tuple_num=$tuple -ycsb=1 -zipf_skew=$skew > exp.txt
+  grep "^htap\[" ./exp.txt > htap_scan$scan_thread.txt
+  tmpTH=`grep throughput ./exp.txt | awk '{print $2}'`
+  tmpSB=`grep htap_scan_bandwidth ./exp.txt | awk '{print $2}'`
+  tmpVR=`grep htap_versions_per_record_max ./exp.txt | awk '{print $2}'`
+  tmpGL=`grep htap_gc_lag_max ./exp.txt | awk '{print $2}'`
+  echo "$scan_thread $tmpTH $tmpSB $tmpVR $tmpGL" >> $result
+done
@@ -27,7 +27,7 @@ extern void displayDB();
 
 using namespace std;
 
-#define MSK_TID 0b11111111
+#define MSK_TID ((1ULL << TimeStamp::kTidBits) - 1)
 
 /**
  * @brief Initialize function of transaction.
@@ -45,6 +45,15 @@ void TxExecutor::tbegin() {
   this->rts_ = MinWts.load(std::memory_order_acquire) - 1;
   __atomic_store_n(&(ThreadRtsArray[thid_].obj_), this->rts_, __ATOMIC_RELEASE);
 
+  if (FLAGS_group_commit) {
+    // check time out of the group which has transactions of this worker.
+    chkGcpvTimeout();
+    // the oldest transaction of this worker whose versions may be pending.
+    if (FLAGS_s_wal || loadAcquire(PLogSet[thid_].tx_num_) == 0)
+      __atomic_store_n(&(ThreadRtsArrayForGroup[thid_].obj_), this->rts_,
+                       __ATOMIC_RELEASE);
+  }
+
   /* one-sided synchronization
    * tanabe... disabled.
    * When the database size is small that all record can be on
@@ -138,8 +147,7 @@ void TxExecutor::tread(const uint64_t key) {
     /**
      * Wait for the result of the pending version in the view.
      */
-    while (ver->status_.load(memory_order_acquire) == VersionStatus::pending) {
-    }
+    waitPending(ver);
     if (ver->status_.load(memory_order_acquire) == VersionStatus::aborted) {
       ver = ver->ldAcqNext();
     }
@@ -179,6 +187,60 @@ END_TREAD:
   return;
 }
 
+/**
+ * @brief Snapshot scan of a read-only transaction.
+ * @detail It reads num records from key, wrapping around the table, at rts_
+ * without tracking or validating them. A scan may take long, so between
+ * records it announces quiescent states with rts_. The epoch keeps advancing,
+ * but MinRts stays at or below rts_ until the scan ends. Its wts_ is advanced
+ * too, because it writes nothing and shouldn't hold back MinWts.
+ * @param [in] quit the scan stops when it is set.
+ * @return the number of records read.
+ */
+uint64_t TxExecutor::tscan(uint64_t key, uint64_t num, const bool &quit) {
+  uint64_t i;
+  for (i = 0; i < num; ++i) {
+    if ((i & (SCAN_CHECK_INTERVAL - 1)) == SCAN_CHECK_INTERVAL - 1) {
+      if (loadAcquire(quit)) break;
+      this->gcstop_ = rdtscp();
+      if (chkClkSpan(this->gcstart_, this->gcstop_,
+                     FLAGS_gc_inter_us * FLAGS_clocks_per_us) &&
+          !Reclaimer.announced(thid_)) {
+        Reclaimer.announce(thid_, this->rts_);
+        this->wts_.generateTimeStamp(thid_);
+        __atomic_store_n(&(ThreadWtsArray[thid_].obj_), this->wts_.ts_,
+                         __ATOMIC_RELEASE);
+        this->gcstart_ = this->gcstop_;
+      }
+    }
+
+#if MASSTREE_USE
+    Tuple *tuple = MT.get_value(key);
+#else
+    Tuple *tuple = get_tuple(Table, key);
+#endif
+#if SINGLE_EXEC
+    Version *ver = &tuple->inline_ver_;
+#else
+    Version *ver = tuple->ldAcqLatest();
+    while (ver->ldAcqWts() > this->rts_) ver = ver->ldAcqNext();
+    while (ver->status_.load(memory_order_acquire) !=
+           VersionStatus::committed) {
+      waitPending(ver);
+      if (ver->status_.load(memory_order_acquire) == VersionStatus::aborted)
+        ver = ver->ldAcqNext();
+    }
+#endif
+    memcpy(return_val_, ver->val_, VAL_SIZE);
+
+    if (++key == FLAGS_tuple_num) key = 0;
+  }
+
+  HtapCounter::add(HtapCounters[thid_].scan_records_, i);
+  if (i == num) HtapCounter::add(HtapCounters[thid_].scans_, 1);
+  return i;
+}
+
 /**
  * @brief Transaction write function.
  * @param [in] key The key of key-value
@@ -351,6 +413,7 @@ bool TxExecutor::validation() {
       }
     }
     (*itr).finish_version_install_ = true;
+    HtapCounter::add(HtapCounters[thid_].installs_, 1);
   }
 
   /**
@@ -373,12 +436,10 @@ bool TxExecutor::validation() {
     while (ver->ldAcqWts() >= this->wts_.ts_) ver = ver->ldAcqNext();
     // if write after read occured, it may happen "==".
 
-    while (ver->ldAcqStatus() == VersionStatus::pending)
-      ;
+    waitPending(ver);
     while (ver->ldAcqStatus() != VersionStatus::committed) {
       ver = ver->ldAcqNext();
-      while (ver->ldAcqStatus() == VersionStatus::pending)
-        ;
+      waitPending(ver);
     }
     /**
      * This part is different from the original.
@@ -397,12 +458,10 @@ bool TxExecutor::validation() {
    */
   for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
     Version *ver = (*itr).new_ver_->ldAcqNext();
-    while (ver->ldAcqStatus() == VersionStatus::pending)
-      ;
+    waitPending(ver);
     while (ver->ldAcqStatus() != VersionStatus::committed) {
       ver = ver->ldAcqNext();
-      while (ver->ldAcqStatus() == VersionStatus::pending)
-        ;
+      waitPending(ver);
     }
 
     if (ver->ldAcqRts() > this->wts_.ts_) {
@@ -418,88 +477,54 @@ FINISH_VALIDATION:
   return result;
 }
 
+/**
+ * @brief serial write-ahead logging.
+ * @detail It appends the write set to the group shared by all workers.
+ * Without group commit, it flushes the group and returns after its versions
+ * are committed, which another worker may have done by flushing the group.
+ * @return void
+ */
 void TxExecutor::swal() {
-  if (!FLAGS_group_commit) {  // non-group commit
-    SwalLock.w_lock();
-
-    int i = 0;
-    for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
-      SLogSet[i] = (*itr).new_ver_;
-      ++i;
-    }
-
-    double threshold = FLAGS_clocks_per_us * FLAGS_io_time_ns / 1000;
-    uint64_t spinstart = rdtscp();
-    while ((rdtscp() - spinstart) < threshold) {
-    }  // spin-wait
-
-    SwalLock.w_unlock();
-  } else {  // group commit
-    SwalLock.w_lock();
-    for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
-      SLogSet[GROUP_COMMIT_INDEX[0].obj_] = (*itr).new_ver_;
-      ++GROUP_COMMIT_INDEX[0].obj_;
-    }
-
-    if (GROUP_COMMIT_COUNTER[0].obj_ == 0) {
-      grpcmt_start_ = rdtscp();  // it can also initialize.
-    }
-
-    ++GROUP_COMMIT_COUNTER[0].obj_;
-
-    if (GROUP_COMMIT_COUNTER[0].obj_ == FLAGS_group_commit) {
-      double threshold = FLAGS_clocks_per_us * FLAGS_io_time_ns / 1000;
-      uint64_t spinstart = rdtscp();
-      while ((rdtscp() - spinstart) < threshold) {
-      }  // spin-wait
+  SwalLock.w_lock();
+  if (SLogSet.tx_num_ == 0) storeRelease(SLogSet.start_, rdtscp());
+  for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
+    SLogSet.add(this->wts_.ts_, (*itr).key_, write_val_, (*itr).new_ver_);
+  }
+  storeRelease(SLogSet.tx_num_, SLogSet.tx_num_ + 1);
+  bool full = SLogSet.tx_num_ >= FLAGS_group_commit;
+  SwalLock.w_unlock();
 
-      // group commit pending version.
-      gcpv();
-    }
-    SwalLock.w_unlock();
+  if (full) gcpv();
+  if (!FLAGS_group_commit) {
+    for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr)
+      waitPending((*itr).new_ver_);
   }
 }
 
+/**
+ * @brief parallel write-ahead logging.
+ * @detail It appends the write set to the group of this worker, and flushes
+ * the group when it has group_commit transactions, or every time without
+ * group commit.
+ * @return void
+ */
 void TxExecutor::pwal() {
-  if (!FLAGS_group_commit) {
-    int i = 0;
-    for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
-      PLogSet[thid_][i] = (*itr).new_ver_;
-      ++i;
-    }
-
-    // it gives lat ency instead of flush.
-    double threshold = FLAGS_clocks_per_us * FLAGS_io_time_ns / 1000;
-    uint64_t spinstart = rdtscp();
-    while ((rdtscp() - spinstart) < threshold) {
-    }  // spin-wait
-  } else {
-    for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
-      PLogSet[thid_][GROUP_COMMIT_INDEX[thid_].obj_] = (*itr).new_ver_;
-      ++GROUP_COMMIT_INDEX[this->thid_].obj_;
-    }
-
-    if (GROUP_COMMIT_COUNTER[this->thid_].obj_ == 0) {
-      grpcmt_start_ = rdtscp();  // it can also initialize.
-      ThreadRtsArrayForGroup[this->thid_].obj_ = this->rts_;
-    }
-
-    ++GROUP_COMMIT_COUNTER[this->thid_].obj_;
-
-    if (GROUP_COMMIT_COUNTER[this->thid_].obj_ == FLAGS_group_commit) {
-      // it gives latency instead of flush.
-      double threshold = FLAGS_clocks_per_us * FLAGS_io_time_ns / 1000;
-      uint64_t spinstart = rdtscp();
-      while ((rdtscp() - spinstart) < threshold) {
-      }  // spin-wait
-
-      gcpv();
-    }
+  LogBuffer &buf = PLogSet[thid_];
+  if (buf.tx_num_ == 0) storeRelease(buf.start_, rdtscp());
+  for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
+    buf.add(this->wts_.ts_, (*itr).key_, write_val_, (*itr).new_ver_);
   }
+  storeRelease(buf.tx_num_, buf.tx_num_ + 1);
+
+  if (buf.tx_num_ >= FLAGS_group_commit) gcpv();
 }
 
-inline void TxExecutor::cpv()  // commit pending versions
-{
+/**
+ * @brief write payloads into pending versions and schedule their garbage
+ * collection. They are still pending.
+ * @return void
+ */
+void TxExecutor::precpv() {
   for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
     /* memcpy は commit 確定前に書くことと，確定後に書くことができる．
      * 前提として，Cicada は OCC 性質を持つ．
@@ -518,29 +543,51 @@ inline void TxExecutor::cpv()  // commit pending versions
 #if SINGLE_EXEC
     (*itr).new_ver_->set(0, this->wts_.ts_);
 #endif
-    (*itr).new_ver_->status_.store(VersionStatus::committed,
-                                   std::memory_order_release);
     gcq_.emplace_back(GCElement((*itr).key_, (*itr).rcdptr_, (*itr).new_ver_,
                                 this->wts_.ts_));
     ++(*itr).rcdptr_->continuing_commit_;
   }
 }
 
+inline void TxExecutor::cpv()  // commit pending versions
+{
+  for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
+    (*itr).new_ver_->status_.store(VersionStatus::committed,
+                                   std::memory_order_release);
+  }
+}
+
+/**
+ * @brief flush the log group, then commit its pending versions.
+ * @detail s-wal takes the shared group under SwalLock and writes it under
+ * SwalFlushLock, so other workers can append to the next group meanwhile.
+ * @return void
+ */
 void TxExecutor::gcpv() {
+  std::size_t bytes = 0;
   if (FLAGS_s_wal) {
-    for (unsigned int i = 0; i < GROUP_COMMIT_INDEX[0].obj_; ++i) {
-      SLogSet[i]->status_.store(VersionStatus::committed, memory_order_release);
-    }
-    GROUP_COMMIT_COUNTER[0].obj_ = 0;
-    GROUP_COMMIT_INDEX[0].obj_ = 0;
+    SwalLock.w_lock();
+    swal_group_.take(SLogSet);
+    storeRelease(SLogSet.tx_num_, 0);
+    SwalLock.w_unlock();
+
+    SwalFlushLock.w_lock();
+    bytes = swal_group_.write(SLogSet.logseg_, FLAGS_log_recycle);
+    SwalFlushLock.w_unlock();
+    swal_group_.commitPending();
+    swal_group_.clear();
   } else if (FLAGS_p_wal) {
-    for (unsigned int i = 0; i < GROUP_COMMIT_INDEX[thid_].obj_; ++i) {
-      PLogSet[thid_][i]->status_.store(VersionStatus::committed,
-                                       memory_order_release);
-    }
-    GROUP_COMMIT_COUNTER[thid_].obj_ = 0;
-    GROUP_COMMIT_INDEX[thid_].obj_ = 0;
+    LogBuffer &buf = PLogSet[thid_];
+    bytes = buf.write(buf.logseg_, FLAGS_log_recycle);
+    buf.commitPending();
+    buf.clear();
+    storeRelease(buf.tx_num_, 0);
   }
+#if ADD_ANALYSIS
+  cres_->local_log_bytes_ += bytes;
+#else
+  (void)bytes;
+#endif
 }
 
 void TxExecutor::earlyAbort() {
@@ -589,26 +636,20 @@ void TxExecutor::displayWriteSet() {
   cout << endl;
 }
 
+/**
+ * @brief flush the group which has transactions of this worker if it waits
+ * longer than group_commit_timeout_us.
+ * @return true if it flushed the group.
+ */
 bool TxExecutor::chkGcpvTimeout() {
-  if (FLAGS_p_wal) {
-    grpcmt_stop_ = rdtscp();
-    if (chkClkSpan(grpcmt_start_, grpcmt_stop_,
-                   FLAGS_group_commit_timeout_us * FLAGS_clocks_per_us)) {
-      gcpv();
-      return true;
-    }
-  } else if (FLAGS_s_wal) {
-    grpcmt_stop_ = rdtscp();
-    if (chkClkSpan(grpcmt_start_, grpcmt_stop_,
-                   FLAGS_group_commit_timeout_us * FLAGS_clocks_per_us)) {
-      SwalLock.w_lock();
-      gcpv();
-      SwalLock.w_unlock();
-      return true;
-    }
-  }
-
-  return false;
+  LogBuffer &buf = FLAGS_s_wal ? SLogSet : PLogSet[thid_];
+  if (loadAcquire(buf.tx_num_) == 0) return false;
+  if (!chkClkSpan(loadAcquire(buf.start_), rdtscp(),
+                  FLAGS_group_commit_timeout_us * FLAGS_clocks_per_us))
+    return false;
+
+  gcpv();
+  return true;
 }
 
 void TxExecutor::mainte() {
@@ -624,12 +665,15 @@ void TxExecutor::mainte() {
   start = rdtscp();
 #endif
   //-----
-  if (__atomic_load_n(&(GCExecuteFlag[thid_].obj_), __ATOMIC_ACQUIRE) == 1) {
+  uint64_t epoch = Reclaimer.epoch();
+  if (gc_epoch_ != epoch) {
 #if ADD_ANALYSIS
     ++cres_->local_gc_counts_;
+    bool chain_sampled = false;
 #endif
+    uint64_t min_rts = Reclaimer.watermark();
     while (!gcq_.empty()) {
-      if (gcq_.front().wts_ >= MinRts.load(memory_order_acquire)) break;
+      if (gcq_.front().wts_ >= min_rts) break;
 
       /*
        * (a) acquiring the garbage collection lock succeeds
@@ -655,23 +699,43 @@ void TxExecutor::mainte() {
       Version *delTarget =
           gcq_.front().ver_->next_.load(std::memory_order_acquire);
 
+#if ADD_ANALYSIS
+      // walking every list costs too much, so one is sampled.
+      if (!chain_sampled) {
+        countChainLength(tuple);
+        chain_sampled = true;
+      }
+#endif
       // the thread detaches the rest of the version list from v
       gcq_.front().ver_->next_.store(nullptr, std::memory_order_release);
       // updates record.min_wts
       tuple->min_wts_.store(gcq_.front().ver_->wts_, memory_order_release);
-      gcAfterThisVersion(tuple, delTarget);
+      // the rest is freed after the threads which may traverse it pass.
+      if (delTarget != nullptr)
+        limbo_.retire(GCElement<Tuple>(gcq_.front().key_, tuple, delTarget,
+                                       gcq_.front().wts_));
       // releases the lock
       tuple->returnGCRight();
       gcq_.pop_front();
     }
 
-    __atomic_store_n(&(GCExecuteFlag[thid_].obj_), 0, __ATOMIC_RELEASE);
+    limbo_.seal(Reclaimer);
+    limbo_.reclaim(Reclaimer, [this](GCElement<Tuple> &elem) {
+      gcAfterThisVersion(elem.rcdptr_, elem.ver_);
+    });
+    gc_epoch_ = epoch;
   }
 
   this->gcstop_ = rdtscp();
-  if (chkClkSpan(this->gcstart_, this->gcstop_, FLAGS_gc_inter_us * FLAGS_clocks_per_us) &&
-      (loadAcquire(GCFlag[thid_].obj_) == 0)) {
-    storeRelease(GCFlag[thid_].obj_, 1);
+  if (chkClkSpan(this->gcstart_, this->gcstop_,
+                 FLAGS_gc_inter_us * FLAGS_clocks_per_us) &&
+      !Reclaimer.announced(thid_)) {
+    // the next transaction reads at rts which is not older.
+    if (FLAGS_group_commit == 0)
+      Reclaimer.announce(thid_, loadAcquire(ThreadRtsArray[thid_].obj_));
+    else
+      Reclaimer.announce(thid_,
+                         loadAcquire(ThreadRtsArrayForGroup[thid_].obj_));
     this->gcstart_ = this->gcstop_;
   }
   //-----
@@ -684,17 +748,16 @@ void TxExecutor::writePhase() {
 #if ADD_ANALYSIS
   uint64_t start = rdtscp();
 #endif
-  if (FLAGS_group_commit) {
-    // check time out of commit pending versions
-    chkGcpvTimeout();
+  precpv();
+  // log write set & possibly group commit pending versions.
+  if (FLAGS_p_wal) {
+    pwal();
+  } else if (FLAGS_s_wal) {
+    swal();
   } else {
     cpv();
   }
 
-  /* log write set & possibly group commit pending version
-  if (FLAGS_p_wal) pwal();
-  if (FLAGS_s_wal) swal();*/
-
   this->wts_.set_clockBoost(0);
   read_set_.clear();
   write_set_.clear();
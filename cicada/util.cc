@@ -11,16 +11,21 @@
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <string>
+#include <vector>
 
+#include "../include/atomic_wrapper.hh"
 #include "../include/backoff.hh"
 #include "../include/cache_line_size.hh"
 #include "../include/config.hh"
 #include "../include/debug.hh"
+#include "../include/log_segment.hh"
 #include "../include/masstree_wrapper.hh"
 #include "../include/random.hh"
 #include "../include/util.hh"
 #include "../include/zipf.hh"
 #include "include/common.hh"
+#include "include/result.hh"
 #include "include/time_stamp.hh"
 #include "include/transaction.hh"
 #include "include/tuple.hh"
@@ -46,41 +51,62 @@ void chkArg() {
     exit(0);
   }
 
-  if (posix_memalign((void **)&ThreadRtsArrayForGroup, CACHE_LINE_SIZE,
-                     FLAGS_thread_num * sizeof(uint64_t_64byte)) != 0)
+  if (FLAGS_thread_num > TimeStamp::kMaxThreads) {
+    cout << "thread_num must be at most " << TimeStamp::kMaxThreads
+         << ". Timestamps have " << TimeStamp::kTidBits
+         << " bits for the thread id." << endl;
     ERR;
-  if (posix_memalign((void **)&ThreadWtsArray, CACHE_LINE_SIZE,
-                     FLAGS_thread_num * sizeof(uint64_t_64byte)) != 0)
+  }
+
+  if (FLAGS_p_wal && FLAGS_s_wal) {
+    cout << "p_wal and s_wal are exclusive." << endl;
     ERR;
-  if (posix_memalign((void **)&ThreadRtsArray, CACHE_LINE_SIZE,
-                     FLAGS_thread_num * sizeof(uint64_t_64byte)) != 0)
+  }
+
+  if (FLAGS_group_commit && !FLAGS_p_wal && !FLAGS_s_wal) {
+    cout << "group_commit needs p_wal or s_wal." << endl;
     ERR;
-  if (posix_memalign((void **)&GROUP_COMMIT_INDEX, CACHE_LINE_SIZE,
-                     FLAGS_thread_num * sizeof(uint64_t_64byte)) != 0)
+  }
+
+  // thread 0 is the leader, so it doesn't scan.
+  if (FLAGS_scan_thread_num >= FLAGS_thread_num) {
+    cout << "scan_thread_num must be less than thread_num." << endl;
     ERR;
-  if (posix_memalign((void **)&GROUP_COMMIT_COUNTER, CACHE_LINE_SIZE,
+  }
+
+  if (FLAGS_scan_size > FLAGS_tuple_num) {
+    cout << "scan_size must be at most tuple_num." << endl;
+    ERR;
+  }
+
+  if (posix_memalign((void **)&ThreadRtsArrayForGroup, CACHE_LINE_SIZE,
                      FLAGS_thread_num * sizeof(uint64_t_64byte)) != 0)
     ERR;
-  if (posix_memalign((void **)&GCFlag, CACHE_LINE_SIZE,
+  if (posix_memalign((void **)&ThreadWtsArray, CACHE_LINE_SIZE,
                      FLAGS_thread_num * sizeof(uint64_t_64byte)) != 0)
     ERR;
-  if (posix_memalign((void **)&GCExecuteFlag, CACHE_LINE_SIZE,
+  if (posix_memalign((void **)&ThreadRtsArray, CACHE_LINE_SIZE,
                      FLAGS_thread_num * sizeof(uint64_t_64byte)) != 0)
     ERR;
+  Reclaimer.init(FLAGS_thread_num);
+  HtapCounters = new HtapCounter[FLAGS_thread_num];
 
-  SLogSet = new Version *[(FLAGS_max_ope) * (FLAGS_group_commit)];
-  PLogSet = new Version **[FLAGS_thread_num];
-
-  for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
-    PLogSet[i] = new Version *[(FLAGS_max_ope) * (FLAGS_group_commit)];
+  if (FLAGS_p_wal || FLAGS_s_wal) {
+    std::vector<std::string> log_dirs;
+    splitLogDirs(FLAGS_log_dirs, log_dirs);
+    if (FLAGS_s_wal) {
+      SLogSet.logseg_.init(log_dirs, 0, FLAGS_log_segment_size,
+                           FLAGS_log_segment_num);
+    } else {
+      PLogSet = new LogBuffer[FLAGS_thread_num];
+      for (unsigned int i = 0; i < FLAGS_thread_num; ++i)
+        PLogSet[i].logseg_.init(log_dirs, i, FLAGS_log_segment_size,
+                                FLAGS_log_segment_num);
+    }
   }
 
   // init
   for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
-    GCFlag[i].obj_ = 0;
-    GCExecuteFlag[i].obj_ = 0;
-    GROUP_COMMIT_INDEX[i].obj_ = 0;
-    GROUP_COMMIT_COUNTER[i].obj_ = 0;
     ThreadRtsArray[i].obj_ = 0;
     ThreadWtsArray[i].obj_ = 0;
     ThreadRtsArrayForGroup[i].obj_ = 0;
@@ -134,7 +160,19 @@ void displayDB() {
   }
 }
 
-void displayMinRts() { cout << "MinRts:  " << MinRts << endl << endl; }
+void displayHtap(HtapSampler &sampler) {
+  uint64_t scans = 0, scan_records = 0;
+  for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
+    scans += HtapCounters[i].scans_.load(std::memory_order_relaxed);
+    scan_records += HtapCounters[i].scan_records_.load(std::memory_order_relaxed);
+  }
+  sampler.display(FLAGS_clocks_per_us, FLAGS_extime, VAL_SIZE, scans,
+                  scan_records);
+}
+
+void displayMinRts() {
+  cout << "MinRts:  " << Reclaimer.watermark() << endl << endl;
+}
 
 void displayMinWts() { cout << "MinWts:  " << MinWts << endl << endl; }
 
@@ -144,33 +182,32 @@ void displayParameter() {
   cout << "#FLAGS_gc_inter_us:\t\t\t" << FLAGS_gc_inter_us << endl;
   cout << "#FLAGS_group_commit:\t\t\t" << FLAGS_group_commit << endl;
   cout << "#FLAGS_group_commit_timeout_us:\t\t" << FLAGS_group_commit_timeout_us << endl;
-  cout << "#FLAGS_io_time_ns:\t\t\t" << FLAGS_io_time_ns << endl;
+  cout << "#FLAGS_log_dirs:\t\t\t" << FLAGS_log_dirs << endl;
+  cout << "#FLAGS_log_recycle:\t\t\t" << FLAGS_log_recycle << endl;
+  cout << "#FLAGS_log_segment_num:\t\t\t" << FLAGS_log_segment_num << endl;
+  cout << "#FLAGS_log_segment_size:\t\t" << FLAGS_log_segment_size << endl;
+  cout << "#FLAGS_maintenance_tick_us:\t\t" << FLAGS_maintenance_tick_us << endl;
   cout << "#FLAGS_max_ope:\t\t\t\t" << FLAGS_max_ope << endl;
   cout << "#FLAGS_pre_reserve_version:\t\t" << FLAGS_pre_reserve_version << endl;
   cout << "#FLAGS_p_wal:\t\t\t\t" << FLAGS_p_wal << endl;
   cout << "#FLAGS_rmw:\t\t\t\t" << FLAGS_rmw << endl;
   cout << "#FLAGS_rratio:\t\t\t\t" << FLAGS_rratio << endl;
   cout << "#FLAGS_s_wal:\t\t\t\t" << FLAGS_s_wal << endl;
+  cout << "#FLAGS_scan_size:\t\t\t" << FLAGS_scan_size << endl;
+  cout << "#FLAGS_scan_thread_num:\t\t\t" << FLAGS_scan_thread_num << endl;
   cout << "#FLAGS_thread_num:\t\t\t" << FLAGS_thread_num << endl;
+  cout << "#FLAGS_version_numa_local:\t\t" << FLAGS_version_numa_local << endl;
   cout << "#FLAGS_ycsb:\t\t\t\t" << FLAGS_ycsb << endl;
   cout << "#FLAGS_worker1_insert_delay_rphase_us:\t" << FLAGS_worker1_insert_delay_rphase_us << endl;
   cout << "#FLAGS_zipf_skew:\t\t\t" << FLAGS_zipf_skew << endl;
  }
 
 void displaySLogSet() {
-  if (!FLAGS_group_commit) {
-  } else {
-    if (FLAGS_s_wal) {
-      SwalLock.w_lock();
-      for (unsigned int i = 0; i < GROUP_COMMIT_INDEX[0].obj_; ++i) {
-        // printf("SLogSet[%d]->key, val = (%d, %d)\n", i, SLogSet[i]->key,
-        // SLogSet[i]->val);
-      }
-      SwalLock.w_unlock();
-
-      // if (i == 0) printf("SLogSet is empty\n");
-    }
-  }
+  if (!FLAGS_s_wal) return;
+  SwalLock.w_lock();
+  cout << "SLogSet: " << SLogSet.tx_num_ << " transactions, "
+       << SLogSet.records_.size() << " records" << endl;
+  SwalLock.w_unlock();
 }
 
 void displayThreadWtsArray() {
@@ -206,8 +243,13 @@ void partTableInit([[maybe_unused]] size_t thid, uint64_t initts,
     tuple->latest_ = &tuple->inline_ver_;
     tuple->inline_ver_.set(0, initts, nullptr, VersionStatus::committed);
     tuple->inline_ver_.val_[0] = '\0';
+#else
+#if REUSE_VERSION
+    tuple->latest_.store(VersionAllocators[FLAGS_thread_num + thid].allocate(),
+                         std::memory_order_release);
 #else
     tuple->latest_.store(new Version(), std::memory_order_release);
+#endif
     (tuple->latest_.load(std::memory_order_acquire))
         ->set(0, initts, nullptr, VersionStatus::committed);
     (tuple->latest_.load(std::memory_order_acquire))->val_[0] = '\0';
@@ -240,24 +282,24 @@ void partTableDelete([[maybe_unused]] size_t thid, uint64_t start,
 }
 
 void deleteDB() {
+#if REUSE_VERSION
+  // versions are released with their slabs.
+  delete[] VersionAllocators;
+#else
   size_t maxthread = decideParallelBuildNumber(FLAGS_tuple_num);
   std::vector<std::thread> thv;
   for (size_t i = 0; i < maxthread; ++i)
     thv.emplace_back(partTableDelete, i, i * (FLAGS_tuple_num / maxthread),
                      (i + 1) * (FLAGS_tuple_num / maxthread) - 1);
   for (auto &th : thv) th.join();
+#endif
 
   delete Table;
   delete ThreadRtsArrayForGroup;
   delete ThreadWtsArray;
   delete ThreadRtsArray;
-  delete GROUP_COMMIT_INDEX;
-  delete GROUP_COMMIT_COUNTER;
-  delete GCFlag;
-  delete GCExecuteFlag;
-  delete SLogSet;
-  for (uint i = 0; i < FLAGS_thread_num; ++i) delete PLogSet[i];
-  delete PLogSet;
+  delete[] PLogSet;
+  delete[] HtapCounters;
 }
 
 void makeDB(uint64_t *initial_wts) {
@@ -274,6 +316,13 @@ void makeDB(uint64_t *initial_wts) {
   *initial_wts = tstmp.ts_;
 
   size_t maxthread = decideParallelBuildNumber(FLAGS_tuple_num);
+#if REUSE_VERSION
+  // slabs of the workers, then the loaders.
+  VersionAllocators = new SlabAllocator<Version>[FLAGS_thread_num + maxthread];
+  for (size_t i = 0; i < FLAGS_thread_num + maxthread; ++i)
+    VersionAllocators[i].init(FLAGS_version_numa_local,
+                              i < FLAGS_thread_num);
+#endif
   std::vector<std::thread> thv;
   for (size_t i = 0; i < maxthread; ++i)
     thv.emplace_back(partTableInit, i, tstmp.ts_, i * (FLAGS_tuple_num / maxthread),
@@ -281,48 +330,40 @@ void makeDB(uint64_t *initial_wts) {
   for (auto &th : thv) th.join();
 }
 
-void leaderWork([[maybe_unused]] Backoff &backoff) {
-  bool gc_update = true;
+void htapSample(HtapSampler &sampler) {
+  uint64_t commits = 0, scan_records = 0, installs = 0, frees = 0;
   for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
-    // check all thread's flag raising
-    if (__atomic_load_n(&(GCFlag[i].obj_), __ATOMIC_ACQUIRE) == 0) {
-      gc_update = false;
-      break;
-    }
+    commits += loadAcquire(CicadaResult[i].local_commit_counts_);
+    scan_records += HtapCounters[i].scan_records_.load(std::memory_order_relaxed);
+    installs += HtapCounters[i].installs_.load(std::memory_order_relaxed);
+    frees += HtapCounters[i].frees_.load(std::memory_order_relaxed);
   }
-  if (gc_update) {
-    uint64_t minw =
-        __atomic_load_n(&(ThreadWtsArray[1].obj_), __ATOMIC_ACQUIRE);
-    uint64_t minr;
-    if (FLAGS_group_commit == 0) {
-      minr = __atomic_load_n(&(ThreadRtsArray[1].obj_), __ATOMIC_ACQUIRE);
-    } else {
-      minr =
-          __atomic_load_n(&(ThreadRtsArrayForGroup[1].obj_), __ATOMIC_ACQUIRE);
-    }
+  // each record has a version at first.
+  long double versions_per_record =
+      ((long double)FLAGS_tuple_num + installs - frees) / FLAGS_tuple_num;
+  // the clocks of the timestamps without thread ids.
+  uint64_t minw = MinWts.load(std::memory_order_acquire) >> TimeStamp::kTidBits;
+  uint64_t minr = Reclaimer.watermark() >> TimeStamp::kTidBits;
+  sampler.sample(FLAGS_clocks_per_us, VAL_SIZE, commits, scan_records,
+                 versions_per_record, minw > minr ? minw - minr : 0);
+}
 
-    for (unsigned int i = 1; i < FLAGS_thread_num; ++i) {
+void leaderWork([[maybe_unused]] Backoff &backoff) {
+  // MinRts advances with the epoch of Reclaimer.
+  if (Reclaimer.tryAdvance()) {
+    // Thread 0 is the leader unless the maintenance thread computes them.
+    const unsigned int first = MAINTENANCE_THREAD ? 0 : 1;
+    uint64_t minw =
+        __atomic_load_n(&(ThreadWtsArray[first].obj_), __ATOMIC_ACQUIRE);
+    for (unsigned int i = first; i < FLAGS_thread_num; ++i) {
       uint64_t tmp =
           __atomic_load_n(&(ThreadWtsArray[i].obj_), __ATOMIC_ACQUIRE);
       if (minw > tmp) minw = tmp;
-      if (FLAGS_group_commit == 0) {
-        tmp = __atomic_load_n(&(ThreadRtsArray[i].obj_), __ATOMIC_ACQUIRE);
-        if (minr > tmp) minr = tmp;
-      } else {
-        tmp = __atomic_load_n(&(ThreadRtsArrayForGroup[i].obj_),
-                              __ATOMIC_ACQUIRE);
-        if (minr > tmp) minr = tmp;
-      }
     }
 
     MinWts.store(minw, memory_order_release);
-    MinRts.store(minr, memory_order_release);
-
-    // downgrade gc flag
-    for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
-      __atomic_store_n(&(GCFlag[i].obj_), 0, __ATOMIC_RELEASE);
-      __atomic_store_n(&(GCExecuteFlag[i].obj_), 1, __ATOMIC_RELEASE);
-    }
+    WatermarkStat.record(rdtscp(), FLAGS_gc_inter_us * FLAGS_clocks_per_us);
+    if (FLAGS_p_wal || FLAGS_s_wal) LogSegmentManager::refillAll();
   }
 }
 
@@ -331,6 +372,7 @@ void ShowOptParameters() {
        << ": ADD_ANALYSIS " << ADD_ANALYSIS << ": BACK_OFF " << BACK_OFF
        << ": INLINE_VERSION_OPT " << INLINE_VERSION_OPT
        << ": INLINE_VERSION_PROMOTION " << INLINE_VERSION_PROMOTION
+       << ": MAINTENANCE_THREAD " << MAINTENANCE_THREAD
        << ": MASSTREE_USE " << MASSTREE_USE << ": PARTITION_TABLE "
        << PARTITION_TABLE << ": REUSE_VERSION " << REUSE_VERSION
        << ": SINGLE_EXEC " << SINGLE_EXEC << ": KEY_SIZE " << KEY_SIZE
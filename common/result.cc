@@ -82,6 +82,15 @@ void Result::displayBackoffLatencyRate(size_t clocks_per_us, size_t extime,
   }
 }
 
+void Result::displayCascadingAborts() {
+  if (total_cascading_aborts_)
+    cout << "cascading_aborts:\t" << total_cascading_aborts_ << endl;
+}
+
+void Result::displayDies() {
+  if (total_dies_) cout << "dies:\t" << total_dies_ << endl;
+}
+
 void Result::displayEarlyAbortRate() {
   if (total_early_aborts_) {
     cout << fixed << setprecision(4) << "early_abort_rate:\t"
@@ -90,10 +99,25 @@ void Result::displayEarlyAbortRate() {
   }
 }
 
+void Result::displayEarlyReleases() {
+  if (total_early_releases_)
+    cout << "early_releases:\t" << total_early_releases_ << endl;
+}
+
 void Result::displayExtraReads() {
   cout << "extra_reads:\t" << total_extra_reads_ << endl;
 }
 
+void Result::displayGCChainLength() {
+  if (total_gc_chains_) {
+    cout << "gc_chains:\t" << total_gc_chains_ << endl;
+    cout << fixed << setprecision(4) << "gc_chain_length_avg:\t"
+         << (long double)total_gc_chain_length_ / (long double)total_gc_chains_
+         << endl;
+    cout << "gc_chain_length_max:\t" << total_gc_chain_length_max_ << endl;
+  }
+}
+
 void Result::displayGCCounts() {
   if (total_gc_counts_) cout << "gc_counts:\t" << total_gc_counts_ << endl;
 }
@@ -121,6 +145,37 @@ void Result::displayGCVersionCounts() {
     cout << "gc_version_counts:\t" << total_gc_version_counts_ << endl;
 }
 
+void Result::displayLockWaitLatencyRate(size_t clocks_per_us, size_t extime,
+                                        size_t thread_num) {
+  if (total_lock_wait_latency_) {
+    long double rate;
+    rate =
+        (long double)total_lock_wait_latency_ /
+        ((long double)clocks_per_us * powl(10.0, 6.0) * (long double)extime) /
+        thread_num;
+    cout << fixed << setprecision(4) << "lock_wait_latency_rate:\t" << rate
+         << endl;
+  }
+}
+
+void Result::displayLogBytes() {
+  if (total_log_bytes_) {
+    cout << "log_bytes:\t" << total_log_bytes_ << endl;
+    cout << fixed << setprecision(4) << "log_bytes_per_commit:\t"
+         << (long double)total_log_bytes_ / (long double)total_commit_counts_
+         << endl;
+  }
+}
+
+void Result::displayLsnLatency() {
+  if (total_lsn_counts_) {
+    cout << "lsn_counts:\t" << total_lsn_counts_ << endl;
+    cout << fixed << setprecision(4) << "lsn_latency_avg[clocks]:\t"
+         << (long double)total_lsn_latency_ / (long double)total_lsn_counts_
+         << endl;
+  }
+}
+
 void Result::displayMakeProcedureLatencyRate(size_t clocks_per_us,
                                              size_t extime, size_t thread_num) {
   if (total_make_procedure_latency_) {
@@ -207,12 +262,43 @@ void Result::displayReadLatencyRate(size_t clocks_per_us, size_t extime,
   }
 }
 
+void Result::displayReclaimLag() {
+  if (total_gc_counts_) {
+    cout << fixed << setprecision(4) << "reclaim_lag_avg[epochs]:\t"
+         << (long double)total_reclaim_lag_ / (long double)total_gc_counts_
+         << endl;
+    cout << "reclaim_lag_max[epochs]:\t" << total_reclaim_lag_max_ << endl;
+  }
+}
+
+void Result::displayRepairCounts() {
+  if (total_repair_counts_) {
+    cout << "repair_counts:\t" << total_repair_counts_ << endl;
+    cout << "repair_commit_counts:\t" << total_repair_commit_counts_ << endl;
+  }
+}
+
+void Result::displayRonlyAbortRate() {
+  if (total_ronly_commit_counts_) {
+    cout << "ronly_commit_counts:\t" << total_ronly_commit_counts_ << endl;
+    cout << "ronly_abort_counts:\t" << total_ronly_abort_counts_ << endl;
+    long double rate;
+    rate = (long double)total_ronly_abort_counts_ /
+           ((long double)total_ronly_commit_counts_ +
+            (long double)total_ronly_abort_counts_);
+    cout << fixed << setprecision(4) << "ronly_abort_rate:\t" << rate << endl;
+  }
+}
+
 void Result::displayRtsupdRate() {
   if (total_rtsupd_chances_) {
     long double rate;
     rate = (double)total_rtsupd_ /
            ((double)total_rtsupd_ + (double)total_rtsupd_chances_);
     cout << fixed << setprecision(4) << "rtsupd_rate:\t" << rate << endl;
+    cout << "rtsupd_per_commit:\t"
+         << (long double)total_rtsupd_ / (long double)total_commit_counts_
+         << endl;
   }
 }
 
@@ -221,6 +307,11 @@ void Result::displayTemperatureResets() {
     cout << "temperature_resets:\t" << total_temperature_resets_ << endl;
 }
 
+void Result::displayTemperatureUpdates() {
+  if (total_temperature_updates_)
+    cout << "temperature_updates:\t" << total_temperature_updates_ << endl;
+}
+
 void Result::displayTimestampHistorySuccessCounts() {
   if (total_timestamp_history_success_counts_)
     cout << "timestamp_history_success_counts:\t"
@@ -288,11 +379,28 @@ void Result::displayVersionMalloc() {
   cout << "version_malloc:\t" << total_version_malloc_ << endl;
 }
 
+void Result::displayVersionRemoteFrees() {
+  if (total_version_remote_frees_)
+    cout << "version_remote_frees:\t" << total_version_remote_frees_ << endl;
+}
+
 void Result::displayVersionReuse() {
   if (total_version_reuse_)
     cout << "version_reuse:\t" << total_version_reuse_ << endl;
 }
 
+void Result::displayVersionSlabBytes() {
+  if (total_version_slab_bytes_)
+    cout << "version_slab_bytes:\t" << total_version_slab_bytes_ << endl;
+}
+
+void Result::displayWounds() {
+  if (total_wounds_ || total_wounded_aborts_) {
+    cout << "wounds:\t" << total_wounds_ << endl;
+    cout << "wounded_aborts:\t" << total_wounded_aborts_ << endl;
+  }
+}
+
 void Result::displayWriteLatencyRate(size_t clocks_per_us, size_t extime,
                                      size_t thread_num) {
   if (total_write_latency_) {
@@ -304,6 +412,16 @@ void Result::displayWriteLatencyRate(size_t clocks_per_us, size_t extime,
     cout << fixed << setprecision(4) << "write_latency_rate:\t" << rate << endl;
   }
 }
+
+void Result::displayWriteLockHold(size_t clocks_per_us) {
+  if (total_write_locks_) {
+    // average time from acquiring a write lock to releasing it.
+    cout << fixed << setprecision(4) << "write_lock_hold[us]:\t"
+         << (long double)total_write_lock_hold_ / total_write_locks_ /
+                clocks_per_us
+         << endl;
+  }
+}
 #endif
 void Result::addLocalAbortCounts(const uint64_t count) {
   total_abort_counts_ += count;
@@ -330,14 +448,36 @@ void Result::addLocalBackoffLatency(const uint64_t count) {
   total_backoff_latency_ += count;
 }
 
+void Result::addLocalCascadingAborts(const uint64_t count) {
+  total_cascading_aborts_ += count;
+}
+
+void Result::addLocalDies(const uint64_t count) { total_dies_ += count; }
+
 void Result::addLocalEarlyAborts(const uint64_t count) {
   total_early_aborts_ += count;
 }
 
+void Result::addLocalEarlyReleases(const uint64_t count) {
+  total_early_releases_ += count;
+}
+
 void Result::addLocalExtraReads(const uint64_t count) {
   total_extra_reads_ += count;
 }
 
+void Result::addLocalGCChainLength(const uint64_t count) {
+  total_gc_chain_length_ += count;
+}
+
+void Result::addLocalGCChainLengthMax(const uint64_t count) {
+  if (total_gc_chain_length_max_ < count) total_gc_chain_length_max_ = count;
+}
+
+void Result::addLocalGCChains(const uint64_t count) {
+  total_gc_chains_ += count;
+}
+
 void Result::addLocalGCCounts(const uint64_t count) {
   total_gc_counts_ += count;
 }
@@ -354,6 +494,22 @@ void Result::addLocalGCLatency(const uint64_t count) {
   total_gc_latency_ += count;
 }
 
+void Result::addLocalLockWaitLatency(const uint64_t count) {
+  total_lock_wait_latency_ += count;
+}
+
+void Result::addLocalLogBytes(const uint64_t count) {
+  total_log_bytes_ += count;
+}
+
+void Result::addLocalLsnCounts(const uint64_t count) {
+  total_lsn_counts_ += count;
+}
+
+void Result::addLocalLsnLatency(const uint64_t count) {
+  total_lsn_latency_ += count;
+}
+
 void Result::addLocalMakeProcedureLatency(const uint64_t count) {
   total_make_procedure_latency_ += count;
 }
@@ -368,6 +524,30 @@ void Result::addLocalReadLatency(const uint64_t count) {
   total_read_latency_ += count;
 }
 
+void Result::addLocalReclaimLag(const uint64_t count) {
+  total_reclaim_lag_ += count;
+}
+
+void Result::addLocalReclaimLagMax(const uint64_t count) {
+  if (total_reclaim_lag_max_ < count) total_reclaim_lag_max_ = count;
+}
+
+void Result::addLocalRepairCommitCounts(const uint64_t count) {
+  total_repair_commit_counts_ += count;
+}
+
+void Result::addLocalRepairCounts(const uint64_t count) {
+  total_repair_counts_ += count;
+}
+
+void Result::addLocalRonlyAbortCounts(const uint64_t count) {
+  total_ronly_abort_counts_ += count;
+}
+
+void Result::addLocalRonlyCommitCounts(const uint64_t count) {
+  total_ronly_commit_counts_ += count;
+}
+
 void Result::addLocalRtsupd(const uint64_t count) { total_rtsupd_ += count; }
 
 void Result::addLocalRtsupdChances(const uint64_t count) {
@@ -378,6 +558,10 @@ void Result::addLocalTemperatureResets(const uint64_t count) {
   total_temperature_resets_ += count;
 }
 
+void Result::addLocalTemperatureUpdates(const uint64_t count) {
+  total_temperature_updates_ += count;
+}
+
 void Result::addLocalTMTElementsMalloc(const uint64_t count) {
   total_TMT_element_malloc_ += count;
 }
@@ -414,13 +598,35 @@ void Result::addLocalVersionMalloc(const uint64_t count) {
   total_version_malloc_ += count;
 }
 
+void Result::addLocalVersionRemoteFrees(const uint64_t count) {
+  total_version_remote_frees_ += count;
+}
+
 void Result::addLocalVersionReuse(const uint64_t count) {
   total_version_reuse_ += count;
 }
 
+void Result::addLocalVersionSlabBytes(const uint64_t count) {
+  total_version_slab_bytes_ += count;
+}
+
+void Result::addLocalWoundedAborts(const uint64_t count) {
+  total_wounded_aborts_ += count;
+}
+
+void Result::addLocalWounds(const uint64_t count) { total_wounds_ += count; }
+
 void Result::addLocalWriteLatency(const uint64_t count) {
   total_write_latency_ += count;
 }
+
+void Result::addLocalWriteLockHold(const uint64_t count) {
+  total_write_lock_hold_ += count;
+}
+
+void Result::addLocalWriteLocks(const uint64_t count) {
+  total_write_locks_ += count;
+}
 #endif
 
 void Result::displayAllResult([[maybe_unused]] size_t clocks_per_us,
@@ -431,31 +637,46 @@ void Result::displayAllResult([[maybe_unused]] size_t clocks_per_us,
   displayAbortByValidationRate();
   displayCommitLatencyRate(clocks_per_us, extime, thread_num);
   displayBackoffLatencyRate(clocks_per_us, extime, thread_num);
+  displayCascadingAborts();
+  displayDies();
   displayEarlyAbortRate();
+  displayEarlyReleases();
   displayExtraReads();
+  displayGCChainLength();
   displayGCCounts();
   displayGCLatencyRate(clocks_per_us, extime, thread_num);
   displayGCTMTElementsCounts();
   displayGCVersionCounts();
+  displayLockWaitLatencyRate(clocks_per_us, extime, thread_num);
+  displayLogBytes();
+  displayLsnLatency();
   displayMakeProcedureLatencyRate(clocks_per_us, extime, thread_num);
   displayMemcpys();
   displayOtherWorkLatencyRate(clocks_per_us, extime, thread_num);
   displayPreemptiveAbortsCounts();
   displayRatioOfPreemptiveAbortToTotalAbort();
   displayReadLatencyRate(clocks_per_us, extime, thread_num);
+  displayReclaimLag();
+  displayRepairCounts();
+  displayRonlyAbortRate();
   displayRtsupdRate();
   displayTemperatureResets();
+  displayTemperatureUpdates();
   displayTimestampHistorySuccessCounts();
   displayTimestampHistoryFailCounts();
   displayTMTElementMalloc();
   displayTMTElementReuse();
   displayTreeTraversal();
+  displayWounds();
+  displayWriteLockHold(clocks_per_us);
   displayWriteLatencyRate(clocks_per_us, extime, thread_num);
   displayValiLatencyRate(clocks_per_us, extime, thread_num);
   displayValidationFailureByTidRate();
   displayValidationFailureByWritelockRate();
   displayVersionMalloc();
+  displayVersionRemoteFrees();
   displayVersionReuse();
+  displayVersionSlabBytes();
 #endif
   displayAbortCounts();
   displayCommitCounts();
@@ -472,16 +693,32 @@ void Result::addLocalAllResult(const Result &other) {
   addLocalAbortByValidation(other.local_abort_by_validation_);
   addLocalBackoffLatency(other.local_backoff_latency_);
   addLocalCommitLatency(other.local_commit_latency_);
+  addLocalCascadingAborts(other.local_cascading_aborts_);
+  addLocalDies(other.local_dies_);
   addLocalEarlyAborts(other.local_early_aborts_);
+  addLocalEarlyReleases(other.local_early_releases_);
   addLocalExtraReads(other.local_extra_reads_);
+  addLocalGCChainLength(other.local_gc_chain_length_);
+  addLocalGCChainLengthMax(other.local_gc_chain_length_max_);
+  addLocalGCChains(other.local_gc_chains_);
   addLocalGCCounts(other.local_gc_counts_);
   addLocalGCLatency(other.local_gc_latency_);
   addLocalGCVersionCounts(other.local_gc_version_counts_);
   addLocalGCTMTElementsCounts(other.local_gc_TMT_elements_counts_);
+  addLocalLockWaitLatency(other.local_lock_wait_latency_);
+  addLocalLogBytes(other.local_log_bytes_);
+  addLocalLsnCounts(other.local_lsn_counts_);
+  addLocalLsnLatency(other.local_lsn_latency_);
   addLocalMakeProcedureLatency(other.local_make_procedure_latency_);
   addLocalMemcpys(other.local_memcpys);
   addLocalPreemptiveAbortsCounts(other.local_preemptive_aborts_counts_);
   addLocalReadLatency(other.local_read_latency_);
+  addLocalReclaimLag(other.local_reclaim_lag_);
+  addLocalReclaimLagMax(other.local_reclaim_lag_max_);
+  addLocalRepairCommitCounts(other.local_repair_commit_counts_);
+  addLocalRepairCounts(other.local_repair_counts_);
+  addLocalRonlyAbortCounts(other.local_ronly_abort_counts_);
+  addLocalRonlyCommitCounts(other.local_ronly_commit_counts_);
   addLocalRtsupd(other.local_rtsupd_);
   addLocalRtsupdChances(other.local_rtsupd_chances_);
   addLocalTimestampHistorySuccessCounts(
@@ -489,15 +726,22 @@ void Result::addLocalAllResult(const Result &other) {
   addLocalTimestampHistoryFailCounts(
       other.local_timestamp_history_fail_counts_);
   addLocalTemperatureResets(other.local_temperature_resets_);
+  addLocalTemperatureUpdates(other.local_temperature_updates_);
   addLocalTreeTraversal(other.local_tree_traversal_);
   addLocalTMTElementsMalloc(other.local_TMT_element_malloc_);
   addLocalTMTElementsReuse(other.local_TMT_element_reuse_);
+  addLocalWoundedAborts(other.local_wounded_aborts_);
+  addLocalWounds(other.local_wounds_);
   addLocalWriteLatency(other.local_write_latency_);
+  addLocalWriteLockHold(other.local_write_lock_hold_);
+  addLocalWriteLocks(other.local_write_locks_);
   addLocalValiLatency(other.local_vali_latency_);
   addLocalValidationFailureByTid(other.local_validation_failure_by_tid_);
   addLocalValidationFailureByWritelock(
       other.local_validation_failure_by_writelock_);
   addLocalVersionMalloc(other.local_version_malloc_);
+  addLocalVersionRemoteFrees(other.local_version_remote_frees_);
   addLocalVersionReuse(other.local_version_reuse_);
+  addLocalVersionSlabBytes(other.local_version_slab_bytes_);
 #endif
 }
@@ -36,7 +36,6 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
   rnd.init();
   Result& myres = std::ref(ErmiaResult[thid]);
   FastZipf zipf(&rnd, FLAGS_zipf_skew, FLAGS_tuple_num);
-  GarbageCollection gcob;
   /**
    * Cicada's backoff opt.
    */
@@ -54,20 +53,45 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
 #endif  // Linux
   // printf("Thread #%d: on CPU %d\n", *myid, sched_getcpu());
 
-  if (thid == 0) gcob.decideFirstRange();
+  SlabAllocator<Version>& slab = VersionAllocators[thid];
+  slab.reserve(FLAGS_pre_reserve_version);
+
   storeRelease(ready, 1);
   while (!loadAcquire(start)) _mm_pause();
   trans.gcstart_ = rdtscp();
   while (!loadAcquire(quit)) {
     makeProcedure(trans.pro_set_, rnd, zipf, FLAGS_tuple_num, FLAGS_max_ope, FLAGS_thread_num,
                   FLAGS_rratio, FLAGS_rmw, FLAGS_ycsb, false, thid, myres);
+    [[maybe_unused]] bool ronly = (*trans.pro_set_.begin()).ronly_;
   RETRY:
     if (thid == 0) {
-      leaderWork(std::ref(gcob));
+#if !MAINTENANCE_THREAD
+      leaderWork();
+#endif
       leaderBackoffWork(backoff, ErmiaResult);
     }
     if (loadAcquire(quit)) break;
 
+#if SNAPSHOT_READ
+    /**
+     * A read only transaction reads the safe snapshot without SSN, so it
+     * never aborts and concurrent writers don't see it.
+     */
+    if (ronly) {
+      trans.beginSnapshot();
+      for (auto itr = trans.pro_set_.begin(); itr != trans.pro_set_.end();
+           ++itr)
+        trans.snapshotRead((*itr).key_);
+      storeRelease(myres.local_commit_counts_,
+                   loadAcquire(myres.local_commit_counts_) + 1);
+#if ADD_ANALYSIS
+      ++myres.local_ronly_commit_counts_;
+#endif
+      trans.mainte();
+      continue;
+    }
+#endif
+
     trans.tbegin();
     for (auto itr = trans.pro_set_.begin(); itr != trans.pro_set_.end();
          ++itr) {
@@ -89,6 +113,7 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
         trans.abort();
 #if ADD_ANALYSIS
         ++trans.eres_->local_early_aborts_;
+        if (ronly) ++myres.local_ronly_abort_counts_;
 #endif
         goto RETRY;
       }
@@ -102,8 +127,14 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
        */
       storeRelease(myres.local_commit_counts_,
                    loadAcquire(myres.local_commit_counts_) + 1);
+#if ADD_ANALYSIS
+      if (ronly) ++myres.local_ronly_commit_counts_;
+#endif
     } else if (trans.status_ == TransactionStatus::aborted) {
       trans.abort();
+#if ADD_ANALYSIS
+      if (ronly) ++myres.local_ronly_abort_counts_;
+#endif
       goto RETRY;
     }
 
@@ -113,6 +144,15 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
     trans.mainte();
   }
 
+#if ADD_ANALYSIS
+  myres.local_version_malloc_ += slab.fresh_;
+  myres.local_version_remote_frees_ += slab.remote_frees_;
+  myres.local_version_reuse_ += slab.reuses_;
+  myres.local_version_slab_bytes_ += slab.chunks_ * slab.kChunkSize;
+  myres.local_reclaim_lag_ += trans.gcobject_.limbo_version_.lag_sum_;
+  myres.local_reclaim_lag_max_ = trans.gcobject_.limbo_version_.lag_max_;
+#endif
+
   return;
 }
 
@@ -125,6 +165,9 @@ int main(int argc, char* argv[]) try {
   alignas(CACHE_LINE_SIZE) bool start = false;
   alignas(CACHE_LINE_SIZE) bool quit = false;
   initResult();
+  alignas(CACHE_LINE_SIZE) bool log_quit = false;
+  std::thread flusher;
+  if (FLAGS_log) flusher = std::thread(logFlusher, std::ref(log_quit));
   std::vector<char> readys(FLAGS_thread_num);
   std::vector<std::thread> thv;
   for (size_t i = 0; i < FLAGS_thread_num; ++i)
@@ -132,17 +175,38 @@ int main(int argc, char* argv[]) try {
                      std::ref(quit));
   waitForReady(readys);
   storeRelease(start, true);
+#if MAINTENANCE_THREAD
+  MaintenanceThread maintainer;
+  maintainer.start(FLAGS_maintenance_tick_us, FLAGS_clocks_per_us,
+                   []() { leaderWork(); });
+#endif
   for (size_t i = 0; i < FLAGS_extime; ++i) {
     sleepMs(1000);
   }
   storeRelease(quit, true);
   for (auto& th : thv) th.join();
+  if (FLAGS_log) {
+    storeRelease(log_quit, true);
+    flusher.join();
+  }
+#if MAINTENANCE_THREAD
+  maintainer.stop();
+#endif
 
   for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
     ErmiaResult[0].addLocalAllResult(ErmiaResult[i]);
   }
   ShowOptParameters();
   ErmiaResult[0].displayAllResult(FLAGS_clocks_per_us, FLAGS_extime, FLAGS_thread_num);
+  WatermarkStat.display("watermark", FLAGS_clocks_per_us);
+  Reclaimer.display();
+  if (FLAGS_log) Log.display();
+#if SNAPSHOT_READ
+  SafeSnap.display(MaxCstamp.load(std::memory_order_acquire));
+#endif
+#if MAINTENANCE_THREAD
+  maintainer.display();
+#endif
 
   return 0;
 } catch (bad_alloc) {
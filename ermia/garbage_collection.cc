@@ -12,46 +12,32 @@
 
 using std::cout, std::endl;
 
-// start, for leader thread.
-bool GarbageCollection::chkSecondRange() {
-  TransactionTable *tmt;
-
-  smin_ = UINT32_MAX;
-  smax_ = 0;
-  for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
-    tmt = __atomic_load_n(&TMT[i], __ATOMIC_ACQUIRE);
-    uint32_t tmptxid = tmt->txid_.load(std::memory_order_acquire);
-    smin_ = min(smin_, tmptxid);
-    smax_ = max(smax_, tmptxid);
-  }
-
-  // cout << "fmin_, fmax_ : " << fmin_ << ", " << fmax_ << endl;
-  // cout << "smin_, smax_ : " << smin_ << ", " << smax_ << endl;
-
-  if (fmax_ < smin_)
-    return true;
-  else
-    return false;
-}
-
-void GarbageCollection::decideFirstRange() {
-  TransactionTable *tmt;
-
-  fmin_ = fmax_ = 0;
-  for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
-    tmt = __atomic_load_n(&TMT[i], __ATOMIC_ACQUIRE);
-    uint32_t tmptxid = tmt->txid_.load(std::memory_order_acquire);
-    fmin_ = min(fmin_, tmptxid);
-    fmax_ = max(fmax_, tmptxid);
+/**
+ * @brief free a version which no thread refers to.
+ * @detail The inline version of the tuple goes back to the tuple.
+ * @return void
+ */
+void GarbageCollection::freeVersion([[maybe_unused]] Tuple *tuple,
+                                    Version *ver) {
+#if INLINE_VERSION_OPT
+  if (ver == &tuple->inline_ver_) {
+    tuple->returnInlineVersionRight();
+    return;
   }
-
-  return;
+#endif
+  VersionAllocators[thid_].free(ver);
 }
-// end, for leader thread.
 
 // for worker thread
 void GarbageCollection::gcVersion([[maybe_unused]] Result *eres_) {
-  uint32_t threshold = getGcThreshold();
+  uint64_t threshold = Reclaimer.watermark();
+#if SNAPSHOT_READ
+  // read only transactions read at the safe snapshot, which may be older.
+  threshold = std::min(threshold, SafeSnap.gcStamp());
+#endif
+#if ADD_ANALYSIS
+  bool chain_sampled = false;
+#endif
 
   // my customized Rapid garbage collection inspired from Cicada (sigmod 2017).
   while (!gcq_for_version_.empty()) {
@@ -86,46 +72,54 @@ void GarbageCollection::gcVersion([[maybe_unused]] Result *eres_) {
       continue;
     }
 
+#if ADD_ANALYSIS
+    // walking every list costs too much, so one is sampled.
+    if (!chain_sampled) {
+      countChainLength(tuple, eres_);
+      chain_sampled = true;
+    }
+#endif
     // the thread detaches the rest of the version list from v
     gcq_for_version_.front().ver_->prev_ = nullptr;
     // updates record.min_wts
     tuple->min_cstamp_.store(gcq_for_version_.front().ver_->cstamp_,
                              memory_order_release);
+    // the rest is freed after the threads which may traverse it pass.
+    limbo_version_.retire(GCElement<Tuple>(gcq_for_version_.front().key_,
+                                           tuple, delTarget,
+                                           gcq_for_version_.front().cstamp_));
 
+    // releases the lock
+    tuple->gc_lock_.store(0, std::memory_order_release);
+    gcq_for_version_.pop_front();
+  }
+
+  limbo_version_.seal(Reclaimer);
+  limbo_version_.reclaim(Reclaimer, [this, eres_](GCElement<Tuple> &elem) {
+    Version *delTarget = elem.ver_;
     while (delTarget != nullptr) {
       // next pointer escape
       Version *tmp = delTarget->prev_;
-      reuse_version_from_gc_.emplace_back(delTarget);
+      freeVersion(elem.rcdptr_, delTarget);
       delTarget = tmp;
 #if ADD_ANALYSIS
       ++eres_->local_gc_version_counts_;
 #endif
     }
-
-    // releases the lock
-    tuple->gc_lock_.store(0, std::memory_order_release);
-    gcq_for_version_.pop_front();
-  }
+  });
 
   return;
 }
 
-void GarbageCollection::gcTMTelement([[maybe_unused]] Result *eres_) {
-  uint32_t threshold = getGcThreshold();
-  if (gcq_for_TMT_.empty()) return;
-
-  for (;;) {
-    TransactionTable *tmt = gcq_for_TMT_.front();
-    if (tmt->txid_ < threshold) {
-      gcq_for_TMT_.pop_front();
-      reuse_TMT_element_from_gc_.emplace_back(tmt);
 #if ADD_ANALYSIS
-      ++eres_->local_gc_TMT_elements_counts_;
-#endif
-      if (gcq_for_TMT_.empty()) break;
-    } else
-      break;
-  }
-
-  return;
+void GarbageCollection::countChainLength(Tuple *tuple, Result *eres_) {
+  uint64_t len = 0;
+  for (Version *ver = tuple->latest_.load(std::memory_order_acquire);
+       ver != nullptr; ver = ver->prev_)
+    ++len;
+  ++eres_->local_gc_chains_;
+  eres_->local_gc_chain_length_ += len;
+  if (eres_->local_gc_chain_length_max_ < len)
+    eres_->local_gc_chain_length_max_ = len;
 }
+#endif
@@ -4,12 +4,17 @@
 #include <vector>
 
 #include "lock.hh"
+#include "log.hh"
+#include "safe_snapshot.hh"
 #include "transaction_table.hh"
 #include "tuple.hh"
 
 #include "../../include/cache_line_size.hh"
 #include "../../include/int64byte.hh"
+#include "../../include/maintenance.hh"
 #include "../../include/masstree_wrapper.hh"
+#include "../../include/reclaim.hh"
+#include "../../include/slab.hh"
 
 #include "gflags/gflags.h"
 #include "glog/logging.h"
@@ -17,12 +22,15 @@
 #ifdef GLOBAL_VALUE_DEFINE
 #define GLOBAL
 GLOBAL std::atomic<uint64_t> Lsn(0);
+// the latest cstamp of committed transactions, from which snapshots are taken.
+alignas(CACHE_LINE_SIZE) GLOBAL std::atomic<uint64_t> MaxCstamp(0);
 #if MASSTREE_USE
 alignas(CACHE_LINE_SIZE) GLOBAL MasstreeWrapper<Tuple> MT;
 #endif
 #else
 #define GLOBAL extern
 GLOBAL std::atomic<uint64_t> Lsn;
+alignas(CACHE_LINE_SIZE) GLOBAL std::atomic<uint64_t> MaxCstamp;
 #if MASSTREE_USE
 alignas(CACHE_LINE_SIZE) GLOBAL MasstreeWrapper<Tuple> MT;
 #endif
@@ -32,15 +40,32 @@ alignas(CACHE_LINE_SIZE) GLOBAL MasstreeWrapper<Tuple> MT;
 DEFINE_uint64(clocks_per_us, 2100, "CPU_MHz. Use this info for measuring time.");
 DEFINE_uint64(extime, 3, "Execution time[sec].");
 DEFINE_uint64(gc_inter_us, 10, "GC interval[us].");
+DEFINE_bool(log, false,
+            "Reserve log space for commit LSNs and write log records. False "
+            "takes commit LSNs from a counter and writes no log.");
+DEFINE_uint64(log_buffer_size, 16 << 20,
+              "Size of the circular log buffer[byte]. It is a power of two.");
+DEFINE_string(log_dirs, "",
+              "Comma-separated log directories. Log segments are "
+              "spread over them. Empty means ./log .");
+DEFINE_bool(log_recycle, false,
+            "Recycle log segments which the flusher has written. There is no "
+            "checkpoint, so the log loses committed frames.");
+DEFINE_uint64(log_segment_num, 4, "Number of log segments preallocated.");
+DEFINE_uint64(log_segment_size, 64 << 20, "Size of a log segment[byte].");
+DEFINE_uint64(maintenance_tick_us, 10,
+              "Tick of the maintenance thread[us]. It is used by "
+              "MAINTENANCE_THREAD.");
 DEFINE_uint64(max_ope, 10,
               "Total number of operations per single transaction.");
-DEFINE_uint64(pre_reserve_tmt_element, 100, "Pre-allocating memory for the transaction mapping table elements.");
 DEFINE_uint64(pre_reserve_version, 10000, "Pre-allocating memory for the version.");
 DEFINE_bool(rmw, false,
             "True means read modify write, false means blind write.");
 DEFINE_uint64(rratio, 50, "read ratio of single transaction.");
 DEFINE_uint64(thread_num, 10, "Total number of worker threads.");
 DEFINE_uint64(tuple_num, 1000000, "Total number of records.");
+DEFINE_bool(version_numa_local, false,
+            "Bind version slabs to the NUMA node of their worker.");
 DEFINE_bool(ycsb, true,
             "True uses zipf_skew, false uses faster random generator.");
 DEFINE_double(zipf_skew, 0, "zipf skew. 0 ~ 0.999...");
@@ -48,20 +73,36 @@ DEFINE_double(zipf_skew, 0, "zipf skew. 0 ~ 0.999...");
 DECLARE_uint64(clocks_per_us);
 DECLARE_uint64(extime);
 DECLARE_uint64(gc_inter_us);
+DECLARE_bool(log);
+DECLARE_uint64(log_buffer_size);
+DECLARE_string(log_dirs);
+DECLARE_bool(log_recycle);
+DECLARE_uint64(log_segment_num);
+DECLARE_uint64(log_segment_size);
+DECLARE_uint64(maintenance_tick_us);
 DECLARE_uint64(max_ope);
-DECLARE_uint64(pre_reserve_tmt_element);
 DECLARE_uint64(pre_reserve_version);
 DECLARE_bool(rmw);
 DECLARE_uint64(rratio);
 DECLARE_uint64(thread_num);
 DECLARE_uint64(tuple_num);
+DECLARE_bool(version_numa_local);
 DECLARE_bool(ycsb);
 DECLARE_double(zipf_skew);
 #endif
 
 
 alignas(CACHE_LINE_SIZE) GLOBAL Tuple *Table;
-alignas(CACHE_LINE_SIZE) GLOBAL
-    TransactionTable **TMT;  // Transaction Mapping Table
+// version slab of each worker [thID], then of each loader.
+alignas(CACHE_LINE_SIZE) GLOBAL SlabAllocator<Version> *VersionAllocators;
+// Transaction Mapping Table. [thID]
+alignas(CACHE_LINE_SIZE) GLOBAL TransactionTable *TMT;
+// reclamation of versions. Its watermark is the minimum txid.
+GLOBAL EpochReclaimer Reclaimer;
+GLOBAL MaintenanceStat WatermarkStat;  // GC threshold
+// log buffer shared by all workers, which -log uses.
+alignas(CACHE_LINE_SIZE) GLOBAL LogBuffer Log;
+// snapshot of read only transactions, which SNAPSHOT_READ uses.
+alignas(CACHE_LINE_SIZE) GLOBAL SafeSnapshot SafeSnap;
 
 GLOBAL std::mutex SsnLock;
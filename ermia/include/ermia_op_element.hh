@@ -27,9 +27,9 @@ class GCElement : public OpElement<T> {
   using OpElement<T>::OpElement;
 
   Version *ver_;
-  uint32_t cstamp_;
+  uint64_t cstamp_;
 
-  GCElement(uint64_t key, T *rcdptr, Version *ver, uint32_t cstamp)
+  GCElement(uint64_t key, T *rcdptr, Version *ver, uint64_t cstamp)
       : OpElement<T>::OpElement(key, rcdptr) {
     this->ver_ = ver;
     this->cstamp_ = cstamp;
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <xmmintrin.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../../include/atomic_wrapper.hh"
+#include "../../include/cache_line_size.hh"
+#include "../../include/debug.hh"
+#include "../../include/log_segment.hh"
+
+/**
+ * @brief Header of a log block, that is, the log records of a transaction.
+ * @detail size_ is stored last, so the flusher knows the block was filled
+ * when it is not zero. rec_num_ is 0 for a transaction which aborted after it
+ * reserved its block.
+ */
+class LogBlockHeader {
+ public:
+  uint64_t size_;  // [byte] including this header
+  uint64_t lsn_;   // commit LSN, which is the cstamp of the transaction
+  uint64_t rec_num_;
+};
+
+/**
+ * @brief After-image of a record written by a committed transaction.
+ */
+class LogRecord {
+ public:
+  uint64_t key_;
+  char val_[VAL_SIZE];
+};
+
+/**
+ * @brief Circular log buffer shared by all workers.
+ * @detail Log space is reserved by a single fetch_add on tail_, which is the
+ * offset in the whole log. The offset also serves as the LSN, so one atomic
+ * operation gives a transaction both its commit LSN (the end offset of its
+ * block) and where to write its block. Blocks are laid out in LSN order, so
+ * the LSNs are unique and increase in the order they were taken, as ++Lsn
+ * did. The position in the buffer is the offset modulo the capacity.
+ *
+ * A worker builds its block in its own memory and copies it into the
+ * reserved space once the flusher freed it. The flusher writes the filled
+ * prefix from flushed_ to the log segments, clears it and advances flushed_,
+ * which is the durable LSN.
+ */
+class LogBuffer {
+ public:
+  LogSegmentManager logseg_;
+
+  // statistics, updated by the flusher
+  uint64_t flushes_ = 0;
+  uint64_t flush_bytes_ = 0;
+
+  ~LogBuffer() { ::free(buf_); }
+
+  /**
+   * @param [in] capacity size of the buffer [byte]. It is a power of two.
+   * @param [in] max_frame the largest frame which logseg_ takes [byte].
+   * @param [in] recycle whether full segments are recycled.
+   * @return void
+   */
+  void init(std::size_t capacity, std::size_t max_frame, bool recycle) {
+    if (posix_memalign((void **)&buf_, CACHE_LINE_SIZE, capacity) != 0) ERR;
+    memset(buf_, 0, capacity);
+    capacity_ = capacity;
+    // a frame never laps the buffer, whose next lap isn't cleared yet.
+    max_frame_ = std::min(max_frame, capacity);
+    recycle_ = recycle;
+  }
+
+  /**
+   * @brief reserve log space for a block.
+   * @param [in] size size of the block [byte]. It is a multiple of 8.
+   * @return offset of the block. offset + size is its LSN.
+   */
+  uint64_t reserve(std::size_t size) {
+    return tail_.fetch_add(size, std::memory_order_acq_rel);
+  }
+
+  /**
+   * @brief copy a block into the space reserved at offset.
+   * @detail It waits until the flusher frees the space, which needs the
+   * earlier blocks to be filled. So the caller must not hold what the owners
+   * of earlier blocks wait for, such as the committing status in TMT.
+   * @param [in] block the block which begins with LogBlockHeader.
+   * @return void
+   */
+  void write(uint64_t offset, const char *block) {
+    std::size_t size = reinterpret_cast<const LogBlockHeader *>(block)->size_;
+    while (offset + size >
+           flushed_.load(std::memory_order_acquire) + capacity_)
+      _mm_pause();
+
+    copyIn(offset + sizeof(uint64_t), block + sizeof(uint64_t),
+           size - sizeof(uint64_t));
+    // size_ is 8-byte aligned, so it never wraps around.
+    storeRelease(*reinterpret_cast<uint64_t *>(buf_ + pos(offset)),
+                 static_cast<uint64_t>(size));
+  }
+
+  /**
+   * @brief write the filled blocks after the durable LSN to logseg_ and make
+   * them durable.
+   * @detail It is called only by the flusher.
+   * @return the number of bytes written.
+   */
+  std::size_t flush() {
+    uint64_t begin = flushed_.load(std::memory_order_relaxed);
+    uint64_t end = begin;
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    while (end < tail) {
+      uint64_t size =
+          loadAcquire(*reinterpret_cast<uint64_t *>(buf_ + pos(end)));
+      if (size == 0 || end + size - begin > max_frame_) break;
+      end += size;
+    }
+    if (end == begin) return 0;
+
+    struct iovec iov[2];
+    int iovcnt = split(begin, end - begin, iov);
+    // there is no checkpoint, so recycling drops committed frames.
+    if (recycle_) logseg_.setReclaimEpoch(end);
+    logseg_.write(iov, iovcnt, end);
+    logseg_.fdatasync();
+    for (int i = 0; i < iovcnt; ++i)
+      memset(iov[i].iov_base, 0, iov[i].iov_len);
+    flushed_.store(end, std::memory_order_release);
+
+    ++flushes_;
+    flush_bytes_ += end - begin;
+    return end - begin;
+  }
+
+  uint64_t durableLsn() { return flushed_.load(std::memory_order_acquire); }
+
+  void display() {
+    std::cout << "log_flushes:\t" << flushes_ << std::endl;
+    std::cout << "log_durable_lsn:\t" << durableLsn() << std::endl;
+    if (flushes_)
+      std::cout << std::fixed << std::setprecision(4)
+                << "log_flush_bytes_avg:\t"
+                << (long double)flush_bytes_ / (long double)flushes_
+                << std::endl;
+    std::cout << "log_segment_rotations:\t" << logseg_.rotations_ << std::endl;
+    std::cout << "log_segment_sync_allocations:\t" << logseg_.sync_allocations_
+              << std::endl;
+  }
+
+ private:
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail_{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> flushed_{0};
+  char *buf_ = nullptr;
+  std::size_t capacity_ = 0;
+  std::size_t max_frame_ = 0;
+  bool recycle_ = false;
+
+  std::size_t pos(uint64_t offset) { return offset & (capacity_ - 1); }
+
+  /**
+   * @brief pieces of the buffer which hold [offset, offset + len).
+   * @return the number of pieces.
+   */
+  int split(uint64_t offset, std::size_t len, struct iovec *iov) {
+    std::size_t first = std::min(len, capacity_ - pos(offset));
+    iov[0] = {buf_ + pos(offset), first};
+    if (first == len) return 1;
+    iov[1] = {buf_, len - first};
+    return 2;
+  }
+
+  void copyIn(uint64_t offset, const char *src, std::size_t len) {
+    struct iovec iov[2];
+    int iovcnt = split(offset, len, iov);
+    for (int i = 0; i < iovcnt; ++i) {
+      memcpy(iov[i].iov_base, src, iov[i].iov_len);
+      src += iov[i].iov_len;
+    }
+  }
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+
+#include "../../include/cache_line_size.hh"
+
+/**
+ * @brief Safe snapshot which read only transactions read without SSN, used by
+ * SNAPSHOT_READ.
+ * @detail A read only transaction R reading the versions whose cstamp is not
+ * greater than s is serializable if no transaction T committed with
+ * pi(T) <= s < c(T). Such a T read a version overwritten by a transaction
+ * which R sees, while R doesn't see T. Any other transaction, and any path of
+ * dependencies leaving R and coming back to it, doesn't cross s backward.
+ *
+ * The leader takes a candidate s from MaxCstamp, and then waits until no
+ * transaction which took a cstamp not greater than s is still committing, so
+ * a transaction which begins after that sees every version in s. A committed
+ * T which crosses the candidate marks it unsafe.
+ *
+ * Under parallel commit, a T with txid > s may cross s by reading a version
+ * whose overwriter U with c(U) <= s wasn't committed yet. Following pi(T)
+ * back through the overwriters, some committed T' crosses s and read a
+ * version before such a U finished, so T' began before the wait ended. Its
+ * txid is then at most MaxCstamp + 1 read after the wait, which is the
+ * threshold of the candidate. T' didn't check before the candidate was set,
+ * since then its cstamp, which exceeds s, would have been in MaxCstamp before
+ * the leader settled the candidate. Once the GC watermark exceeds the
+ * threshold, T' has checked, so the leader publishes s unless it was marked,
+ * and takes the next candidate.
+ *
+ * Read only transactions don't announce their snapshot to the reclaimer, so
+ * the GC threshold must not exceed it. A read only transaction runs within two
+ * epochs, and the snapshot it took was published at most one epoch before it
+ * began. So gcStamp() lags behind the published snapshot by two epochs.
+ */
+class SafeSnapshot {
+ public:
+  // statistics, updated by the leader
+  uint64_t publishes_ = 0;
+  uint64_t rejects_ = 0;  // candidates marked unsafe
+
+  uint64_t snapshot() { return snapshot_.load(std::memory_order_acquire); }
+
+  uint64_t gcStamp() { return gc_stamp_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief mark the candidate unsafe if a committed transaction crosses it.
+   * @pre the transaction already published its cstamp to MaxCstamp.
+   * @param [in] sstamp pi of the transaction.
+   * @param [in] cstamp c of the transaction.
+   * @return void
+   */
+  void check(uint64_t sstamp, uint64_t cstamp) {
+    if (sstamp >= cstamp) return;
+    // pairs with the fence in advance(). Either the leader reads the cstamp
+    // from MaxCstamp, or this reads the candidate.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t candidate = candidate_.load(std::memory_order_acquire);
+    if (sstamp <= candidate && candidate < cstamp)
+      unsafe_.store(true, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief publish the candidate if it is safe, and take the next one.
+   * @detail It is called by the leader after each advance of the epoch.
+   * @param [in] watermark the GC watermark, the minimum txid announced.
+   * @param [in] max_cstamp MaxCstamp.
+   * @param [in] wait_commits waits until no transaction which took a cstamp
+   * not greater than its argument is committing.
+   * @return void
+   */
+  template <typename WaitCommits>
+  void advance(uint64_t watermark, std::atomic<uint64_t> &max_cstamp,
+               WaitCommits wait_commits) {
+    gc_stamp_.store(prev_, std::memory_order_release);
+    prev_ = snapshot_.load(std::memory_order_relaxed);
+
+    uint64_t candidate = candidate_.load(std::memory_order_relaxed);
+    if (watermark <= threshold_) return;
+    if (unsafe_.load(std::memory_order_acquire)) {
+      ++rejects_;
+    } else {
+      snapshot_.store(candidate, std::memory_order_release);
+      ++publishes_;
+    }
+
+    unsafe_.store(false, std::memory_order_relaxed);
+    // retry until no commit published its cstamp before the candidate is set.
+    candidate = max_cstamp.load(std::memory_order_acquire);
+    for (;;) {
+      // release orders the reset of unsafe_ before marks of it.
+      candidate_.store(candidate, std::memory_order_release);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      uint64_t latest = max_cstamp.load(std::memory_order_relaxed);
+      if (latest == candidate) break;
+      candidate = latest;
+    }
+    wait_commits(candidate);
+    threshold_ = max_cstamp.load(std::memory_order_acquire) + 1;
+  }
+
+  void display(uint64_t max_cstamp) {
+    std::cout << "safe_snapshot_publishes:\t" << publishes_ << std::endl;
+    std::cout << "safe_snapshot_rejects:\t" << rejects_ << std::endl;
+    std::cout << "safe_snapshot_lag[cstamps]:\t" << max_cstamp - snapshot()
+              << std::endl;
+  }
+
+ private:
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> candidate_{0};
+  std::atomic<bool> unsafe_{false};
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> snapshot_{0};
+  std::atomic<uint64_t> gc_stamp_{0};
+  uint64_t prev_ = 0;  // snapshot at the previous advance
+  uint64_t threshold_ = 0;  // txid which the watermark must exceed to publish
+};
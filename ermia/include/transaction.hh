@@ -23,62 +23,91 @@ class TxExecutor {
  public:
   char return_val_[VAL_SIZE] = {};
   char write_val_[VAL_SIZE] = {};
-  uint8_t thid_;                  // thread ID
-  uint32_t cstamp_ = 0;           // Transaction end time, c(T)
-  uint32_t pstamp_ = 0;           // Predecessor high-water mark, η (T)
-  uint32_t sstamp_ = UINT32_MAX;  // Successor low-water mark, pi (T)
-  uint32_t pre_gc_threshold_ = 0;
-  uint32_t
+  uint16_t thid_;                 // thread ID
+  uint64_t cstamp_ = 0;           // Transaction end time, c(T)
+  uint64_t pstamp_ = 0;           // Predecessor high-water mark, η (T)
+  uint64_t sstamp_ = UINT64_MAX;  // Successor low-water mark, pi (T)
+  uint64_t
       txid_;  // TID and begin timestamp - the current log sequence number (LSN)
+  uint64_t snapshot_ = 0;      // safe snapshot of a read only transaction
   uint64_t gcstart_, gcstop_;  // counter for garbage collection
+  uint64_t gc_epoch_ = 0;      // epoch of Reclaimer at the last collection
+  uint64_t log_offset_ = 0;    // offset of the reserved log block
+  std::size_t log_size_ = 0;   // size of the reserved log block [byte]
 
   vector<SetElement<Tuple>> read_set_;
   vector<SetElement<Tuple>> write_set_;
   vector<Procedure> pro_set_;
+  vector<char> log_block_;  // log block built before it is copied to Log
 
   Result *eres_;
   TransactionStatus status_ =
       TransactionStatus::inFlight;  // Status: inFlight, committed, or aborted
   GarbageCollection gcobject_;
 
-  TxExecutor(uint8_t thid, Result *eres) : thid_(thid), eres_(eres) {
+  TxExecutor(uint16_t thid, Result *eres) : thid_(thid), eres_(eres) {
     gcobject_.set_thid_(thid);
     read_set_.reserve(FLAGS_max_ope);
     write_set_.reserve(FLAGS_max_ope);
     pro_set_.reserve(FLAGS_max_ope);
-
-    if (FLAGS_pre_reserve_tmt_element) {
-      for (size_t i = 0; i < FLAGS_pre_reserve_tmt_element; ++i)
-        gcobject_.reuse_TMT_element_from_gc_.emplace_back(
-            new TransactionTable());
-    }
-
-    if (FLAGS_pre_reserve_version) {
-      for (size_t i = 0; i < FLAGS_pre_reserve_version; ++i)
-        gcobject_.reuse_version_from_gc_.emplace_back(new Version());
-    }
+    if (FLAGS_log)
+      log_block_.resize(sizeof(LogBlockHeader) +
+                        sizeof(LogRecord) * FLAGS_max_ope);
 
     genStringRepeatedNumber(write_val_, VAL_SIZE, thid);
+    Reclaimer.enter(thid_, 0);
   }
 
+  ~TxExecutor() { Reclaimer.leave(thid_); }
+
   SetElement<Tuple> *searchReadSet(unsigned int key);
   SetElement<Tuple> *searchWriteSet(unsigned int key);
   void tbegin();
+  void beginSnapshot();
+  void snapshotRead(uint64_t key);
   void ssn_tread(uint64_t key);
   void ssn_twrite(uint64_t key);
   void ssn_commit();
   void ssn_parallel_commit();
   void abort();
   void mainte();
+  void takeCstamp();
+  void writeLog(bool committed);
   void verify_exclusion_or_abort();
   void dispWS();
   void dispRS();
 
+  Version *newVersionGeneration([[maybe_unused]] Tuple *tuple) {
+#if INLINE_VERSION_OPT
+    if (tuple->getInlineVersionRight()) {
+      tuple->inline_ver_.init();
+#if ADD_ANALYSIS
+      ++eres_->local_version_reuse_;
+#endif
+      return &tuple->inline_ver_;
+    }
+#endif  // if INLINE_VERSION_OPT
+    return VersionAllocators[thid_].allocate();
+  }
+
+  /**
+   * @brief make the commit visible to the snapshots of later transactions.
+   * @return void
+   */
+  void publishCstamp() {
+    uint64_t max_cstamp = MaxCstamp.load(memory_order_acquire);
+    while (max_cstamp < cstamp_ &&
+           !MaxCstamp.compare_exchange_weak(max_cstamp, cstamp_,
+                                            memory_order_acq_rel,
+                                            memory_order_acquire))
+      ;
+  }
+
   void upReadersBits(Version *ver) {
     uint64_t expected, desired;
     expected = ver->readers_.load(memory_order_acquire);
     for (;;) {
-      desired = expected | (1 << thid_);
+      desired = expected | (1ULL << (thid_ % READERS_BITS));
       if (ver->readers_.compare_exchange_weak(
               expected, desired, memory_order_acq_rel, memory_order_acquire))
         break;
@@ -86,10 +115,12 @@ class TxExecutor {
   }
 
   void downReadersBits(Version *ver) {
+    // the bit may be shared by other readers.
+    if (FLAGS_thread_num > READERS_BITS) return;
     uint64_t expected, desired;
     expected = ver->readers_.load(memory_order_acquire);
     for (;;) {
-      desired = expected & ~(1 << thid_);
+      desired = expected & ~(1ULL << thid_);
       if (ver->readers_.compare_exchange_weak(
               expected, desired, memory_order_acq_rel, memory_order_acquire))
         break;
@@ -1,35 +1,72 @@
 #pragma once
 
+#include <xmmintrin.h>
+
 #include <atomic>
 #include <cstdint>
 
+#include "../../include/cache_line_size.hh"
 #include "transaction_status.hh"
 
+/**
+ * @brief Slot of a worker in the transaction mapping table. It has the state
+ * of the current transaction of the worker.
+ * @detail The slot is reused in place by the next transaction of the worker.
+ * seq_ is a seqlock which is odd while begin() resets the slot, and it counts
+ * up by 2 per transaction. Another worker reads the state of the transaction
+ * it found between readBegin() and changed(). When changed() is true, the
+ * transaction finished and already wrote its stamps into the versions it
+ * accessed.
+ */
 class TransactionTable {
  public:
-  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> txid_;
-  std::atomic<uint32_t> cstamp_;
-  std::atomic<uint32_t> sstamp_;
-  std::atomic<uint32_t> lastcstamp_;
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> seq_;
+  std::atomic<uint64_t> txid_;
+  std::atomic<uint64_t> cstamp_;
+  std::atomic<uint64_t> sstamp_;
+  std::atomic<uint64_t> lastcstamp_;
   std::atomic<TransactionStatus> status_;
 
-  TransactionTable() {}
+  TransactionTable() {
+    seq_.store(0, std::memory_order_relaxed);
+    txid_.store(0, std::memory_order_relaxed);
+    cstamp_.store(0, std::memory_order_relaxed);
+    sstamp_.store(UINT64_MAX, std::memory_order_relaxed);
+    lastcstamp_.store(0, std::memory_order_relaxed);
+    status_.store(TransactionStatus::inFlight, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief reset the slot for the next transaction of the owner.
+   * @return void
+   */
+  void begin(uint64_t txid, uint64_t lastcstamp) {
+    uint64_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    txid_.store(txid, std::memory_order_relaxed);
+    cstamp_.store(0, std::memory_order_relaxed);
+    sstamp_.store(UINT64_MAX, std::memory_order_relaxed);
+    lastcstamp_.store(lastcstamp, std::memory_order_relaxed);
+    status_.store(TransactionStatus::inFlight, std::memory_order_relaxed);
+    seq_.store(seq + 2, std::memory_order_release);
+  }
 
-  TransactionTable(uint32_t txid, uint32_t cstamp, uint32_t sstamp,
-                   uint32_t lastcstamp, TransactionStatus status) {
-    this->txid_.store(txid, memory_order_relaxed);
-    this->cstamp_.store(cstamp, memory_order_relaxed);
-    this->sstamp_.store(sstamp, memory_order_relaxed);
-    this->lastcstamp_.store(lastcstamp, memory_order_relaxed);
-    this->status_.store(status, memory_order_relaxed);
+  /**
+   * @return sequence number of the current transaction of the slot.
+   */
+  uint64_t readBegin() {
+    uint64_t seq;
+    while ((seq = seq_.load(std::memory_order_acquire)) & 1) _mm_pause();
+    return seq;
   }
 
-  void set(uint32_t txid, uint32_t cstamp, uint32_t sstamp, uint32_t lastcstamp,
-           TransactionStatus status) {
-    this->txid_.store(txid, memory_order_relaxed);
-    this->cstamp_.store(cstamp, memory_order_relaxed);
-    this->sstamp_.store(sstamp, memory_order_relaxed);
-    this->lastcstamp_.store(lastcstamp, memory_order_relaxed);
-    this->status_.store(status, memory_order_relaxed);
+  /**
+   * @return whether the transaction of seq finished, so the state read
+   * after readBegin() may be of a later transaction.
+   */
+  bool changed(uint64_t seq) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return seq_.load(std::memory_order_relaxed) != seq;
   }
 };
@@ -8,12 +8,41 @@
 
 class Tuple {
  public:
-  alignas(CACHE_LINE_SIZE) std::atomic<Version *> latest_;
-  std::atomic<uint32_t> min_cstamp_;
+  /**
+   * inline_ver_ is the version which the tuple was loaded with. It is next to
+   * latest_, so a read of a record which wasn't updated since the load
+   * doesn't chase a pointer to a version allocated elsewhere. After garbage
+   * collection frees it, a writer of the tuple reuses it.
+   */
+  alignas(CACHE_LINE_SIZE)
+#if INLINE_VERSION_OPT
+      Version inline_ver_;
+#endif
+  std::atomic<Version *> latest_;
+  std::atomic<uint64_t> min_cstamp_;
   std::atomic<uint8_t> gc_lock_;
 
   Tuple() {
     latest_.store(nullptr);
     gc_lock_.store(0, std::memory_order_release);
   }
+
+#if INLINE_VERSION_OPT
+  bool getInlineVersionRight() {
+    VersionStatus expected, desired(VersionStatus::inFlight);
+    expected = this->inline_ver_.status_.load(std::memory_order_acquire);
+    for (;;) {
+      if (expected != VersionStatus::unused) return false;
+      if (this->inline_ver_.status_.compare_exchange_strong(
+              expected, desired, std::memory_order_acq_rel,
+              std::memory_order_acquire))
+        return true;
+    }
+  }
+
+  void returnInlineVersionRight() {
+    this->inline_ver_.status_.store(VersionStatus::unused,
+                                    std::memory_order_release);
+  }
+#endif
 };
@@ -8,11 +8,11 @@ extern void displayDB();
 
 extern void displayParameter();
 
-extern void leaderWork(GarbageCollection &gcob);
+extern void leaderWork();
 
-extern void makeDB();
+extern void logFlusher(const bool &quit);
 
-extern void naiveGarbageCollection(const bool &quit);
+extern void makeDB();
 
 extern void partTableInit([[maybe_unused]] size_t thid, uint64_t start,
                           uint64_t end);
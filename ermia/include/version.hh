@@ -5,84 +5,63 @@
 
 #include "../../include/cache_line_size.hh"
 
+/**
+ * An sstamp with TIDFLAG is (thread id << TIDFLAG) | TIDFLAG of the worker
+ * which is overwriting the version.
+ */
 #define TIDFLAG 1
+#define MAX_THREAD_NUM 65536  // thread ids are uint16_t.
+/**
+ * readers_ has a bit per worker. Beyond 64 workers, the workers whose thread
+ * ids are congruent modulo 64 share a bit. A shared bit is never cleared, so
+ * a writer may check workers which don't read the version, which is safe.
+ */
+#define READERS_BITS 64
 
 enum class VersionStatus : uint8_t {
   inFlight,
   committed,
   aborted,
+  unused,  // the inline version of a tuple which no version list links
 };
 
+/**
+ * @brief pstamp and sstamp of a version.
+ * @detail Each is a 64-bit atomic, so they don't wrap around in long runs.
+ * They are updated independently of each other, so they need no double-width
+ * CAS, and they share a cache line.
+ */
 struct Psstamp {
-  union {
-    uint64_t obj_;
-    struct {
-      uint32_t pstamp_;
-      uint32_t sstamp_;
-    };
-  };
-
-  Psstamp() { obj_ = 0; }
-
-  void init(uint32_t pstamp, uint32_t sstamp) {
-    pstamp_ = pstamp;
-    sstamp_ = sstamp;
-  }
+  std::atomic<uint64_t> pstamp_;
+  std::atomic<uint64_t> sstamp_;
+
+  Psstamp() : pstamp_(0), sstamp_(0) {}
 
-  uint64_t atomicLoad() {
-    Psstamp expected;
-    expected.obj_ = __atomic_load_n(&obj_, __ATOMIC_ACQUIRE);
-    return expected.obj_;
+  void init(uint64_t pstamp, uint64_t sstamp) {
+    pstamp_.store(pstamp, std::memory_order_relaxed);
+    sstamp_.store(sstamp, std::memory_order_relaxed);
   }
 
-  bool atomicCASPstamp(uint32_t expectedPstamp, uint32_t desiredPstamp) {
-    Psstamp expected, desired;
-    expected.obj_ = __atomic_load_n(&obj_, __ATOMIC_ACQUIRE);
-    expected.pstamp_ = expectedPstamp;
-    desired = expected;
-    desired.pstamp_ = desiredPstamp;
-    if (__atomic_compare_exchange_n(&obj_, &expected.obj_, desired.obj_, false,
-                                    __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
-      return true;
-    else
-      return false;
+  bool atomicCASPstamp(uint64_t expectedPstamp, uint64_t desiredPstamp) {
+    return pstamp_.compare_exchange_strong(expectedPstamp, desiredPstamp,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_relaxed);
   }
 
-  uint32_t atomicLoadPstamp() {
-    Psstamp expected;
-    expected.obj_ = __atomic_load_n(&obj_, __ATOMIC_ACQUIRE);
-    return expected.pstamp_;
+  uint64_t atomicLoadPstamp() {
+    return pstamp_.load(std::memory_order_acquire);
   }
 
-  uint32_t atomicLoadSstamp() {
-    Psstamp expected;
-    expected.obj_ = __atomic_load_n(&obj_, __ATOMIC_ACQUIRE);
-    return expected.sstamp_;
+  uint64_t atomicLoadSstamp() {
+    return sstamp_.load(std::memory_order_acquire);
   }
-  void atomicStorePstamp(uint32_t newpstamp) {
-    Psstamp expected, desired;
-    expected.obj_ = __atomic_load_n(&obj_, __ATOMIC_ACQUIRE);
-    for (;;) {
-      desired = expected;
-      desired.pstamp_ = newpstamp;
-      if (__atomic_compare_exchange_n(&obj_, &expected.obj_, desired.obj_,
-                                      false, __ATOMIC_ACQ_REL,
-                                      __ATOMIC_ACQUIRE))
-        break;
-    }
+
+  void atomicStorePstamp(uint64_t newpstamp) {
+    pstamp_.exchange(newpstamp, std::memory_order_acq_rel);
   }
 
-  void atomicStoreSstamp(uint32_t newsstamp) {
-    Psstamp expected, desired;
-    expected.obj_ = __atomic_load_n(&obj_, __ATOMIC_ACQUIRE);
-    for (;;) {
-      desired = expected;
-      desired.sstamp_ = newsstamp;
-      if (__atomic_compare_exchange_n(&obj_, &expected.obj_, desired.obj_,
-                                      false, __ATOMIC_ACQ_REL,
-                                      __ATOMIC_ACQUIRE))
-        break;
-    }
+  void atomicStoreSstamp(uint64_t newsstamp) {
+    sstamp_.exchange(newsstamp, std::memory_order_acq_rel);
   }
 };
 
@@ -92,7 +71,7 @@ class Version {
       psstamp_;  // Version access stamp, eta(V), Version successor stamp, pi(V)
   Version *prev_;                  // Pointer to overwritten version
   std::atomic<uint64_t> readers_;  // summarize all of V's readers.
-  std::atomic<uint32_t> cstamp_;   // Version creation stamp, c(V)
+  std::atomic<uint64_t> cstamp_;   // Version creation stamp, c(V)
   std::atomic<VersionStatus> status_;
 
   char val_[VAL_SIZE];
@@ -100,7 +79,7 @@ class Version {
   Version() { init(); }
 
   void init() {
-    psstamp_.init(0, UINT32_MAX & ~(TIDFLAG));
+    psstamp_.init(0, UINT64_MAX & ~(TIDFLAG));
     status_.store(VersionStatus::inFlight, std::memory_order_release);
     readers_.store(0, std::memory_order_release);
   }
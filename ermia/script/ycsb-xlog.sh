@@ -0,0 +1,39 @@
+#ycsb-xlog.sh(ermia)
+# Commit LSNs from ++Lsn (-log=0) against those from log space reservation
+# (-log=1), varying the number of threads. lsn_latency_avg is the cost of
+# taking a commit LSN, which grows with the contention on the counter.
+tuple=1000000
+maxope=10
+rratio=100
+skew=0
+cpu_mhz=2100
+gci=10
+extime=3
+
+host=`hostname`
+dbs11="dbs11"
+
+cd ../
+make clean; make -j
+cd script/
+
+result=result_ermia_ycsbC_tuple1m_ope10_xth_xlog.dat
+rm $result
+echo "#thread_num, log, throughput, lsn_latency_avg[clocks], log_bytes_per_commit" >> $result
+
+threads="1 4 8 12 16 20 24"
+if  test $host = $dbs11 ; then
+threads="1 28 56 84 112 140 168 196 224"
+fi
+
+for thread in $threads
+do
+  for log in 0 1
+  do
+    numactl --interleave=all ../ermia.exe -clocks_per_us=$cpu_mhz -extime=$extime -gc_inter_us=$gci -log=$log -max_ope=$maxope -rmw=0 -rratio=$rratio -thread_num=$thread -tuple_num=$tuple -ycsb=1 -zipf_skew=$skew > exp.txt
+    tmpTH=`grep throughput ./exp.txt | awk '{print $2}'`
+    tmpLL=`grep lsn_latency_avg ./exp.txt | awk '{print $2}'`
+    tmpLB=`grep log_bytes_per_commit ./exp.txt | awk '{print $2}'`
+    echo "$thread $log $tmpTH $tmpLL $tmpLB" >> $result
+  done
+done
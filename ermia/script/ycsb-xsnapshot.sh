@@ -0,0 +1,47 @@
+#ycsb-xsnapshot.sh(ermia)
+# YCSB with and without SNAPSHOT_READ, varying the read ratio.
+# ronly_tps is the throughput of read only transactions, and
+# writer_tps and writer_abort_rate are those of the others.
+tuple=1000000
+maxope=10
+skew=0.9
+cpu_mhz=2100
+gci=10
+extime=3
+
+host=`hostname`
+dbs11="dbs11"
+
+thread=24
+if  test $host = $dbs11 ; then
+thread=224
+fi
+
+result=result_ermia_ycsb_tuple1m_ope10_skew09_xrratio_xsnapshot.dat
+rm $result
+echo "#rratio, SNAPSHOT_READ, throughput, ronly_tps, writer_tps, writer_abort_rate" >> $result
+
+for snapshot in 0 1
+do
+  cd ../
+  make clean; make -j SNAPSHOT_READ=$snapshot
+  cd script/
+
+  for rratio in 50 80 90 95 99
+  do
+    numactl --interleave=all ../ermia.exe -clocks_per_us=$cpu_mhz -extime=$extime -gc_inter_us=$gci -max_ope=$maxope -rmw=0 -rratio=$rratio -thread_num=$thread -tuple_num=$tuple -ycsb=1 -zipf_skew=$skew > exp.txt
+    tmpTH=`grep throughput ./exp.txt | awk '{print $2}'`
+    tmpCC=`grep ^commit_counts_ ./exp.txt | awk '{print $2}'`
+    tmpAC=`grep ^abort_counts_ ./exp.txt | awk '{print $2}'`
+    tmpRC=`grep ^ronly_commit_counts ./exp.txt | awk '{print $2}'`
+    tmpRA=`grep ^ronly_abort_counts ./exp.txt | awk '{print $2}'`
+    if test -z "$tmpRC" ; then
+      tmpRC=0
+      tmpRA=0
+    fi
+    tmpRT=`echo "$tmpRC / $extime" | bc -l`
+    tmpWT=`echo "($tmpCC - $tmpRC) / $extime" | bc -l`
+    tmpWA=`echo "($tmpAC - $tmpRA) / ($tmpCC - $tmpRC + $tmpAC - $tmpRA)" | bc -l`
+    echo "$rratio $snapshot $tmpTH $tmpRT $tmpWT $tmpWA" >> $result
+  done
+done
@@ -56,66 +56,34 @@ inline SetElement<Tuple> *TxExecutor::searchWriteSet(unsigned int key) {
  * @return void
  */
 void TxExecutor::tbegin() {
-  TransactionTable *newElement, *tmt;
-
-  tmt = loadAcquire(TMT[thid_]);
-  uint32_t lastcstamp;
+  TransactionTable *tmt = &TMT[thid_];
+  uint64_t lastcstamp;
   if (this->status_ == TransactionStatus::aborted) {
 		/**
 		 * If this transaction is retry by abort,
 		 * its lastcstamp is last one.
 		 */
-    lastcstamp = this->txid_ = tmt->lastcstamp_.load(memory_order_acquire);
+    lastcstamp = tmt->lastcstamp_.load(memory_order_acquire);
 	} else {
 		/**
 		 * If this transaction is after committed transaction,
 		 * its lastcstamp is that's one.
 		 */
-    lastcstamp = this->txid_ = cstamp_;
+    lastcstamp = cstamp_;
 	}
 
-  if (gcobject_.reuse_TMT_element_from_gc_.empty()) {
-		/**
-		 * If no cache,
-		 */
-    newElement = new TransactionTable(0, 0, UINT32_MAX, lastcstamp,
-                                      TransactionStatus::inFlight);
-#if ADD_ANALYSIS
-    ++eres_->local_TMT_element_malloc_;
-#endif
-  } else {
-		/**
-		 * If it has cache, this transaction use it.
-		 */
-    newElement = gcobject_.reuse_TMT_element_from_gc_.back();
-    gcobject_.reuse_TMT_element_from_gc_.pop_back();
-    newElement->set(0, 0, UINT32_MAX, lastcstamp, TransactionStatus::inFlight);
-#if ADD_ANALYSIS
-    ++eres_->local_TMT_element_reuse_;
-#endif
-  }
-
   /**
    * Check the latest commit timestamp
    */
-  for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
-    tmt = loadAcquire(TMT[i]);
-    this->txid_ = max(this->txid_, tmt->lastcstamp_.load(memory_order_acquire));
-  }
-  this->txid_ += 1;
-  newElement->txid_ = this->txid_;
+  this->txid_ = max(lastcstamp, MaxCstamp.load(memory_order_acquire)) + 1;
 
 	/**
-	 * Old object becomes cache object.
-	 */
-  gcobject_.gcq_for_TMT_.emplace_back(loadAcquire(TMT[thid_]));
-	/**
-	 * New object is registerd to transaction mapping table.
+	 * Reset the slot of this worker in transaction mapping table.
 	 */
-  storeRelease(TMT[thid_], newElement);
+  tmt->begin(this->txid_, lastcstamp);
 
   pstamp_ = 0;
-  sstamp_ = UINT32_MAX;
+  sstamp_ = UINT64_MAX;
   status_ = TransactionStatus::inFlight;
 }
 
@@ -123,6 +91,54 @@ void TxExecutor::tbegin() {
  * @brief Transaction read function.
  * @param [in] key The key of key-value
  */
+/**
+ * @brief begin a read only transaction at the safe snapshot.
+ * @detail It doesn't use its slot of TMT, since no writer refers to it. txid_
+ * is still taken as tbegin() does, because mainte() announces it.
+ * @return void
+ */
+void TxExecutor::beginSnapshot() {
+  this->txid_ = max(cstamp_, MaxCstamp.load(memory_order_acquire)) + 1;
+  this->snapshot_ = SafeSnap.snapshot();
+}
+
+/**
+ * @brief read the newest version in the safe snapshot.
+ * @detail It neither raises the readers bit nor updates the pstamp of the
+ * version, and it needs no read set and no validation, so it never aborts.
+ * Every transaction with a cstamp in the snapshot already finished, so the
+ * versions it sees never change.
+ * @param [in] key The key of key-value
+ * @return void
+ */
+void TxExecutor::snapshotRead(uint64_t key) {
+#if ADD_ANALYSIS
+  uint64_t start(rdtscp());
+#endif
+
+  Tuple *tuple;
+#if MASSTREE_USE
+  tuple = MT.get_value(key);
+#if ADD_ANALYSIS
+  ++eres_->local_tree_traversal_;
+#endif
+#else
+  tuple = get_tuple(Table, key);
+#endif
+
+  Version *ver;
+  ver = tuple->latest_.load(memory_order_acquire);
+  while (ver->status_.load(memory_order_acquire) != VersionStatus::committed ||
+         snapshot_ < ver->cstamp_.load(memory_order_acquire))
+    ver = ver->prev_;
+
+  memcpy(this->return_val_, ver->val_, VAL_SIZE);
+#if ADD_ANALYSIS
+  ++eres_->local_memcpys;
+  eres_->local_read_latency_ += rdtscp() - start;
+#endif
+}
+
 void TxExecutor::ssn_tread(uint64_t key) {
 #if ADD_ANALYSIS
   uint64_t start(rdtscp());
@@ -155,7 +171,7 @@ void TxExecutor::ssn_tread(uint64_t key) {
          txid_ < ver->cstamp_.load(memory_order_acquire))
     ver = ver->prev_;
 
-  if (ver->psstamp_.atomicLoadSstamp() == (UINT32_MAX & ~(TIDFLAG))) {
+  if (ver->psstamp_.atomicLoadSstamp() == (UINT64_MAX & ~(TIDFLAG))) {
     // no overwrite yet
     read_set_.emplace_back(key, tuple, ver);
   } else {
@@ -237,19 +253,7 @@ void TxExecutor::ssn_twrite(uint64_t key) {
    * later than its begin timestamp.
    */
   Version *expected, *desired;
-  if (gcobject_.reuse_version_from_gc_.empty()) {
-    desired = new Version();
-#if ADD_ANALYSIS
-    ++eres_->local_version_malloc_;
-#endif
-  } else {
-    desired = gcobject_.reuse_version_from_gc_.back();
-    gcobject_.reuse_version_from_gc_.pop_back();
-    desired->init();
-#if ADD_ANALYSIS
-    ++eres_->local_version_reuse_;
-#endif
-  }
+  desired = newVersionGeneration(tuple);
   desired->cstamp_.store(
       this->txid_,
       memory_order_relaxed);  // read operation, write operation,
@@ -264,9 +268,9 @@ void TxExecutor::ssn_twrite(uint64_t key) {
         VersionStatus::inFlight) {
       if (this->txid_ <= expected->cstamp_.load(memory_order_acquire)) {
         this->status_ = TransactionStatus::aborted;
-        TMT[thid_]->status_.store(TransactionStatus::aborted,
-                                  memory_order_release);
-        gcobject_.reuse_version_from_gc_.emplace_back(desired);
+        TMT[thid_].status_.store(TransactionStatus::aborted,
+                                 memory_order_release);
+        gcobject_.freeVersion(tuple, desired);
         goto FINISH_TWRITE;
       }
 
@@ -286,9 +290,9 @@ void TxExecutor::ssn_twrite(uint64_t key) {
       // Writers must abort if they would overwirte a version created after
       // their snapshot.
       this->status_ = TransactionStatus::aborted;
-      TMT[thid_]->status_.store(TransactionStatus::aborted,
-                                memory_order_release);
-      gcobject_.reuse_version_from_gc_.emplace_back(desired);
+      TMT[thid_].status_.store(TransactionStatus::aborted,
+                               memory_order_release);
+      gcobject_.freeVersion(tuple, desired);
       goto FINISH_TWRITE;
     }
 
@@ -328,10 +332,10 @@ FINISH_TWRITE:
  */
 void TxExecutor::ssn_commit() {
   this->status_ = TransactionStatus::committing;
-  TransactionTable *tmt = loadAcquire(TMT[thid_]);
+  TransactionTable *tmt = &TMT[thid_];
   tmt->status_.store(TransactionStatus::committing);
 
-  this->cstamp_ = ++Lsn;
+  takeCstamp();
   tmt->cstamp_.store(this->cstamp_, memory_order_release);
 
   // begin pre-commit
@@ -345,7 +349,7 @@ void TxExecutor::ssn_commit() {
   // finalize pi(T)
   sstamp_ = min(sstamp_, cstamp_);
   for (auto itr = read_set_.begin(); itr != read_set_.end(); ++itr) {
-    uint32_t verSstamp = (*itr).ver_->psstamp_.atomicLoadSstamp();
+    uint64_t verSstamp = (*itr).ver_->psstamp_.atomicLoadSstamp();
     // if the lowest bit raise, the record was overwrited by other concurrent
     // transactions. but in serial SSN, the validation of the concurrent
     // transactions will be done after that of this transaction. So it can skip.
@@ -360,6 +364,7 @@ void TxExecutor::ssn_commit() {
   else {
     status_ = TransactionStatus::aborted;
     SsnLock.unlock();
+    writeLog(false);
     return;
   }
 
@@ -387,9 +392,6 @@ void TxExecutor::ssn_commit() {
     (*itr).ver_->cstamp_ = verCstamp;
   }
 
-  // logging
-  //?*
-
   // status, inFlight -> committed
   for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
     memcpy((*itr).ver_->val_, write_val_, VAL_SIZE);
@@ -401,8 +403,15 @@ void TxExecutor::ssn_commit() {
 
   this->status_ = TransactionStatus::committed;
   SsnLock.unlock();
+  // the log block of a transaction waiting for SsnLock may be earlier.
+  writeLog(true);
   read_set_.clear();
   write_set_.clear();
+  TMT[thid_].lastcstamp_.store(cstamp_, memory_order_release);
+  publishCstamp();
+#if SNAPSHOT_READ
+  SafeSnap.check(sstamp_, cstamp_);
+#endif
   return;
 }
 
@@ -414,12 +423,16 @@ void TxExecutor::ssn_parallel_commit() {
   uint64_t start(rdtscp());
 #endif
   this->status_ = TransactionStatus::committing;
-  TransactionTable *tmt = TMT[thid_];
+  TransactionTable *tmt = &TMT[thid_];
   tmt->status_.store(TransactionStatus::committing);
 
-  this->cstamp_ = ++Lsn;
-  // this->cstamp_ = 2; test for effect of centralized counter in YCSB-C (read
-  // only workload)
+  /**
+   * Every commit takes a cstamp from a single counter, Lsn or the tail of
+   * Log. lsn_latency_avg (ADD_ANALYSIS=1) shows its cost. this->cstamp_ = 2
+   * instead tested the effect of the centralized counter in YCSB-C (read
+   * only workload).
+   */
+  takeCstamp();
 
   tmt->cstamp_.store(this->cstamp_, memory_order_release);
 
@@ -428,41 +441,72 @@ void TxExecutor::ssn_parallel_commit() {
   // finalize pi(T)
   this->sstamp_ = min(this->sstamp_, this->cstamp_);
   for (auto itr = read_set_.begin(); itr != read_set_.end(); ++itr) {
-    uint32_t v_sstamp = (*itr).ver_->psstamp_.atomicLoadSstamp();
+    uint64_t v_sstamp = (*itr).ver_->psstamp_.atomicLoadSstamp();
     // if lowest bits raise, it is TID
     if (v_sstamp & TIDFLAG) {
-      // identify worker by using TID
-      uint8_t worker = (v_sstamp >> TIDFLAG);
+      /**
+       * A transaction marks the version while it runs, and unmarks it before
+       * the next transaction of the worker begins. If it is still marked by
+       * the same worker, it is marked by the transaction of seq, or by a
+       * later one which began after this took cstamp and can't be pi. If
+       * another worker marked it meanwhile, retry with that worker.
+       */
+      uint64_t seq;
+      for (;;) {
+        // identify worker by using TID
+        uint32_t worker = (v_sstamp >> TIDFLAG);
+        tmt = &TMT[worker];
+        seq = tmt->readBegin();
+        v_sstamp = (*itr).ver_->psstamp_.atomicLoadSstamp();
+        if (!(v_sstamp & TIDFLAG) || (v_sstamp >> TIDFLAG) == worker) break;
+      }
+      if (!(v_sstamp & TIDFLAG)) {
+        this->sstamp_ = min(this->sstamp_, v_sstamp >> TIDFLAG);
+        continue;
+      }
       /**
        * If worker is Inflight state, it will be committed with newer timestamp than this.
        * Then, the worker can't be pi, so skip.
        * If not, check.
        */
-      tmt = loadAcquire(TMT[worker]);
       if (tmt->status_.load(memory_order_acquire) ==
           TransactionStatus::committing) {
         /**
          * Worker is in ssn_parallel_commit().
          * So it wait worker to get cstamp.
          */
-        while (tmt->cstamp_.load(memory_order_acquire) == 0)
+        uint64_t cstamp;
+        while ((cstamp = tmt->cstamp_.load(memory_order_acquire)) == 0 &&
+               !tmt->changed(seq))
           ;
         /**
          * If worker->cstamp_ is less than this->cstamp_, the worker can be pi.
          */
-        if (tmt->cstamp_.load(memory_order_acquire) < this->cstamp_) {
+        if (cstamp != 0 && cstamp < this->cstamp_) {
           /**
            * It wait worker to end parallel_commit (determine sstamp).
            */
-          while (tmt->status_.load(memory_order_acquire) ==
-                 TransactionStatus::committing)
+          TransactionStatus status;
+          while ((status = tmt->status_.load(memory_order_acquire)) ==
+                     TransactionStatus::committing &&
+                 !tmt->changed(seq))
             ;
-          if (tmt->status_.load(memory_order_acquire) ==
-              TransactionStatus::committed) {
-            this->sstamp_ =
-                min(this->sstamp_, tmt->sstamp_.load(memory_order_acquire));
+          uint64_t sstamp = tmt->sstamp_.load(memory_order_acquire);
+          if (!tmt->changed(seq)) {
+            if (status == TransactionStatus::committed)
+              this->sstamp_ = min(this->sstamp_, sstamp);
+            continue;
           }
         }
+        if (tmt->changed(seq)) {
+          /**
+           * The transaction finished, and it left its sstamp (or the
+           * initial one if it aborted) in the version.
+           */
+          v_sstamp = (*itr).ver_->psstamp_.atomicLoadSstamp();
+          if (!(v_sstamp & TIDFLAG))
+            this->sstamp_ = min(this->sstamp_, v_sstamp >> TIDFLAG);
+        }
       }
     } else {
       this->sstamp_ = min(this->sstamp_, v_sstamp >> TIDFLAG);
@@ -482,32 +526,36 @@ void TxExecutor::ssn_parallel_commit() {
       ver = ver->prev_;
     uint64_t rdrs = ver->readers_.load(memory_order_acquire);
     for (unsigned int worker = 0; worker < FLAGS_thread_num; ++worker) {
-      if ((rdrs & (one << worker)) ? 1 : 0) {
-        tmt = loadAcquire(TMT[worker]);
+      if ((rdrs & (one << (worker % READERS_BITS))) ? 1 : 0) {
+        tmt = &TMT[worker];
+        uint64_t seq = tmt->readBegin();
         /**
          * It can ignore if the reader is committing.
          * It can ignore if the reader is inFlight because
          * the reader will get larger cstamp and it can't be eta of this.
+         * If the transaction of the reader finishes while this waits, it
+         * already updated the pstamp of the version, which is re-read below.
          */
         if (tmt->status_.load(memory_order_acquire) ==
             TransactionStatus::committing) {
-          while (tmt->cstamp_.load(memory_order_acquire) == 0)
+          uint64_t cstamp;
+          while ((cstamp = tmt->cstamp_.load(memory_order_acquire)) == 0 &&
+                 !tmt->changed(seq))
             ;
           /**
            * If worker->cstamp_ is less than this->cstamp_, it can be eta.
            */
-          if (tmt->cstamp_.load(memory_order_acquire) < this->cstamp_) {
+          if (cstamp != 0 && cstamp < this->cstamp_) {
             /**
              * Wait end of parallel_commit (determing sstamp).
              */
-            while (tmt->status_.load(memory_order_acquire) ==
-                   TransactionStatus::committing)
+            TransactionStatus status;
+            while ((status = tmt->status_.load(memory_order_acquire)) ==
+                       TransactionStatus::committing &&
+                   !tmt->changed(seq))
               ;
-            if (tmt->status_.load(memory_order_acquire) ==
-                TransactionStatus::committed) {
-              this->pstamp_ =
-                  max(this->pstamp_, tmt->cstamp_.load(memory_order_acquire));
-            }
+            if (status == TransactionStatus::committed && !tmt->changed(seq))
+              this->pstamp_ = max(this->pstamp_, cstamp);
           }
         }
       }
@@ -518,7 +566,7 @@ void TxExecutor::ssn_parallel_commit() {
     this->pstamp_ = max(this->pstamp_, ver->psstamp_.atomicLoadPstamp());
   }
 
-  tmt = TMT[thid_];
+  tmt = &TMT[thid_];
   /**
    * ssn_check_exclusion
    */
@@ -529,6 +577,7 @@ void TxExecutor::ssn_parallel_commit() {
   } else {
     status_ = TransactionStatus::aborted;
     tmt->status_.store(TransactionStatus::aborted, memory_order_release);
+    writeLog(false);
     goto FINISH_PARALLEL_COMMIT;
   }
 
@@ -541,12 +590,11 @@ void TxExecutor::ssn_parallel_commit() {
    * update eta.
    */
   for (auto itr = read_set_.begin(); itr != read_set_.end(); ++itr) {
-    Psstamp pstmp;
-    pstmp.obj_ = (*itr).ver_->psstamp_.atomicLoad();
-    while (pstmp.pstamp_ < this->cstamp_) {
-      if ((*itr).ver_->psstamp_.atomicCASPstamp(pstmp.pstamp_, this->cstamp_))
+    uint64_t pstamp = (*itr).ver_->psstamp_.atomicLoadPstamp();
+    while (pstamp < this->cstamp_) {
+      if ((*itr).ver_->psstamp_.atomicCASPstamp(pstamp, this->cstamp_))
         break;
-      pstmp.obj_ = (*itr).ver_->psstamp_.atomicLoad();
+      pstamp = (*itr).ver_->psstamp_.atomicLoadPstamp();
     }
     downReadersBits((*itr).ver_);
   }
@@ -566,7 +614,7 @@ void TxExecutor::ssn_parallel_commit() {
     next_committed->psstamp_.atomicStoreSstamp(verSstamp);
     (*itr).ver_->cstamp_.store(this->cstamp_, memory_order_release);
     (*itr).ver_->psstamp_.atomicStorePstamp(this->cstamp_);
-    (*itr).ver_->psstamp_.atomicStoreSstamp(UINT32_MAX & ~(TIDFLAG));
+    (*itr).ver_->psstamp_.atomicStoreSstamp(UINT64_MAX & ~(TIDFLAG));
     memcpy((*itr).ver_->val_, write_val_, VAL_SIZE);
 #if ADD_ANALYSIS
     ++eres_->local_memcpys;
@@ -576,12 +624,15 @@ void TxExecutor::ssn_parallel_commit() {
         GCElement((*itr).key_, (*itr).rcdptr_, (*itr).ver_, this->cstamp_));
   }
 
-  // logging
-  //?*
+  writeLog(true);
 
   read_set_.clear();
   write_set_.clear();
-  TMT[thid_]->lastcstamp_.store(cstamp_, memory_order_release);
+  TMT[thid_].lastcstamp_.store(cstamp_, memory_order_release);
+  publishCstamp();
+#if SNAPSHOT_READ
+  SafeSnap.check(sstamp_, cstamp_);
+#endif
 
 FINISH_PARALLEL_COMMIT:
 #if ADD_ANALYSIS
@@ -590,6 +641,59 @@ FINISH_PARALLEL_COMMIT:
   return;
 }
 
+/**
+ * @brief take the commit LSN as cstamp.
+ * @detail With -log, it reserves the log block of the transaction in Log.
+ * The end offset of the block is the LSN. Otherwise, it increments Lsn.
+ * @return void
+ */
+void TxExecutor::takeCstamp() {
+#if ADD_ANALYSIS
+  uint64_t start(rdtscp());
+#endif
+  if (FLAGS_log) {
+    log_size_ = sizeof(LogBlockHeader) + sizeof(LogRecord) * write_set_.size();
+    log_offset_ = Log.reserve(log_size_);
+    this->cstamp_ = log_offset_ + log_size_;
+  } else {
+    this->cstamp_ = ++Lsn;
+  }
+#if ADD_ANALYSIS
+  eres_->local_lsn_latency_ += rdtscp() - start;
+  ++eres_->local_lsn_counts_;
+#endif
+}
+
+/**
+ * @brief fill the log block which takeCstamp() reserved.
+ * @pre The status of the transaction in TMT is decided, because the owners
+ * of the later blocks may wait for it before they fill theirs.
+ * @param [in] committed whether the transaction committed. If not, the block
+ * has no records.
+ * @return void
+ */
+void TxExecutor::writeLog(bool committed) {
+  if (!FLAGS_log) return;
+  LogBlockHeader *hd = reinterpret_cast<LogBlockHeader *>(&log_block_[0]);
+  hd->size_ = log_size_;
+  hd->lsn_ = this->cstamp_;
+  hd->rec_num_ = 0;
+  if (committed) {
+    LogRecord *rec =
+        reinterpret_cast<LogRecord *>(&log_block_[sizeof(LogBlockHeader)]);
+    for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
+      rec->key_ = (*itr).key_;
+      memcpy(rec->val_, write_val_, VAL_SIZE);
+      ++rec;
+    }
+    hd->rec_num_ = write_set_.size();
+  }
+  Log.write(log_offset_, &log_block_[0]);
+#if ADD_ANALYSIS
+  eres_->local_log_bytes_ += log_size_;
+#endif
+}
+
 /**
  * @brief function about abort.
  * clean-up local read/write set.
@@ -605,7 +709,7 @@ void TxExecutor::abort() {
 		/**
 		 * cancel successor mark(sstamp).
 		 */
-    next_committed->psstamp_.atomicStoreSstamp(UINT32_MAX & ~(TIDFLAG));
+    next_committed->psstamp_.atomicStoreSstamp(UINT64_MAX & ~(TIDFLAG));
     (*itr).ver_->status_.store(VersionStatus::aborted, memory_order_release);
   }
   write_set_.clear();
@@ -637,29 +741,31 @@ void TxExecutor::abort() {
 void TxExecutor::verify_exclusion_or_abort() {
   if (this->pstamp_ >= this->sstamp_) {
     this->status_ = TransactionStatus::aborted;
-    TransactionTable *tmt = loadAcquire(TMT[thid_]);
-    tmt->status_.store(TransactionStatus::aborted, memory_order_release);
+    TMT[thid_].status_.store(TransactionStatus::aborted, memory_order_release);
   }
 }
 
 void TxExecutor::mainte() {
-  gcstop_ = rdtscp();
-  if (chkClkSpan(gcstart_, gcstop_, FLAGS_gc_inter_us * FLAGS_clocks_per_us)) {
-    uint32_t loadThreshold = gcobject_.getGcThreshold();
-    if (pre_gc_threshold_ != loadThreshold) {
+  uint64_t epoch = Reclaimer.epoch();
+  if (gc_epoch_ != epoch) {
 #if ADD_ANALYSIS
-      uint64_t start;
-      start = rdtscp();
-      ++eres_->local_gc_counts_;
+    uint64_t start;
+    start = rdtscp();
+    ++eres_->local_gc_counts_;
 #endif
-      gcobject_.gcTMTelement(eres_);
-      gcobject_.gcVersion(eres_);
-      pre_gc_threshold_ = loadThreshold;
-      gcstart_ = gcstop_;
+    gcobject_.gcVersion(eres_);
+    gc_epoch_ = epoch;
 #if ADD_ANALYSIS
-      eres_->local_gc_latency_ += rdtscp() - start;
+    eres_->local_gc_latency_ += rdtscp() - start;
 #endif
-    }
+  }
+
+  gcstop_ = rdtscp();
+  if (chkClkSpan(gcstart_, gcstop_, FLAGS_gc_inter_us * FLAGS_clocks_per_us) &&
+      !Reclaimer.announced(thid_)) {
+    // the next transaction begins at txid which is not older.
+    Reclaimer.announce(thid_, txid_);
+    gcstart_ = gcstop_;
   }
 }
 
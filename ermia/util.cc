@@ -11,10 +11,13 @@
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <thread>
 
+#include "../include/atomic_wrapper.hh"
 #include "../include/cache_line_size.hh"
 #include "../include/config.hh"
 #include "../include/debug.hh"
+#include "../include/log_segment.hh"
 #include "../include/masstree_wrapper.hh"
 #include "../include/random.hh"
 #include "../include/result.hh"
@@ -49,15 +52,38 @@ void chkArg() {
     ERR;
   }
 
+  if (FLAGS_thread_num > MAX_THREAD_NUM) {
+    cout << "thread_num must be at most " << MAX_THREAD_NUM << "." << endl;
+    ERR;
+  }
+
   try {
-    TMT = new TransactionTable *[FLAGS_thread_num];
+    TMT = new TransactionTable[FLAGS_thread_num];
   } catch (bad_alloc) {
     ERR;
   }
 
-  for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
-    TMT[i] =
-        new TransactionTable(0, 0, UINT32_MAX, 0, TransactionStatus::inFlight);
+  Reclaimer.init(FLAGS_thread_num);
+
+  if (FLAGS_log) {
+    std::size_t max_block =
+        sizeof(LogBlockHeader) + sizeof(LogRecord) * FLAGS_max_ope;
+    std::size_t max_frame = FLAGS_log_segment_size -
+                            sizeof(LogSegmentHeader) - 2 * sizeof(uint64_t);
+    if (FLAGS_log_buffer_size & (FLAGS_log_buffer_size - 1) ||
+        FLAGS_log_buffer_size < max_block ||
+        FLAGS_log_segment_size < sizeof(LogSegmentHeader) + max_block +
+                                     2 * sizeof(uint64_t)) {
+      cout << "log_buffer_size must be a power of two, and it and "
+              "log_segment_size must hold the log block of max_ope records."
+           << endl;
+      ERR;
+    }
+    std::vector<std::string> log_dirs;
+    splitLogDirs(FLAGS_log_dirs, log_dirs);
+    Log.logseg_.init(log_dirs, 0, FLAGS_log_segment_size,
+                     FLAGS_log_segment_num);
+    Log.init(FLAGS_log_buffer_size, max_frame, FLAGS_log_recycle);
   }
 }
 
@@ -84,6 +110,9 @@ void displayDB() {
         case VersionStatus::committed:
           cout << "status:  committed";
           break;
+        case VersionStatus::unused:
+          cout << "status:  unused";
+          break;
       }
       cout << endl;
 
@@ -102,12 +131,19 @@ void displayParameter() {
   cout << "#FLAGS_clocks_per_us:\t\t\t" << FLAGS_clocks_per_us << endl;
   cout << "#FLAGS_extime:\t\t\t\t" << FLAGS_extime << endl;
   cout << "#FLAGS_gc_inter_us:\t\t\t" << FLAGS_gc_inter_us << endl;
+  cout << "#FLAGS_log:\t\t\t\t" << FLAGS_log << endl;
+  cout << "#FLAGS_log_buffer_size:\t\t\t" << FLAGS_log_buffer_size << endl;
+  cout << "#FLAGS_log_dirs:\t\t\t" << FLAGS_log_dirs << endl;
+  cout << "#FLAGS_log_recycle:\t\t\t" << FLAGS_log_recycle << endl;
+  cout << "#FLAGS_log_segment_num:\t\t\t" << FLAGS_log_segment_num << endl;
+  cout << "#FLAGS_log_segment_size:\t\t" << FLAGS_log_segment_size << endl;
+  cout << "#FLAGS_maintenance_tick_us:\t\t" << FLAGS_maintenance_tick_us << endl;
   cout << "#FLAGS_max_ope:\t\t\t\t" << FLAGS_max_ope << endl;
-  cout << "#FLAGS_pre_reserve_tmt_element:\t\t" << FLAGS_pre_reserve_tmt_element << endl;
   cout << "#FLAGS_pre_reserve_version:\t\t" << FLAGS_pre_reserve_version << endl;
   cout << "#FLAGS_rmw:\t\t\t\t" << FLAGS_rmw << endl;
   cout << "#FLAGS_rratio:\t\t\t\t" << FLAGS_rratio << endl;
   cout << "#FLAGS_thread_num:\t\t\t" << FLAGS_thread_num << endl;
+  cout << "#FLAGS_version_numa_local:\t\t" << FLAGS_version_numa_local << endl;
   cout << "#FLAGS_ycsb:\t\t\t\t" << FLAGS_ycsb << endl;
   cout << "#FLAGS_zipf_skew:\t\t\t" << FLAGS_zipf_skew << endl;
  }
@@ -121,15 +157,20 @@ void partTableInit([[maybe_unused]] size_t thid, uint64_t start, uint64_t end) {
     Tuple *tmp;
     tmp = &Table[i];
     tmp->min_cstamp_ = 0;
-    if (posix_memalign((void **)&tmp->latest_, CACHE_LINE_SIZE,
-                       sizeof(Version)) != 0)
-      ERR;
+#if INLINE_VERSION_OPT
+    tmp->inline_ver_.init();
+    tmp->inline_ver_.val_[0] = '\0';
+    tmp->latest_.store(&tmp->inline_ver_, std::memory_order_release);
+#else
+    tmp->latest_.store(VersionAllocators[FLAGS_thread_num + thid].allocate(),
+                       std::memory_order_release);
+#endif
     Version *verTmp = tmp->latest_.load(std::memory_order_acquire);
     verTmp->cstamp_ = 0;
     // verTmp->pstamp = 0;
     // verTmp->sstamp = UINT64_MAX & ~(1);
     verTmp->psstamp_.pstamp_ = 0;
-    verTmp->psstamp_.sstamp_ = UINT32_MAX & ~(1);
+    verTmp->psstamp_.sstamp_ = UINT64_MAX & ~(1);
     // cstamp, sstamp の最下位ビットは TID フラグ
     // 1の時はTID, 0の時はstamp
     verTmp->prev_ = nullptr;
@@ -151,6 +192,11 @@ void makeDB() {
 #endif
 
   size_t maxthread = decideParallelBuildNumber(FLAGS_tuple_num);
+  // slabs of the workers, then the loaders.
+  VersionAllocators = new SlabAllocator<Version>[FLAGS_thread_num + maxthread];
+  for (size_t i = 0; i < FLAGS_thread_num + maxthread; ++i)
+    VersionAllocators[i].init(FLAGS_version_numa_local,
+                              i < FLAGS_thread_num);
   std::vector<std::thread> thv;
   for (size_t i = 0; i < maxthread; ++i)
     thv.emplace_back(partTableInit, i, i * (FLAGS_tuple_num / maxthread),
@@ -158,73 +204,68 @@ void makeDB() {
   for (auto &th : thv) th.join();
 }
 
-void naiveGarbageCollection(const bool &quit) {
-  TransactionTable *tmt;
-
-  uint32_t mintxID = UINT32_MAX;
-  for (unsigned int i = 1; i < FLAGS_thread_num; ++i) {
-    tmt = __atomic_load_n(&TMT[i], __ATOMIC_ACQUIRE);
-    mintxID = min(mintxID, tmt->txid_.load(std::memory_order_acquire));
+#if SNAPSHOT_READ
+/**
+ * @brief wait until no transaction which took a cstamp not greater than the
+ * given one is committing.
+ * @detail A transaction is done when it stored lastcstamp_ after making its
+ * versions committed, or when the next one of the worker began. One which
+ * aborted makes none of its versions committed.
+ * @param [in] cstamp the candidate of the safe snapshot.
+ * @return void
+ */
+static void waitCommits(uint64_t cstamp) {
+  for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
+    TransactionTable *tmt = &TMT[i];
+    for (;;) {
+      uint64_t seq = tmt->readBegin();
+      TransactionStatus status = tmt->status_.load(std::memory_order_acquire);
+      if (status != TransactionStatus::committing &&
+          status != TransactionStatus::committed)
+        break;
+      uint64_t cs = tmt->cstamp_.load(std::memory_order_acquire);
+      if (tmt->changed(seq)) break;
+      // cstamp_ is 0 until the transaction stores the cstamp it took.
+      if (cs != 0 &&
+          (cs > cstamp ||
+           tmt->lastcstamp_.load(std::memory_order_acquire) == cs))
+        break;
+      _mm_pause();
+    }
   }
+}
+#endif
 
-  if (mintxID == 0)
-    return;
-  else {
-    // mintxIDから到達不能なバージョンを削除する
-    Version *verTmp, *delTarget;
-    for (unsigned int i = 0; i < FLAGS_tuple_num; ++i) {
-      // 時間がかかるので，離脱条件チェック
-      if (quit == true) return;
-
-      verTmp = Table[i].latest_.load(memory_order_acquire);
-      while (verTmp->status_.load(memory_order_acquire) !=
-             VersionStatus::committed)
-        verTmp = verTmp->prev_;
-      // この時点で， verTmp はコミット済み最新バージョン
-
-      uint64_t verCstamp = verTmp->cstamp_.load(memory_order_acquire);
-      while (mintxID < (verCstamp >> 1) ||
-             verTmp->status_.load(memory_order_acquire) !=
-                 VersionStatus::committed) {
-        verTmp = verTmp->prev_;
-        if (verTmp == nullptr) break;
-        verCstamp = verTmp->cstamp_.load(memory_order_acquire);
-      }
-      if (verTmp == nullptr) continue;
-      // verTmp は mintxID によって到達可能．
-
-      // ssn commit protocol によってverTmp->commited_prev までアクセスされる．
-      verTmp = verTmp->prev_;
-      while (verTmp->status_.load(memory_order_acquire) !=
-             VersionStatus::committed)
-        verTmp = verTmp->prev_;
-      if (verTmp == nullptr) continue;
-
-      // verTmp->prev_ からガベコレ可能
-      delTarget = verTmp->prev_;
-      if (delTarget == nullptr) continue;
-
-      verTmp->prev_ = nullptr;
-      while (delTarget != nullptr) {
-        verTmp = delTarget->prev_;
-        delete delTarget;
-        delTarget = verTmp;
-      }
-      //-----
-    }
+void leaderWork() {
+  if (Reclaimer.tryAdvance()) {
+    WatermarkStat.record(rdtscp(), FLAGS_gc_inter_us * FLAGS_clocks_per_us);
+#if SNAPSHOT_READ
+    SafeSnap.advance(Reclaimer.watermark(), MaxCstamp, waitCommits);
+#endif
+    if (FLAGS_log) LogSegmentManager::refillAll();
   }
 }
 
-void leaderWork(GarbageCollection &gcob) {
-  if (gcob.chkSecondRange()) {
-    gcob.decideGcThreshold();
-    gcob.mvSecondRangeToFirstRange();
+/**
+ * @brief write the log buffer to the log segments until quit, then the rest
+ * of it.
+ * @pre workers stopped before quit, so they filled all reserved blocks.
+ * @return void
+ */
+void logFlusher(const bool &quit) {
+  while (!loadAcquire(quit)) {
+    if (Log.flush() == 0) std::this_thread::yield();
   }
+  while (Log.flush() != 0)
+    ;
 }
 
 void ShowOptParameters() {
   cout << "#ShowOptParameters()"
        << ": ADD_ANALYSIS " << ADD_ANALYSIS << ": BACK_OFF " << BACK_OFF
-       << ": MASSTREE_USE " << MASSTREE_USE << ": KEY_SIZE " << KEY_SIZE
+       << ": INLINE_VERSION_OPT " << INLINE_VERSION_OPT
+       << ": MAINTENANCE_THREAD " << MAINTENANCE_THREAD
+       << ": MASSTREE_USE " << MASSTREE_USE
+       << ": SNAPSHOT_READ " << SNAPSHOT_READ << ": KEY_SIZE " << KEY_SIZE
        << ": KEY_SORT " << KEY_SORT << ": VAL_SIZE " << VAL_SIZE << endl;
 }
@@ -4,6 +4,7 @@
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <atomic>
@@ -117,6 +118,40 @@ class File {
       throw LibcError(errno, "ftruncate failed: ");
     }
   }
+
+  /**
+   * Allocate disk space of [offset, offset + length) in advance.
+   * Writing to allocated space doesn't extend the file.
+   */
+  void fallocate(off_t offset, off_t length) {
+#ifdef Linux
+    int err = ::posix_fallocate(fd(), offset, length);
+    if (err != 0) throw LibcError(err, "fallocate failed: ");
+#else
+    (void)offset;
+    (void)length;
+#endif  // Linux
+  }
+
+  void pwritev(const struct iovec* iov, int iovcnt, off_t offset) {
+    std::vector<struct iovec> vec(iov, iov + iovcnt);
+    size_t i = 0;
+    while (i < vec.size()) {
+      ssize_t r = ::pwritev(fd(), &vec[i], vec.size() - i, offset);
+      if (r < 0) throw LibcError(errno, "pwritev failed: ");
+      if (r == 0) ERR;
+      offset += r;
+      // skip written pieces.
+      while (i < vec.size() && static_cast<size_t>(r) >= vec[i].iov_len) {
+        r -= vec[i].iov_len;
+        ++i;
+      }
+      if (i < vec.size()) {
+        vec[i].iov_base = static_cast<char*>(vec[i].iov_base) + r;
+        vec[i].iov_len -= r;
+      }
+    }
+  }
 };
 
 // create a file if it does not exist.
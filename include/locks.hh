@@ -0,0 +1,1077 @@
+#pragma once
+
+/**
+ * Lock library shared by lock-based protocols (ss2pl, mocc).
+ *
+ * Every lock has the interface of RWLock (rwlock.hh):
+ * - void init()
+ * - void r_lock(), bool r_trylock(), void r_unlock()
+ * - void w_lock(), bool w_trylock(), void w_unlock()
+ * - bool upgrade() : wait until read -> write. false if the lock can't
+ *   upgrade. The caller still holds the read lock in that case.
+ * - bool tryupgrade() : read -> write without waiting.
+ * - bool w_locked() : a writer may hold the lock. Optimistic readers check it.
+ * - static void initGlobal(std::size_t thread_num) : allocate state shared by
+ *   all locks of the type. Call it once before workers start.
+ *
+ * Exclusive locks (TTAS, ticket, MCS) treat readers as writers, so upgrade is
+ * trivial. Queue locks find the node of the calling thread by the address of
+ * the lock (LockSlots), so a thread can hold at most LOCK_SLOTS locks of a
+ * type at a time. Queue reader-writer locks (MCS-RW, MQL) upgrade only if no
+ * request is queued behind the caller.
+ *
+ * The protocol chooses the lock by LOCK_KIND (LockOf) at compile time, so lock
+ * calls are inlined.
+ */
+
+#include <sched.h>
+#include <unistd.h>
+#include <xmmintrin.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cache_line_size.hh"
+#include "debug.hh"
+#include "mql_lock.hh"
+#include "rwlock.hh"
+#include "tsc.hh"
+
+#ifndef LOCK_SLOTS
+#define LOCK_SLOTS 64
+#endif
+
+// number of reader indicators of DistributedRWLock.
+#ifndef READ_INDICATORS
+#define READ_INDICATORS 4
+#endif
+
+inline std::atomic<uint32_t> LockThreadCount{0};
+
+/**
+ * @brief Dense id of the calling thread among threads which use the locks.
+ * @return thread id.
+ */
+inline uint32_t lockThreadId() {
+  static thread_local uint32_t id = LockThreadCount.fetch_add(1);
+  return id;
+}
+
+/**
+ * @brief Per-thread slots which hold the state of locks held (or being
+ * acquired) by the thread, keyed by the address of the lock.
+ * @tparam T state per lock, e.g. a queue node.
+ */
+template <typename T>
+class LockSlots {
+ public:
+  class Slot {
+   public:
+    T val_;
+    const void *lock_ = nullptr;
+  };
+
+  static Slot *slots() {
+    static thread_local Slot slot[LOCK_SLOTS];
+    return slot;
+  }
+
+  static Slot *acquire(const void *lock) {
+    Slot *slot = slots();
+    for (std::size_t i = 0; i < LOCK_SLOTS; ++i) {
+      if (slot[i].lock_ == nullptr) {
+        slot[i].lock_ = lock;
+        return &slot[i];
+      }
+    }
+    std::cout << "a thread holds more than LOCK_SLOTS locks." << std::endl;
+    ERR;
+  }
+
+  static Slot *find(const void *lock) {
+    Slot *slot = slots();
+    for (std::size_t i = 0; i < LOCK_SLOTS; ++i)
+      if (slot[i].lock_ == lock) return &slot[i];
+    ERR;
+  }
+
+  static void release(Slot *slot) { slot->lock_ = nullptr; }
+
+  static std::size_t index(Slot *slot) { return slot - slots(); }
+};
+
+/**
+ * @brief Test-and-test-and-set spin lock.
+ */
+class TTASLock {
+ public:
+  std::atomic<bool> locked_;
+
+  TTASLock() { init(); }
+
+  void init() { locked_.store(false, std::memory_order_release); }
+
+  static void initGlobal([[maybe_unused]] std::size_t thread_num) {}
+
+  void w_lock() {
+    for (;;) {
+      while (locked_.load(std::memory_order_relaxed)) _mm_pause();
+      if (!locked_.exchange(true, std::memory_order_acquire)) return;
+    }
+  }
+
+  bool w_trylock() {
+    return !locked_.load(std::memory_order_relaxed) &&
+           !locked_.exchange(true, std::memory_order_acquire);
+  }
+
+  void w_unlock() { locked_.store(false, std::memory_order_release); }
+
+  void r_lock() { w_lock(); }
+  bool r_trylock() { return w_trylock(); }
+  void r_unlock() { w_unlock(); }
+  bool upgrade() { return true; }
+  bool tryupgrade() { return true; }
+  bool w_locked() { return locked_.load(std::memory_order_acquire); }
+};
+
+/**
+ * @brief Ticket lock. Waiters get the lock in FIFO order.
+ */
+class TicketLock {
+ public:
+  std::atomic<uint32_t> next_;
+  std::atomic<uint32_t> serving_;
+
+  TicketLock() { init(); }
+
+  void init() {
+    next_.store(0, std::memory_order_relaxed);
+    serving_.store(0, std::memory_order_release);
+  }
+
+  static void initGlobal([[maybe_unused]] std::size_t thread_num) {}
+
+  void w_lock() {
+    uint32_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+    while (serving_.load(std::memory_order_acquire) != ticket) _mm_pause();
+  }
+
+  bool w_trylock() {
+    uint32_t ticket = serving_.load(std::memory_order_acquire);
+    uint32_t expected = ticket;
+    return next_.compare_exchange_strong(expected, ticket + 1,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed);
+  }
+
+  void w_unlock() {
+    serving_.store(serving_.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+  }
+
+  void r_lock() { w_lock(); }
+  bool r_trylock() { return w_trylock(); }
+  void r_unlock() { w_unlock(); }
+  bool upgrade() { return true; }
+  bool tryupgrade() { return true; }
+  bool w_locked() {
+    return next_.load(std::memory_order_acquire) !=
+           serving_.load(std::memory_order_acquire);
+  }
+};
+
+/**
+ * @brief MCS queue lock. Each waiter spins on its own queue node.
+ * @detail John M. Mellor-Crummey and Michael L. Scott. 1991. Algorithms for
+ * scalable synchronization on shared-memory multiprocessors. TOCS.
+ */
+class MCSLock {
+ public:
+  class alignas(CACHE_LINE_SIZE) Node {
+   public:
+    std::atomic<Node *> next_;
+    std::atomic<bool> locked_;
+  };
+  using Slots = LockSlots<Node>;
+
+  std::atomic<Node *> tail_;
+
+  MCSLock() { init(); }
+
+  void init() { tail_.store(nullptr, std::memory_order_release); }
+
+  static void initGlobal([[maybe_unused]] std::size_t thread_num) {}
+
+  void w_lock() {
+    Node *me = &Slots::acquire(this)->val_;
+    me->next_.store(nullptr, std::memory_order_relaxed);
+    me->locked_.store(true, std::memory_order_relaxed);
+    Node *pred = tail_.exchange(me, std::memory_order_acq_rel);
+    if (pred == nullptr) return;
+    pred->next_.store(me, std::memory_order_release);
+    while (me->locked_.load(std::memory_order_acquire)) _mm_pause();
+  }
+
+  bool w_trylock() {
+    if (tail_.load(std::memory_order_relaxed) != nullptr) return false;
+    Slots::Slot *slot = Slots::acquire(this);
+    Node *me = &slot->val_;
+    me->next_.store(nullptr, std::memory_order_relaxed);
+    me->locked_.store(false, std::memory_order_relaxed);
+    Node *expected = nullptr;
+    if (tail_.compare_exchange_strong(expected, me, std::memory_order_acq_rel,
+                                      std::memory_order_relaxed))
+      return true;
+    Slots::release(slot);
+    return false;
+  }
+
+  void w_unlock() {
+    Slots::Slot *slot = Slots::find(this);
+    Node *me = &slot->val_;
+    Node *next = me->next_.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      Node *expected = me;
+      if (tail_.compare_exchange_strong(expected, nullptr,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_relaxed)) {
+        Slots::release(slot);
+        return;
+      }
+      // a successor swapped the tail, wait for it to link itself.
+      while ((next = me->next_.load(std::memory_order_acquire)) == nullptr)
+        _mm_pause();
+    }
+    next->locked_.store(false, std::memory_order_release);
+    Slots::release(slot);
+  }
+
+  void r_lock() { w_lock(); }
+  bool r_trylock() { return w_trylock(); }
+  void r_unlock() { w_unlock(); }
+  bool upgrade() { return true; }
+  bool tryupgrade() { return true; }
+  bool w_locked() { return tail_.load(std::memory_order_acquire) != nullptr; }
+};
+
+/**
+ * @brief Fair reader-writer MCS queue lock. Adjacent readers in the queue
+ * share the lock.
+ * @detail The fair reader-writer lock of Mellor-Crummey and Scott (PPoPP '91).
+ * A reader whose predecessor is an active reader gets the lock at once, so
+ * r_trylock succeeds while readers hold it. w_trylock succeeds only if the
+ * queue is empty and no reader holds the lock, and it never waits. Only the
+ * reader at the tail of the queue can upgrade. It swaps
+ * its node for a writer node, so later requests queue behind the writer.
+ * An active reader at the tail sets kActiveTail in tail_, so r_trylock joins
+ * behind it by a single CAS which also checks that it is still active.
+ */
+class MCSRWLock {
+ public:
+  // state_ of a node.
+  static constexpr uint32_t kBlocked = 1;
+  static constexpr uint32_t kSucReader = 2;
+  static constexpr uint32_t kSucWriter = 4;
+  // low bit of tail_. nodes are aligned to cache lines.
+  static constexpr uintptr_t kActiveTail = 1;
+
+  class alignas(CACHE_LINE_SIZE) Node {
+   public:
+    std::atomic<Node *> next_;
+    std::atomic<uint32_t> state_;
+    bool writer_;
+  };
+  using Slots = LockSlots<Node>;
+
+  std::atomic<Node *> tail_;
+  std::atomic<Node *> next_writer_;
+  std::atomic<uint32_t> reader_count_;
+  std::atomic<bool> wlocked_;
+
+  MCSRWLock() { init(); }
+
+  void init() {
+    tail_.store(nullptr, std::memory_order_relaxed);
+    next_writer_.store(nullptr, std::memory_order_relaxed);
+    reader_count_.store(0, std::memory_order_relaxed);
+    wlocked_.store(false, std::memory_order_release);
+  }
+
+  static void initGlobal([[maybe_unused]] std::size_t thread_num) {}
+
+  void r_lock() {
+    Node *me = initNode(&Slots::acquire(this)->val_, false);
+    enterReader(me, untag(tail_.exchange(me, std::memory_order_acq_rel)));
+  }
+
+  bool r_trylock() {
+    Slots::Slot *slot = Slots::acquire(this);
+    Node *me = initNode(&slot->val_, false);
+    Node *pred = tail_.load(std::memory_order_acquire);
+    /**
+     * Only a free lock or an active reader at the tail grants the lock at
+     * once. The mark is compared by the CAS, so the node of pred which was
+     * reused by a waiting request is never taken for an active reader.
+     */
+    for (;;) {
+      if (pred != nullptr && pred == untag(pred)) {
+        Slots::release(slot);
+        return false;
+      }
+      if (tail_.compare_exchange_weak(pred, me, std::memory_order_acq_rel,
+                                      std::memory_order_acquire))
+        break;
+    }
+    enterReader(me, untag(pred));
+    return true;
+  }
+
+  void r_unlock() {
+    Slots::Slot *slot = Slots::find(this);
+    Node *me = &slot->val_;
+    Node *next = me->next_.load(std::memory_order_acquire);
+    Node *expected = tail_.load(std::memory_order_acquire);
+    if (next != nullptr || untag(expected) != me ||
+        !tail_.compare_exchange_strong(expected, nullptr,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_relaxed)) {
+      while ((next = me->next_.load(std::memory_order_acquire)) == nullptr)
+        _mm_pause();
+      if (me->state_.load(std::memory_order_acquire) & kSucWriter)
+        next_writer_.store(next, std::memory_order_release);
+    }
+    if (reader_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      // the last reader wakes up the waiting writer.
+      Node *writer = next_writer_.load(std::memory_order_acquire);
+      if (writer != nullptr &&
+          reader_count_.load(std::memory_order_acquire) == 0 &&
+          next_writer_.compare_exchange_strong(writer, nullptr,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_relaxed))
+        writer->state_.fetch_and(~kBlocked, std::memory_order_release);
+    }
+    Slots::release(slot);
+  }
+
+  void w_lock() {
+    Node *me = initNode(&Slots::acquire(this)->val_, true);
+    enterWriter(me, untag(tail_.exchange(me, std::memory_order_acq_rel)));
+  }
+
+  /**
+   * @detail Readers which left the queue may still hold the lock while tail_
+   * is null. No reader can join while I'm the tail, so reader_count_ only
+   * decreases then. If it isn't zero, it leaves the queue without waiting for
+   * them.
+   */
+  bool w_trylock() {
+    Slots::Slot *slot = Slots::acquire(this);
+    Node *me = initNode(&slot->val_, true);
+    Node *expected = nullptr;
+    if (!tail_.compare_exchange_strong(expected, me, std::memory_order_acq_rel,
+                                       std::memory_order_relaxed)) {
+      Slots::release(slot);
+      return false;
+    }
+    if (reader_count_.load(std::memory_order_acquire) == 0) {
+      wlocked_.store(true, std::memory_order_seq_cst);
+      return true;
+    }
+    leaveWriter(me);
+    Slots::release(slot);
+    return false;
+  }
+
+  void w_unlock() {
+    Slots::Slot *slot = Slots::find(this);
+    Node *me = &slot->val_;
+    wlocked_.store(false, std::memory_order_release);
+    Node *next = me->next_.load(std::memory_order_acquire);
+    Node *expected = me;
+    if (next != nullptr ||
+        !tail_.compare_exchange_strong(expected, nullptr,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_relaxed)) {
+      while ((next = me->next_.load(std::memory_order_acquire)) == nullptr)
+        _mm_pause();
+      if (!next->writer_)
+        reader_count_.fetch_add(1, std::memory_order_acq_rel);
+      next->state_.fetch_and(~kBlocked, std::memory_order_release);
+    }
+    Slots::release(slot);
+  }
+
+  bool upgrade() { return upgradeTail(true); }
+  bool tryupgrade() { return upgradeTail(false); }
+  /**
+   * @brief whether a writer holds the lock.
+   * @detail The flag is set by a seq_cst store after the writer gets the lock.
+   * Silo style validation of the writer reads other records after it, so
+   * two writers never both miss the flag of each other.
+   */
+  bool w_locked() { return wlocked_.load(std::memory_order_acquire); }
+
+ private:
+  static Node *tag(Node *node) {
+    return reinterpret_cast<Node *>(reinterpret_cast<uintptr_t>(node) |
+                                    kActiveTail);
+  }
+
+  static Node *untag(Node *node) {
+    return reinterpret_cast<Node *>(reinterpret_cast<uintptr_t>(node) &
+                                    ~kActiveTail);
+  }
+
+  static Node *initNode(Node *node, bool writer) {
+    node->next_.store(nullptr, std::memory_order_relaxed);
+    node->state_.store(kBlocked, std::memory_order_relaxed);
+    node->writer_ = writer;
+    return node;
+  }
+
+  void enterReader(Node *me, Node *pred) {
+    if (pred == nullptr) {
+      reader_count_.fetch_add(1, std::memory_order_acq_rel);
+      me->state_.fetch_and(~kBlocked, std::memory_order_release);
+    } else {
+      uint32_t expected = kBlocked;
+      if (pred->writer_ ||
+          pred->state_.compare_exchange_strong(expected, kBlocked | kSucReader,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+        // pred is a writer or a waiting reader. it will wake me up.
+        pred->next_.store(me, std::memory_order_release);
+        while (me->state_.load(std::memory_order_acquire) & kBlocked)
+          _mm_pause();
+      } else {
+        // pred is an active reader.
+        reader_count_.fetch_add(1, std::memory_order_acq_rel);
+        pred->next_.store(me, std::memory_order_release);
+        me->state_.fetch_and(~kBlocked, std::memory_order_release);
+      }
+    }
+
+    if (me->state_.load(std::memory_order_acquire) & kSucReader) {
+      // wake up the reader which waits behind me.
+      Node *next;
+      while ((next = me->next_.load(std::memory_order_acquire)) == nullptr)
+        _mm_pause();
+      reader_count_.fetch_add(1, std::memory_order_acq_rel);
+      next->state_.fetch_and(~kBlocked, std::memory_order_release);
+    }
+
+    // tell r_trylock that the tail is an active reader.
+    Node *expected = me;
+    if (tail_.load(std::memory_order_relaxed) == me)
+      tail_.compare_exchange_strong(expected, tag(me),
+                                    std::memory_order_release,
+                                    std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief leave the queue as a writer which wasn't granted.
+   * @detail The requests behind me are handed over as w_unlock() does, but a
+   * writer is handed over to the last reader as enterWriter() does, since the
+   * readers still hold the lock.
+   */
+  void leaveWriter(Node *me) {
+    Node *expected = me;
+    if (tail_.compare_exchange_strong(expected, nullptr,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_relaxed))
+      return;
+    Node *next;
+    // the successor is between its exchange on tail_ and linking itself.
+    while ((next = me->next_.load(std::memory_order_acquire)) == nullptr)
+      _mm_pause();
+    if (next->writer_) {
+      next_writer_.store(next, std::memory_order_release);
+      if (reader_count_.load(std::memory_order_acquire) == 0 &&
+          next_writer_.exchange(nullptr, std::memory_order_acq_rel) == next)
+        next->state_.fetch_and(~kBlocked, std::memory_order_release);
+    } else {
+      reader_count_.fetch_add(1, std::memory_order_acq_rel);
+      next->state_.fetch_and(~kBlocked, std::memory_order_release);
+    }
+  }
+
+  void enterWriter(Node *me, Node *pred) {
+    if (pred == nullptr) {
+      next_writer_.store(me, std::memory_order_release);
+      if (reader_count_.load(std::memory_order_acquire) == 0 &&
+          next_writer_.exchange(nullptr, std::memory_order_acq_rel) == me)
+        me->state_.fetch_and(~kBlocked, std::memory_order_release);
+      // otherwise the last reader wakes me up.
+    } else {
+      pred->state_.fetch_or(kSucWriter, std::memory_order_acq_rel);
+      pred->next_.store(me, std::memory_order_release);
+    }
+    while (me->state_.load(std::memory_order_acquire) & kBlocked) _mm_pause();
+    wlocked_.store(true, std::memory_order_seq_cst);
+  }
+
+  /**
+   * @brief upgrade the read lock of the reader at the tail.
+   * @detail Readers join only through tail_, so after the CAS no reader can
+   * join and reader_count_ only decreases.
+   * @param [in] wait wait for the readers ahead of me to leave.
+   * @return false if it can't upgrade. The read lock is still held then.
+   */
+  bool upgradeTail(bool wait) {
+    Slots::Slot *rslot = Slots::find(this);
+    Node *me = &rslot->val_;
+    Node *expected = tail_.load(std::memory_order_acquire);
+    if (untag(expected) != me ||
+        (!wait && reader_count_.load(std::memory_order_acquire) != 1))
+      return false;
+    Slots::Slot *wslot = Slots::acquire(this);
+    Node *writer = initNode(&wslot->val_, true);
+    writer->state_.store(0, std::memory_order_relaxed);
+    if (!tail_.compare_exchange_strong(expected, writer,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_relaxed)) {
+      Slots::release(wslot);
+      return false;
+    }
+    while (reader_count_.load(std::memory_order_acquire) != 1) _mm_pause();
+    reader_count_.store(0, std::memory_order_release);
+    wlocked_.store(true, std::memory_order_seq_cst);
+    Slots::release(rslot);
+    return true;
+  }
+};
+
+/**
+ * @brief MQL lock (mql_lock.hh) with the common interface. Queue nodes are
+ * taken from the range of MQLNodePool which the calling thread owns.
+ * @detail trylock uses the cancellation of MQL, so it leaves the queue
+ * instead of waiting behind the holders. Only the reader at the tail of the
+ * queue can upgrade, as MCSRWLock.
+ */
+class MQLRWLock {
+ public:
+  class Empty {};
+  using Slots = LockSlots<Empty>;
+
+  MQLock lock_;
+
+  void init() {
+    lock_.nreaders.store(0, std::memory_order_relaxed);
+    lock_.tail.store(0, std::memory_order_relaxed);
+    lock_.next_writer.store(0, std::memory_order_relaxed);
+    lock_.wlocked.store(false, std::memory_order_release);
+  }
+
+  static void initGlobal(std::size_t thread_num) {
+    if (MQLNodePool == nullptr) initMQLNodePool(thread_num * LOCK_SLOTS);
+  }
+
+  void r_lock() {
+    lock_.acquire_reader_lock(nodeId(Slots::acquire(this)), 0, false);
+  }
+
+  bool r_trylock() {
+    Slots::Slot *slot = Slots::acquire(this);
+    if (lock_.acquire_reader_lock(nodeId(slot), 0, true) ==
+        MQL_RESULT::Acquired)
+      return true;
+    Slots::release(slot);
+    return false;
+  }
+
+  void r_unlock() {
+    Slots::Slot *slot = Slots::find(this);
+    lock_.release_reader_lock(nodeId(slot), 0);
+    Slots::release(slot);
+  }
+
+  void w_lock() {
+    lock_.acquire_writer_lock(nodeId(Slots::acquire(this)), 0, false);
+    lock_.wlocked.store(true, std::memory_order_seq_cst);
+  }
+
+  bool w_trylock() {
+    Slots::Slot *slot = Slots::acquire(this);
+    if (lock_.acquire_writer_lock(nodeId(slot), 0, true) ==
+        MQL_RESULT::Cancelled) {
+      Slots::release(slot);
+      return false;
+    }
+    lock_.wlocked.store(true, std::memory_order_seq_cst);
+    return true;
+  }
+
+  void w_unlock() {
+    Slots::Slot *slot = Slots::find(this);
+    lock_.wlocked.store(false, std::memory_order_release);
+    lock_.release_writer_lock(nodeId(slot), 0);
+    Slots::release(slot);
+  }
+
+  bool upgrade() { return upgradeTail(true); }
+  bool tryupgrade() { return upgradeTail(false); }
+  // see MCSRWLock::w_locked().
+  bool w_locked() { return lock_.ldAcqWlocked(); }
+
+ private:
+  /**
+   * @brief upgrade the read lock of the reader at the tail.
+   * @detail It swaps its node for a granted writer node by CAS on the tail.
+   * @param [in] wait wait for the readers ahead of me to leave.
+   * @return false if it can't upgrade. The read lock is still held then.
+   */
+  bool upgradeTail(bool wait) {
+    Slots::Slot *rslot = Slots::find(this);
+    uint32_t me = nodeId(rslot);
+    if (lock_.tail.load(std::memory_order_acquire) != me ||
+        (!wait && lock_.nreaders.load(std::memory_order_acquire) != 1))
+      return false;
+    Slots::Slot *wslot = Slots::acquire(this);
+    uint32_t writer = nodeId(wslot);
+    MQLNodePool[writer].init(LockMode::Writer, (uint32_t)SentinelValue::None,
+                             true, false, LockMode::None, LockStatus::Granted,
+                             (uint32_t)SentinelValue::None);
+    if (!lock_.tail.compare_exchange_strong(me, writer,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+      Slots::release(wslot);
+      return false;
+    }
+    while (lock_.nreaders.load(std::memory_order_acquire) != 1) _mm_pause();
+    lock_.nreaders.store(0, std::memory_order_release);
+    lock_.wlocked.store(true, std::memory_order_seq_cst);
+    Slots::release(rslot);
+    return true;
+  }
+
+  static uint32_t nodeId(Slots::Slot *slot) {
+    std::size_t id = MQL_NODE_ID_BASE + lockThreadId() * LOCK_SLOTS +
+                     Slots::index(slot);
+    if (id >= MQLNodePoolSize) ERR;
+    return id;
+  }
+};
+
+/**
+ * @brief Reader-biased lock over RWLock.
+ * @detail BRAVO: Dave Dice and Alex Kogan. 2019. BRAVO - Biased Locking for
+ * Reader-Writer Locks. USENIX ATC '19. While the bias is on, a reader
+ * publishes the lock into a slot of the global VisibleReaders table chosen by
+ * hashing (lock, thread) and doesn't touch the lock word, so readers of a hot
+ * record don't bounce its cache line. A writer revokes the bias and waits for
+ * the published readers by scanning the table. Readers turn the bias on again
+ * after kInhibitMultiplier times the revocation time, which bounds the
+ * overhead of revocations. A reader whose slot is taken falls back to the
+ * underlying lock.
+ */
+class ReaderBiasedLock {
+ public:
+  static constexpr std::size_t kVisibleReadersBits = 12;
+  static constexpr std::size_t kVisibleReaders = 1 << kVisibleReadersBits;
+  static constexpr uint64_t kInhibitMultiplier = 9;
+  // the reader holds the underlying lock.
+  static constexpr std::size_t kSlowPath = kVisibleReaders;
+
+  alignas(CACHE_LINE_SIZE) static inline std::atomic<const void *>
+      VisibleReaders[kVisibleReaders];
+  using Slots = LockSlots<std::size_t>;
+
+  RWLock lock_;
+  std::atomic<bool> rbias_;
+  std::atomic<uint64_t> inhibit_until_;  // [clocks]. updated by writers.
+
+  ReaderBiasedLock() { init(); }
+
+  void init() {
+    lock_.init();
+    inhibit_until_.store(0, std::memory_order_relaxed);
+    rbias_.store(true, std::memory_order_release);
+  }
+
+  static void initGlobal([[maybe_unused]] std::size_t thread_num) {}
+
+  void r_lock() {
+    if (tryFastRead()) return;
+    lock_.r_lock();
+    enableBias();
+    Slots::acquire(this)->val_ = kSlowPath;
+  }
+
+  bool r_trylock() {
+    if (tryFastRead()) return true;
+    if (!lock_.r_trylock()) return false;
+    enableBias();
+    Slots::acquire(this)->val_ = kSlowPath;
+    return true;
+  }
+
+  void r_unlock() {
+    Slots::Slot *slot = Slots::find(this);
+    if (slot->val_ == kSlowPath)
+      lock_.r_unlock();
+    else
+      VisibleReaders[slot->val_].store(nullptr, std::memory_order_release);
+    Slots::release(slot);
+  }
+
+  void w_lock() {
+    lock_.w_lock();
+    revokeBias(kSlowPath, true);
+  }
+
+  bool w_trylock() {
+    if (!lock_.w_trylock()) return false;
+    if (revokeBias(kSlowPath, false)) return true;
+    lock_.w_unlock();
+    return false;
+  }
+
+  void w_unlock() { lock_.w_unlock(); }
+
+  bool upgrade() { return upgrade(true); }
+  bool tryupgrade() { return upgrade(false); }
+
+  bool w_locked() { return lock_.w_locked(); }
+
+ private:
+  std::size_t visibleReader() {
+    uint64_t h = (reinterpret_cast<uintptr_t>(this) ^
+                  (static_cast<uint64_t>(lockThreadId()) << 48)) *
+                 0x9e3779b97f4a7c15ULL;
+    return h >> (64 - kVisibleReadersBits);
+  }
+
+  bool tryFastRead() {
+    if (!rbias_.load(std::memory_order_acquire)) return false;
+    std::size_t idx = visibleReader();
+    const void *expected = nullptr;
+    if (!VisibleReaders[idx].compare_exchange_strong(expected, this)) return false;
+    // publish the slot before checking the bias. revokeBias does the reverse.
+    if (rbias_.load()) {
+      Slots::acquire(this)->val_ = idx;
+      return true;
+    }
+    VisibleReaders[idx].store(nullptr, std::memory_order_release);
+    return false;
+  }
+
+  void enableBias() {
+    if (!rbias_.load(std::memory_order_relaxed) &&
+        rdtscp() >= inhibit_until_.load(std::memory_order_relaxed))
+      rbias_.store(true, std::memory_order_release);
+  }
+
+  /**
+   * @brief turn the bias off and wait for published readers.
+   * @pre it holds the underlying lock in write mode.
+   * @param [in] mine slot of the caller itself which is ignored.
+   * @param [in] wait if false, give up when a published reader exists.
+   * @return false if it gave up. The bias is on again then.
+   */
+  bool revokeBias(std::size_t mine, bool wait) {
+    if (!rbias_.load(std::memory_order_relaxed)) return true;
+    rbias_.store(false);
+    uint64_t start = rdtscp();
+    for (std::size_t i = 0; i < kVisibleReaders; ++i) {
+      if (i == mine) continue;
+      while (VisibleReaders[i].load(std::memory_order_acquire) == this) {
+        if (!wait) {
+          // the published reader still holds the lock, so later writers must
+          // see the bias and scan again.
+          rbias_.store(true);
+          return false;
+        }
+        _mm_pause();
+      }
+    }
+    uint64_t now = rdtscp();
+    inhibit_until_.store(now + (now - start) * kInhibitMultiplier,
+                         std::memory_order_relaxed);
+    return true;
+  }
+
+  /**
+   * @detail A reader on the fast path first takes the underlying lock in read
+   * mode without waiting and withdraws its slot, and then upgrades as a reader
+   * on the slow path. It never waits for the underlying lock, since the writer
+   * holding it may wait for the slot of the caller in revokeBias, and another
+   * reader may be upgrading too. Only published readers are waited for, and
+   * they don't wait for the underlying lock while their slots are published.
+   */
+  bool upgrade(bool wait) {
+    Slots::Slot *slot = Slots::find(this);
+    if (slot->val_ != kSlowPath) {
+      if (!lock_.r_trylock()) return false;
+      VisibleReaders[slot->val_].store(nullptr, std::memory_order_release);
+      slot->val_ = kSlowPath;
+    }
+    if (!lock_.tryupgrade()) return false;
+    if (!revokeBias(kSlowPath, wait)) {
+      lock_.downgrade();
+      return false;
+    }
+    Slots::release(slot);
+    return true;
+  }
+};
+
+/**
+ * @brief Reader-writer lock with distributed reader indicators.
+ * @detail Irina Calciu, Dave Dice, Yossi Lev, Victor Luchangco, Virendra J.
+ * Marathe, and Nir Shavit. 2013. NUMA-aware Reader-Writer Locks. PPoPP '13.
+ * A reader increments one of READ_INDICATORS counters of the lock, each on its
+ * own cache line, so readers of a hot record on different cores or NUMA nodes
+ * don't bounce one line. The counter of a thread is fixed by the CPU it runs
+ * on when it first takes a lock (workers are pinned): CPUs of a NUMA node
+ * share a disjoint group of counters. A writer revokes the read access by
+ * setting wflag_, after which readers back off, and waits until all counters
+ * drain. Unlike ReaderBiasedLock, the indicators belong to the lock, so
+ * readers never fall back to a shared word, at the cost of
+ * (READ_INDICATORS + 1) * CACHE_LINE_SIZE bytes per lock.
+ */
+class DistributedRWLock {
+ public:
+  class alignas(CACHE_LINE_SIZE) Indicator {
+   public:
+    std::atomic<uint32_t> readers_;
+  };
+
+  std::atomic<bool> wflag_;
+  Indicator ind_[READ_INDICATORS];
+
+  DistributedRWLock() { init(); }
+
+  void init() {
+    for (std::size_t i = 0; i < READ_INDICATORS; ++i)
+      ind_[i].readers_.store(0, std::memory_order_relaxed);
+    wflag_.store(false, std::memory_order_release);
+  }
+
+  /**
+   * @brief map CPUs to indicators by their NUMA node.
+   * @detail It reads /sys/devices/system/node. Without it, all CPUs belong
+   * to one node.
+   */
+  static void initGlobal([[maybe_unused]] std::size_t thread_num) {
+    std::vector<std::vector<std::size_t>> nodes;
+    for (std::size_t node = 0;; ++node) {
+      std::ifstream ifs("/sys/devices/system/node/node" +
+                        std::to_string(node) + "/cpulist");
+      if (!ifs) break;
+      std::string list;
+      std::getline(ifs, list);
+      nodes.emplace_back(parseCpuList(list));
+    }
+
+    std::size_t cpus = sysconf(_SC_NPROCESSORS_CONF);
+    CpuIndicator.assign(cpus, 0);
+    if (nodes.empty()) {
+      for (std::size_t cpu = 0; cpu < cpus; ++cpu)
+        CpuIndicator[cpu] = cpu % READ_INDICATORS;
+      return;
+    }
+    // each node gets READ_INDICATORS / nodes counters, at least one.
+    std::size_t per = std::max<std::size_t>(READ_INDICATORS / nodes.size(), 1);
+    for (std::size_t node = 0; node < nodes.size(); ++node) {
+      for (std::size_t rank = 0; rank < nodes[node].size(); ++rank) {
+        std::size_t cpu = nodes[node][rank];
+        if (cpu < cpus)
+          CpuIndicator[cpu] = (node * per + rank % per) % READ_INDICATORS;
+      }
+    }
+  }
+
+  void r_lock() {
+    Indicator &ind = ind_[myIndicator()];
+    for (;;) {
+      ind.readers_.fetch_add(1);
+      // publish the reader before checking the writer. w_lock does the
+      // reverse.
+      if (!wflag_.load()) return;
+      ind.readers_.fetch_sub(1, std::memory_order_release);
+      while (wflag_.load(std::memory_order_acquire)) _mm_pause();
+    }
+  }
+
+  bool r_trylock() {
+    if (wflag_.load(std::memory_order_acquire)) return false;
+    Indicator &ind = ind_[myIndicator()];
+    ind.readers_.fetch_add(1);
+    if (!wflag_.load()) return true;
+    ind.readers_.fetch_sub(1, std::memory_order_release);
+    return false;
+  }
+
+  void r_unlock() {
+    ind_[myIndicator()].readers_.fetch_sub(1, std::memory_order_release);
+  }
+
+  void w_lock() {
+    for (;;) {
+      bool expected = false;
+      if (!wflag_.load(std::memory_order_relaxed) &&
+          wflag_.compare_exchange_weak(expected, true))
+        break;
+      _mm_pause();
+    }
+    drain();
+  }
+
+  bool w_trylock() {
+    bool expected = false;
+    if (wflag_.load(std::memory_order_relaxed) ||
+        !wflag_.compare_exchange_strong(expected, true))
+      return false;
+    if (readers() == 0) return true;
+    wflag_.store(false, std::memory_order_release);
+    return false;
+  }
+
+  void w_unlock() { wflag_.store(false, std::memory_order_release); }
+
+  /**
+   * @detail It fails if another writer revoked the read access first, since
+   * that writer waits for the caller.
+   */
+  bool upgrade() {
+    bool expected = false;
+    if (!wflag_.compare_exchange_strong(expected, true)) return false;
+    ind_[myIndicator()].readers_.fetch_sub(1, std::memory_order_release);
+    drain();
+    return true;
+  }
+
+  bool tryupgrade() {
+    bool expected = false;
+    if (!wflag_.compare_exchange_strong(expected, true)) return false;
+    // the caller is the only reader.
+    if (readers() == 1) {
+      ind_[myIndicator()].readers_.fetch_sub(1, std::memory_order_release);
+      return true;
+    }
+    wflag_.store(false, std::memory_order_release);
+    return false;
+  }
+
+  bool w_locked() { return wflag_.load(std::memory_order_acquire); }
+
+ private:
+  static inline std::vector<std::size_t> CpuIndicator;
+
+  /**
+   * @brief parse a cpulist of sysfs, e.g. "0-3,8-11".
+   */
+  static std::vector<std::size_t> parseCpuList(const std::string &list) {
+    std::vector<std::size_t> cpus;
+    std::size_t pos = 0;
+    while (pos < list.size()) {
+      std::size_t end = list.find(',', pos);
+      if (end == std::string::npos) end = list.size();
+      std::string range = list.substr(pos, end - pos);
+      std::size_t dash = range.find('-');
+      if (!range.empty()) {
+        std::size_t first = std::stoul(range.substr(0, dash));
+        std::size_t last = dash == std::string::npos
+                               ? first
+                               : std::stoul(range.substr(dash + 1));
+        for (std::size_t cpu = first; cpu <= last; ++cpu)
+          cpus.emplace_back(cpu);
+      }
+      pos = end + 1;
+    }
+    return cpus;
+  }
+
+  static std::size_t myIndicator() {
+    static thread_local std::size_t id = [] {
+      int cpu = sched_getcpu();
+      if (cpu < 0) cpu = lockThreadId();
+      if (static_cast<std::size_t>(cpu) < CpuIndicator.size())
+        return CpuIndicator[cpu];
+      return static_cast<std::size_t>(cpu) % READ_INDICATORS;
+    }();
+    return id;
+  }
+
+  uint64_t readers() {
+    uint64_t sum = 0;
+    for (std::size_t i = 0; i < READ_INDICATORS; ++i)
+      sum += ind_[i].readers_.load(std::memory_order_acquire);
+    return sum;
+  }
+
+  /**
+   * @brief wait for the readers.
+   * @pre it set wflag_.
+   */
+  void drain() {
+    for (std::size_t i = 0; i < READ_INDICATORS; ++i)
+      while (ind_[i].readers_.load(std::memory_order_acquire) != 0)
+        _mm_pause();
+  }
+};
+
+/**
+ * @brief Lock type of each LOCK_KIND.
+ */
+template <int Kind>
+class LockOf;
+template <>
+class LockOf<0> {
+ public:
+  using type = RWLock;
+  static constexpr const char *name = "RWLock";
+};
+template <>
+class LockOf<1> {
+ public:
+  using type = TTASLock;
+  static constexpr const char *name = "TTASLock";
+};
+template <>
+class LockOf<2> {
+ public:
+  using type = TicketLock;
+  static constexpr const char *name = "TicketLock";
+};
+template <>
+class LockOf<3> {
+ public:
+  using type = MCSLock;
+  static constexpr const char *name = "MCSLock";
+};
+template <>
+class LockOf<4> {
+ public:
+  using type = MCSRWLock;
+  static constexpr const char *name = "MCSRWLock";
+};
+template <>
+class LockOf<5> {
+ public:
+  using type = MQLRWLock;
+  static constexpr const char *name = "MQLRWLock";
+};
+template <>
+class LockOf<6> {
+ public:
+  using type = ReaderBiasedLock;
+  static constexpr const char *name = "ReaderBiasedLock";
+};
+template <>
+class LockOf<7> {
+ public:
+  using type = DistributedRWLock;
+  static constexpr const char *name = "DistributedRWLock";
+};
+
+#ifdef LOCK_KIND
+using SelectedLock = LockOf<LOCK_KIND>::type;
+#endif
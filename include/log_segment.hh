@@ -0,0 +1,391 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "debug.hh"
+#include "fileio.hh"
+
+/**
+ * @brief Header at the head of each log segment.
+ * @detail seq_ increases every time the owner starts to use a segment,
+ * so recovery sorts segments by seq_ and a recycled segment never looks like
+ * an old one.
+ */
+class LogSegmentHeader {
+ public:
+  static constexpr uint64_t kMagic = 0x4743455342434343;  // "CCCBSECG"
+  uint64_t magic_ = kMagic;
+  uint64_t owner_ = 0;
+  uint64_t seq_ = 0;
+  uint64_t size_ = 0;
+};
+
+/**
+ * @brief Preallocated, recycled log segments of a single log writer.
+ * @detail Each segment is a file of fixed size which is allocated by
+ * fallocate at init(). Appending a log frame to it overwrites allocated space,
+ * so it doesn't extend the file and doesn't update filesystem metadata on
+ * each flush. When the current segment is full, it rotates to a free segment.
+ * A full segment becomes free when reclaim epoch (checkpoint or durable epoch)
+ * passes the largest epoch in it. If there are no free segments, it takes a
+ * spare one, which the leader or the maintenance thread created ahead of time
+ * by refillAll(), and it creates one by itself only if no spare is left.
+ * A new segment is filled with zeros by real writes and synced before use.
+ * fallocate only makes unwritten extents, and the first write to each block
+ * would still convert the extent and journal it on the commit path.
+ * Segments are spread over the given log directories.
+ *
+ * Layout of a segment:
+ * [LogSegmentHeader][frame]...[frame][0]
+ * frame := [uint64_t length][payload]
+ * The trailing zero length marks the end of valid frames, so stale frames of
+ * the previous use of a recycled segment are never read.
+ */
+class LogSegmentManager {
+ public:
+  class Segment {
+   public:
+    std::string path_;
+    std::unique_ptr<File> file_;
+    uint64_t seq_ = 0;
+    uint64_t max_epoch_ = 0;
+    std::size_t used_ = 0;
+  };
+
+  std::vector<Segment> segments_;
+  std::deque<std::size_t> free_;  // index of free segments
+  std::deque<std::size_t> full_;  // index of full segments, oldest first
+  std::size_t cur_ = 0;
+  std::vector<std::string> dirs_;
+  uint64_t owner_ = 0;
+  uint64_t next_seq_ = 1;
+  uint64_t reclaim_epoch_ = 0;
+  std::size_t segment_size_ = 0;
+  std::atomic<std::size_t> next_index_{0};  // index of the next segment file
+  std::mutex spare_mutex_;
+  std::deque<Segment> spares_;  // segments created ahead of time
+
+  // the number of spare segments refill() keeps.
+  static constexpr std::size_t kSpareNum = 2;
+
+  // statistics
+  uint64_t rotations_ = 0;
+  uint64_t recycles_ = 0;
+  std::atomic<uint64_t> allocations_{0};
+  uint64_t sync_allocations_ = 0;  // allocations on the write path
+
+  LogSegmentManager() = default;
+
+  ~LogSegmentManager() {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    std::vector<LogSegmentManager *> &managers = registry();
+    managers.erase(std::remove(managers.begin(), managers.end(), this),
+                   managers.end());
+  }
+
+  /**
+   * @brief preallocate segments.
+   * @param [in] dirs log directories. Segments are spread over them.
+   * @param [in] owner id of the log writer (worker thread id).
+   * @param [in] segment_size size of each segment [byte].
+   * @param [in] segment_num the number of segments preallocated.
+   * @return void
+   */
+  void init(const std::vector<std::string> &dirs, uint64_t owner,
+            std::size_t segment_size, std::size_t segment_num) {
+    dirs_ = dirs;
+    owner_ = owner;
+    segment_size_ = segment_size;
+    if (dirs_.empty() || segment_num == 0 ||
+        segment_size_ < sizeof(LogSegmentHeader) + 2 * sizeof(uint64_t)) {
+      std::cout << "invalid log segment parameters." << std::endl;
+      ERR;
+    }
+
+    // remove segments which a previous run allocated beyond segment_num.
+    for (std::size_t i = segment_num;; ++i) {
+      std::string path = genPath(dirs_[(owner_ + i) % dirs_.size()], owner_, i);
+      if (::unlink(path.c_str()) != 0) break;
+    }
+
+    for (std::size_t i = 0; i < segment_num; ++i) free_.emplace_back(allocate());
+    cur_ = free_.front();
+    free_.pop_front();
+    start(cur_);
+
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().emplace_back(this);
+  }
+
+  /**
+   * @brief create spare segments of every log writer up to kSpareNum.
+   * @detail It is called by the leader or the maintenance thread, so that
+   * log writers don't create segments on their commit path.
+   * @return void
+   */
+  static void refillAll() {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (LogSegmentManager *manager : registry()) manager->refill();
+  }
+
+  /**
+   * @brief append one frame whose payload is given by iov.
+   * @param [in] iov payload pieces.
+   * @param [in] iovcnt the number of payload pieces.
+   * @param [in] epoch the largest epoch of log records in this payload.
+   * @return void
+   */
+  void write(const struct iovec *iov, int iovcnt, uint64_t epoch) {
+    uint64_t len = 0;
+    for (int i = 0; i < iovcnt; ++i) len += iov[i].iov_len;
+    if (sizeof(LogSegmentHeader) + len + 2 * sizeof(uint64_t) >
+        segment_size_) {
+      std::cout << "log frame is larger than log segment." << std::endl;
+      ERR;
+    }
+    if (segments_[cur_].used_ + len + 2 * sizeof(uint64_t) > segment_size_)
+      rotate();
+
+    static const uint64_t kEnd = 0;
+    std::vector<struct iovec> vec;
+    vec.reserve(iovcnt + 2);
+    vec.push_back({&len, sizeof(len)});
+    for (int i = 0; i < iovcnt; ++i) vec.push_back(iov[i]);
+    vec.push_back({const_cast<uint64_t *>(&kEnd), sizeof(kEnd)});
+
+    Segment &seg = segments_[cur_];
+    seg.file_->pwritev(&vec[0], vec.size(), seg.used_);
+    seg.used_ += sizeof(len) + len;
+    seg.max_epoch_ = std::max(seg.max_epoch_, epoch);
+  }
+
+  void fdatasync() {
+#ifdef Linux
+    segments_[cur_].file_->fdatasync();
+#else
+    segments_[cur_].file_->fsync();
+#endif  // Linux
+  }
+
+  /**
+   * @brief Segments whose largest epoch is less than this are reusable.
+   * @detail Without a call of this, no segment is recycled, so readAll() reads
+   * the whole log.
+   * @param [in] epoch checkpoint or durable epoch.
+   * @return void
+   */
+  void setReclaimEpoch(uint64_t epoch) { reclaim_epoch_ = epoch; }
+
+  /**
+   * @brief read valid frames of all segments of an owner in seq order.
+   * @param [in] dirs log directories.
+   * @param [in] owner id of the log writer.
+   * @param [in] segment_num the number of preallocated segments.
+   * @param [out] buf concatenated payloads.
+   * @return false if some segments are missing, i.e. seqs of the segments are
+   * not 1, 2, ..., n. The log can't be replayed then, e.g. because a
+   * segment was recycled.
+   */
+  static bool readAll(const std::vector<std::string> &dirs, uint64_t owner,
+                      std::size_t segment_num, std::vector<char> &buf) {
+    std::vector<std::pair<uint64_t, std::vector<char>>> segs;
+    for (std::size_t i = 0;; ++i) {
+      std::string path = genPath(dirs[(owner + i) % dirs.size()], owner, i);
+      struct stat st;
+      if (::stat(path.c_str(), &st) != 0) {
+        if (i >= segment_num) break;
+        continue;
+      }
+      std::vector<char> contents;
+      readAllFromFile(path, contents);
+      if (contents.size() < sizeof(LogSegmentHeader)) continue;
+      LogSegmentHeader hd;
+      memcpy(&hd, &contents[0], sizeof(hd));
+      if (hd.magic_ != LogSegmentHeader::kMagic || hd.owner_ != owner)
+        continue;
+      segs.emplace_back(hd.seq_, std::move(contents));
+    }
+    std::sort(segs.begin(), segs.end(),
+              [](const std::pair<uint64_t, std::vector<char>> &a,
+                 const std::pair<uint64_t, std::vector<char>> &b) {
+                return a.first < b.first;
+              });
+    for (std::size_t i = 0; i < segs.size(); ++i)
+      if (segs[i].first != i + 1) return false;
+
+    for (auto &seg : segs) {
+      std::vector<char> &contents = seg.second;
+      std::size_t pos = sizeof(LogSegmentHeader);
+      for (;;) {
+        uint64_t len;
+        if (pos + sizeof(len) > contents.size()) break;
+        memcpy(&len, &contents[pos], sizeof(len));
+        pos += sizeof(len);
+        if (len == 0 || pos + len > contents.size()) break;
+        buf.insert(buf.end(), &contents[pos], &contents[pos] + len);
+        pos += len;
+      }
+    }
+    return true;
+  }
+
+  static std::string genPath(const std::string &dir, uint64_t owner,
+                             std::size_t index) {
+    return dir + "/log" + std::to_string(owner) + "_" + std::to_string(index);
+  }
+
+ private:
+  static std::mutex &registryMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  // managers which refillAll() refills.
+  static std::vector<LogSegmentManager *> &registry() {
+    static std::vector<LogSegmentManager *> managers;
+    return managers;
+  }
+
+  /**
+   * @brief create a new segment file, fill it with zeros and sync it.
+   * @detail The zeros also invalidate the header which a previous run may
+   * have left. It may run on another thread than the owner.
+   * @param [out] seg the new segment.
+   * @return void
+   */
+  void create(Segment &seg) {
+    std::size_t index = next_index_.fetch_add(1, std::memory_order_relaxed);
+    seg.path_ = genPath(dirs_[(owner_ + index) % dirs_.size()], owner_, index);
+    seg.file_.reset(new File(seg.path_, O_CREAT | O_RDWR, 0644));
+    seg.file_->ftruncate(segment_size_);
+    seg.file_->fallocate(0, segment_size_);
+
+    static const std::vector<char> zeros(1 << 20, 0);
+    for (std::size_t off = 0; off < segment_size_; off += zeros.size()) {
+      struct iovec vec = {const_cast<char *>(&zeros[0]),
+                          std::min(zeros.size(), segment_size_ - off)};
+      seg.file_->pwritev(&vec, 1, off);
+    }
+#ifdef Linux
+    seg.file_->fdatasync();
+#else
+    seg.file_->fsync();
+#endif  // Linux
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief create a new segment on the caller.
+   * @return index of the new segment.
+   */
+  std::size_t allocate() {
+    segments_.emplace_back();
+    create(segments_.back());
+    return segments_.size() - 1;
+  }
+
+  void refill() {
+    for (;;) {
+      {
+        std::lock_guard<std::mutex> lock(spare_mutex_);
+        if (spares_.size() >= kSpareNum) return;
+      }
+      Segment seg;
+      create(seg);
+      std::lock_guard<std::mutex> lock(spare_mutex_);
+      spares_.emplace_back(std::move(seg));
+    }
+  }
+
+  /**
+   * @brief take a spare segment, or create one if there is none.
+   * @return index of the segment.
+   */
+  std::size_t takeSpare() {
+    {
+      std::lock_guard<std::mutex> lock(spare_mutex_);
+      if (!spares_.empty()) {
+        segments_.emplace_back(std::move(spares_.front()));
+        spares_.pop_front();
+        return segments_.size() - 1;
+      }
+    }
+    ++sync_allocations_;
+    return allocate();
+  }
+
+  /**
+   * @brief start to use the segment from its head.
+   * @param [in] index index of the segment.
+   * @return void
+   */
+  void start(std::size_t index) {
+    Segment &seg = segments_[index];
+    seg.seq_ = next_seq_++;
+    seg.max_epoch_ = 0;
+
+    LogSegmentHeader hd;
+    hd.owner_ = owner_;
+    hd.seq_ = seg.seq_;
+    hd.size_ = segment_size_;
+    static const uint64_t kEnd = 0;
+    struct iovec vec[2] = {{&hd, sizeof(hd)},
+                           {const_cast<uint64_t *>(&kEnd), sizeof(kEnd)}};
+    seg.file_->pwritev(vec, 2, 0);
+    seg.used_ = sizeof(hd);
+  }
+
+  void rotate() {
+    full_.emplace_back(cur_);
+    while (!full_.empty() &&
+           segments_[full_.front()].max_epoch_ < reclaim_epoch_) {
+      free_.emplace_back(full_.front());
+      full_.pop_front();
+      ++recycles_;
+    }
+
+    if (free_.empty()) {
+      cur_ = takeSpare();
+    } else {
+      cur_ = free_.front();
+      free_.pop_front();
+    }
+    start(cur_);
+    ++rotations_;
+  }
+};
+
+/**
+ * @brief split comma-separated log directories.
+ * @param [in] dirs comma-separated directories. Empty means ./log .
+ * @param [out] out directories.
+ * @return void
+ */
+inline void splitLogDirs(const std::string &dirs,
+                         std::vector<std::string> &out) {
+  out.clear();
+  std::size_t begin = 0;
+  while (begin <= dirs.size()) {
+    std::size_t end = dirs.find(',', begin);
+    if (end == std::string::npos) end = dirs.size();
+    if (end > begin) out.emplace_back(dirs.substr(begin, end - begin));
+    begin = end + 1;
+  }
+
+  if (out.empty()) {
+    std::string logpath;
+    genLogFileName(logpath, 0);
+    out.emplace_back(logpath.substr(0, logpath.rfind('/')));
+  }
+}
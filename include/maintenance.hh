@@ -0,0 +1,120 @@
+#pragma once
+
+#include <x86intrin.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "tsc.hh"
+
+/**
+ * @brief Statistics of a periodic maintenance task, that is, advancement of
+ * an epoch or a GC watermark.
+ * @detail An advancement is due period after the previous one. It is on time
+ * if it happens before the next one is due. lag is the time from the due to
+ * the advancement.
+ */
+class MaintenanceStat {
+ public:
+  uint64_t advances_ = 0;
+  uint64_t on_time_ = 0;
+  uint64_t lag_sum_ = 0;  // [clocks]
+  uint64_t lag_max_ = 0;  // [clocks]
+  uint64_t last_ = 0;     // time of the previous advancement [clocks]
+
+  /**
+   * @brief record an advancement.
+   * @param [in] now time of the advancement [clocks].
+   * @param [in] period interval of advancements [clocks].
+   * @return void
+   */
+  void record(uint64_t now, uint64_t period) {
+    if (last_ != 0) {
+      uint64_t lag = 0;
+      if (now > last_ + period) lag = now - last_ - period;
+      ++advances_;
+      if (lag <= period) ++on_time_;
+      lag_sum_ += lag;
+      if (lag > lag_max_) lag_max_ = lag;
+    }
+    last_ = now;
+  }
+
+  void display(const std::string &name, std::size_t clocks_per_us) {
+    std::cout << name << "_advances:\t" << advances_ << std::endl;
+    if (advances_ == 0) return;
+    std::cout << std::fixed << std::setprecision(4) << name
+              << "_on_time_rate:\t"
+              << (long double)on_time_ / (long double)advances_ << std::endl;
+    std::cout << name << "_lag_avg[us]:\t"
+              << (long double)lag_sum_ / (long double)advances_ /
+                     (long double)clocks_per_us
+              << std::endl;
+    std::cout << name << "_lag_max[us]:\t" << lag_max_ / clocks_per_us
+              << std::endl;
+  }
+};
+
+/**
+ * @brief Dedicated thread which runs maintenance work (epoch advancement and
+ * GC watermark computation) at every tick, instead of a worker thread doing it
+ * between its transactions.
+ * @detail Ticks are on absolute deadlines, so they don't drift. It sleeps for
+ * most of a tick and spins for the rest to wake up precisely.
+ */
+class MaintenanceThread {
+ public:
+  static constexpr uint64_t kSpinUs = 50;
+
+  std::thread thread_;
+  std::atomic<bool> quit_{false};
+  uint64_t ticks_ = 0;
+  uint64_t overruns_ = 0;  // work took longer than a tick.
+
+  /**
+   * @brief start to call work at every tick.
+   * @param [in] tick_us interval of ticks [us].
+   * @param [in] clocks_per_us CPU clocks per us.
+   * @param [in] work callable which does maintenance once.
+   * @return void
+   */
+  template <typename Work>
+  void start(uint64_t tick_us, std::size_t clocks_per_us, Work work) {
+    thread_ = std::thread([this, tick_us, clocks_per_us, work]() mutable {
+      const uint64_t tick = tick_us * clocks_per_us;
+      uint64_t next = rdtscp();
+      while (!quit_.load(std::memory_order_acquire)) {
+        work();
+        ++ticks_;
+
+        next += tick;
+        uint64_t now = rdtscp();
+        if (now >= next) {
+          ++overruns_;
+          next = now;
+          continue;
+        }
+        uint64_t rest_us = (next - now) / clocks_per_us;
+        if (rest_us > kSpinUs)
+          std::this_thread::sleep_for(
+              std::chrono::microseconds(rest_us - kSpinUs));
+        while (rdtscp() < next) _mm_pause();
+      }
+    });
+  }
+
+  void stop() {
+    quit_.store(true, std::memory_order_release);
+    if (thread_.joinable()) thread_.join();
+  }
+
+  void display() {
+    std::cout << "maintenance_ticks:\t" << ticks_ << std::endl;
+    std::cout << "maintenance_overruns:\t" << overruns_ << std::endl;
+  }
+};
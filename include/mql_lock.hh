@@ -1,42 +1,194 @@
+#pragma once
+
+#include <xmmintrin.h>
+
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "cache_line_size.hh"
+
+/**
+ * @brief MQL lock, reader-writer queue lock with cancellation.
+ * @detail Tianzheng Wang, Milind Chabbi, and Hideaki Kimura. 2016. Be my
+ * guest: MCS lock now welcomes guests. PPoPP '16. A waiter can leave the queue
+ * (trylock), which MOCC needs to avoid deadlocks in non-canonical mode.
+ * Queue nodes live in a global pool (MQLNodePool) and are identified by its
+ * index, so that tail, prev and next are 32 bits.
+ */
+
+enum class SentinelValue : uint32_t {
+  None = 0,
+  Acquired,          // 1
+  SuccessorLeaving,  // 2
+  // the successor was granted by itself, so it needs nothing from me.
+  NoSuccessor,  // 3
+};
+// id of a queue node. ids less than this are sentinel values.
+#define MQL_NODE_ID_BASE 4
+
+enum class LockMode : uint8_t { None, Reader, Writer };
+
+enum class LockStatus : uint8_t { Waiting, Granted, Leaving };
+
+enum class MQL_RESULT : uint8_t { Acquired, Cancelled };
+
+struct MQLMetaInfo {
+  union {
+    uint64_t obj;
+    struct {
+      bool busy : 1;          // 0 == not busy, 1 == busy;
+      LockMode stype : 8;     // 0 == none, 1 == reader, 2 == writer
+      LockStatus status : 8;  // 0 == waiting, 1 == granted, 2 == leaving
+      uint32_t next : 32;     // id of the successor's queue node.
+    };
+  };
+
+  void init(bool busy, LockMode stype, LockStatus status, uint32_t next);
+  bool atomicLoadBusy();
+  LockMode atomicLoadStype();
+  LockStatus atomicLoadStatus();
+  uint32_t atomicLoadNext();
+  void atomicStoreBusy(bool newbusy);
+  void atomicStoreStype(LockMode newlockmode);
+  void atomicStoreStatus(LockStatus newstatus);
+  void atomicStoreNext(uint32_t newnext);
+  bool atomicCASNext(uint32_t oldnext, uint32_t newnext);
+};
+
+/**
+ * @brief Queue node of MQL lock.
+ * @detail Each thread owns a small pool of queue nodes. A node is taken from
+ * the pool when its owner starts to acquire a lock, and is returned when the
+ * lock is released or the acquisition is cancelled. So the pool needs one
+ * node per lock which a transaction holds at a time, not one per record.
+ * Nodes are identified by uint32_t id (index of the global pool), and prev,
+ * next and tail hold those ids.
+ */
+class alignas(CACHE_LINE_SIZE) MQLNode {
+ public:
+  // record which this node is queued on. it is for debugging.
+  uint64_t key_;
+  // interact with predecessor
+  std::atomic<LockMode> type;
+  std::atomic<uint32_t> prev;
+  std::atomic<bool> granted;
+  // -----
+  // interact with successor
+  MQLMetaInfo sucInfo;
+  // -----
+  //
+  MQLNode() {
+    this->key_ = 0;
+    this->type = LockMode::None;
+    this->prev = (uint32_t)SentinelValue::None;
+    this->granted = false;
+    sucInfo.init(false, LockMode::None, LockStatus::Waiting,
+                 (uint32_t)SentinelValue::None);
+  }
 
-#include "include/common.hh"
-#include "include/lock.hh"
+  void init(LockMode type, uint32_t prev, bool granted, bool busy,
+            LockMode stype, LockStatus status, uint32_t next) {
+    this->type = type;
+    this->prev = prev;
+    this->granted = granted;
+    sucInfo.init(busy, stype, status, next);
+  }
 
-#define xchg(...) __atomic_exchange_n(__VA_ARGS__)
-#define cas(...) __atomic_compare_exchange_n(__VA_ARGS__)
-#define atoload(arg) __atomic_load_n(arg, __ATOMIC_ACQUIRE)
-#define atostore(...) __atomic_store_n(__VA_ARGS__)
+  MQLMetaInfo atomicLoadSucInfo();
+  bool atomicCASSucInfo(MQLMetaInfo expected, MQLMetaInfo desired);
+};
+
+class MQLock {
+ public:
+  std::atomic<unsigned int> nreaders;
+  std::atomic<uint32_t> tail;
+  std::atomic<uint32_t> next_writer;
+  // a writer holds this lock. optimistic readers check it.
+  std::atomic<bool> wlocked;
+
+  MQLock() {
+    nreaders = 0;
+    tail = 0;
+    next_writer = 0;
+    wlocked = false;
+  }
 
-#define SPIN 2400
+  bool ldAcqWlocked() { return wlocked.load(std::memory_order_acquire); }
+
+  MQL_RESULT acquire_reader_lock(uint32_t me, unsigned int key, bool trylock);
+  MQL_RESULT acquire_writer_lock(uint32_t me, unsigned int key, bool trylock);
+  MQL_RESULT acquire_reader_lock_check_reader_pred(uint32_t me,
+                                                   unsigned int key,
+                                                   uint32_t pred, bool trylock);
+  MQL_RESULT acquire_reader_lock_check_writer_pred(uint32_t me,
+                                                   unsigned int key,
+                                                   uint32_t pred, bool trylock);
+
+  MQL_RESULT cancel_reader_lock(uint32_t me, unsigned int key);
+  MQL_RESULT cancel_reader_lock_relink(uint32_t pred, uint32_t me,
+                                       unsigned int key);
+  MQL_RESULT cancel_reader_lock_with_reader_pred(uint32_t me, unsigned int key,
+                                                 uint32_t pred);
+  MQL_RESULT cancel_reader_lock_with_writer_pred(uint32_t me, unsigned int key,
+                                                 uint32_t pred);
+  MQL_RESULT cancel_writer_lock(uint32_t me, unsigned int key);
+  MQL_RESULT cancel_writer_lock_no_pred(uint32_t me, unsigned int key);
+
+  void release_reader_lock(uint32_t me, unsigned int key);
+  void release_writer_lock(uint32_t me, unsigned int key);
+
+  MQL_RESULT finish_acquire_reader_lock(uint32_t me, unsigned int key);
+  void finish_release_reader_lock(uint32_t me, unsigned int key);
+};
+
+/**
+ * @brief Global pool of MQL queue nodes.
+ * @detail Index is the id of the queue node. Index 0, 1, 2 and 3 are dummies
+ * for sentinel values (None, Acquired, SuccessorLeaving, NoSuccessor). Owners of ids are decided
+ * by the user of the pool, e.g. each thread owns a fixed range of ids.
+ */
+alignas(CACHE_LINE_SIZE) inline MQLNode *MQLNodePool = nullptr;
+inline std::size_t MQLNodePoolSize = 0;
+
+/**
+ * @brief allocate the global pool of MQL queue nodes.
+ * @param [in] num the number of queue nodes except sentinels.
+ * @return void
+ */
+inline void initMQLNodePool(std::size_t num) {
+  MQLNodePoolSize = MQL_NODE_ID_BASE + num;
+  MQLNodePool = new MQLNode[MQLNodePoolSize];
+}
 
-#ifdef MQLOCK
-MQLMetaInfo MQLNode::atomicLoadSucInfo() {
+inline MQLMetaInfo MQLNode::atomicLoadSucInfo() {
   MQLMetaInfo load;
   load.obj = __atomic_load_n(&sucInfo.obj, __ATOMIC_ACQUIRE);
   return load;
 }
 
-bool MQLNode::atomicCASSucInfo(MQLMetaInfo expected, MQLMetaInfo desired) {
+inline bool MQLNode::atomicCASSucInfo(MQLMetaInfo expected, MQLMetaInfo desired) {
   return __atomic_compare_exchange_n(&sucInfo.obj, &expected.obj, desired.obj,
                                      false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
 }
 
-void MQLMetaInfo::init(bool busy, LockMode stype, LockStatus status,
-                       uint32_t next) {
+inline void MQLMetaInfo::init(bool busy, LockMode stype, LockStatus status,
+                              uint32_t next) {
+  // clear the padding bits too, because CAS compares the whole obj.
+  this->obj = 0;
   this->busy = busy;
   this->stype = stype;
   this->status = status;
   this->next = next;
 }
 
-bool MQLMetaInfo::atomicLoadBusy() {
+inline bool MQLMetaInfo::atomicLoadBusy() {
   MQLMetaInfo expected;
   expected.obj = __atomic_load_n(&obj, __ATOMIC_ACQUIRE);
   return expected.busy;
 }
 
-void MQLMetaInfo::atomicStoreBusy(bool newbusy) {
+inline void MQLMetaInfo::atomicStoreBusy(bool newbusy) {
   MQLMetaInfo expected, desired;
   expected.obj = __atomic_load_n(&obj, __ATOMIC_ACQUIRE);
   for (;;) {
@@ -48,13 +200,13 @@ void MQLMetaInfo::atomicStoreBusy(bool newbusy) {
   }
 }
 
-LockMode MQLMetaInfo::atomicLoadStype() {
+inline LockMode MQLMetaInfo::atomicLoadStype() {
   MQLMetaInfo expected;
   expected.obj = __atomic_load_n(&obj, __ATOMIC_ACQUIRE);
   return expected.stype;
 }
 
-void MQLMetaInfo::atomicStoreStype(LockMode newlockmode) {
+inline void MQLMetaInfo::atomicStoreStype(LockMode newlockmode) {
   MQLMetaInfo expected, desired;
   expected.obj = __atomic_load_n(&obj, __ATOMIC_ACQUIRE);
   for (;;) {
@@ -66,13 +218,13 @@ void MQLMetaInfo::atomicStoreStype(LockMode newlockmode) {
   }
 }
 
-LockStatus MQLMetaInfo::atomicLoadStatus() {
+inline LockStatus MQLMetaInfo::atomicLoadStatus() {
   MQLMetaInfo expected;
   expected.obj = __atomic_load_n(&obj, __ATOMIC_ACQUIRE);
   return expected.status;
 }
 
-void MQLMetaInfo::atomicStoreStatus(LockStatus newstatus) {
+inline void MQLMetaInfo::atomicStoreStatus(LockStatus newstatus) {
   MQLMetaInfo expected, desired;
   expected.obj = __atomic_load_n(&obj, __ATOMIC_ACQUIRE);
   for (;;) {
@@ -84,13 +236,13 @@ void MQLMetaInfo::atomicStoreStatus(LockStatus newstatus) {
   }
 }
 
-uint32_t MQLMetaInfo::atomicLoadNext() {
+inline uint32_t MQLMetaInfo::atomicLoadNext() {
   MQLMetaInfo expected;
   expected.obj = __atomic_load_n(&obj, __ATOMIC_ACQUIRE);
   return expected.next;
 }
 
-void MQLMetaInfo::atomicStoreNext(uint32_t newnext) {
+inline void MQLMetaInfo::atomicStoreNext(uint32_t newnext) {
   MQLMetaInfo expected, desired;
   expected.obj = __atomic_load_n(&obj, __ATOMIC_ACQUIRE);
   for (;;) {
@@ -102,7 +254,7 @@ void MQLMetaInfo::atomicStoreNext(uint32_t newnext) {
   }
 }
 
-bool MQLMetaInfo::atomicCASNext(uint32_t oldnext, uint32_t newnext) {
+inline bool MQLMetaInfo::atomicCASNext(uint32_t oldnext, uint32_t newnext) {
   MQLMetaInfo expected, desired;
   expected.obj = __atomic_load_n(&obj, __ATOMIC_ACQUIRE);
   expected.next = oldnext;
@@ -112,12 +264,13 @@ bool MQLMetaInfo::atomicCASNext(uint32_t oldnext, uint32_t newnext) {
                                      __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
 }
 
-MQL_RESULT
+inline MQL_RESULT
 MQLock::acquire_reader_lock(uint32_t me, unsigned int key, bool trylock) {
-  MQLNode *qnode = &MQLNodeTable[me][key];
+  MQLNode *qnode = &MQLNodePool[me];
   qnode->init(LockMode::Reader, (uint32_t)SentinelValue::None, false, false,
               LockMode::None, LockStatus::Waiting,
               (uint32_t)SentinelValue::None);
+  qnode->key_ = key;
 
   uint32_t p = tail.exchange(me);
   if (p == (uint32_t)SentinelValue::None) {
@@ -126,16 +279,17 @@ MQLock::acquire_reader_lock(uint32_t me, unsigned int key, bool trylock) {
     return finish_acquire_reader_lock(me, key);
   }
 
-  MQLNode *pred = &MQLNodeTable[p][key];
+  MQLNode *pred = &MQLNodePool[p];
   // haven't set pred.next.id yet, safe to dereference pred
   if (pred->type.load(std::memory_order_acquire) == LockMode::Reader)
     return acquire_reader_lock_check_reader_pred(me, key, p, trylock);
   return acquire_reader_lock_check_writer_pred(me, key, p, trylock);
 }
 
-MQL_RESULT
-MQLock::finish_acquire_reader_lock(uint32_t me, unsigned int key) {
-  MQLNode *qnode = &MQLNodeTable[me][key];
+inline MQL_RESULT
+MQLock::finish_acquire_reader_lock(uint32_t me,
+                                   [[maybe_unused]] unsigned int key) {
+  MQLNode *qnode = &MQLNodePool[me];
   qnode->sucInfo.atomicStoreBusy(true);
   qnode->sucInfo.atomicStoreStatus(LockStatus::Granted);
 
@@ -156,8 +310,9 @@ MQLock::finish_acquire_reader_lock(uint32_t me, unsigned int key) {
     ;
 
   uint32_t sucnum = qnode->sucInfo.atomicLoadNext();
-  MQLNode *suc = &MQLNodeTable[sucnum][key];
+  MQLNode *suc = &MQLNodePool[sucnum];
   if (sucnum == (uint32_t)SentinelValue::None ||
+      sucnum == (uint32_t)SentinelValue::NoSuccessor ||
       suc->type.load(std::memory_order_acquire) == LockMode::Writer) {
     qnode->sucInfo.atomicStoreBusy(false);
     return MQL_RESULT::Acquired;
@@ -192,7 +347,7 @@ MQLock::finish_acquire_reader_lock(uint32_t me, unsigned int key) {
     nreaders++;
     suc->granted.store(true, std::memory_order_release);
     // make sure I know when releasing no need to wait
-    qnode->sucInfo.atomicStoreNext((uint32_t)SentinelValue::None);
+    qnode->sucInfo.atomicStoreNext((uint32_t)SentinelValue::NoSuccessor);
   } else if (qnode->sucInfo.atomicLoadStype() == LockMode::Reader) {
     for (;;) {
       while (suc->prev.load(std::memory_order_acquire) == me)
@@ -202,7 +357,7 @@ MQLock::finish_acquire_reader_lock(uint32_t me, unsigned int key) {
               std::memory_order_acquire)) {
         nreaders++;
         suc->granted.store(true, std::memory_order_release);
-        qnode->sucInfo.atomicStoreNext((uint32_t)SentinelValue::None);
+        qnode->sucInfo.atomicStoreNext((uint32_t)SentinelValue::NoSuccessor);
         break;
       }
     }
@@ -212,13 +367,13 @@ MQLock::finish_acquire_reader_lock(uint32_t me, unsigned int key) {
   return MQL_RESULT::Acquired;
 }
 
-MQL_RESULT
+inline MQL_RESULT
 MQLock::acquire_reader_lock_check_reader_pred(uint32_t me, unsigned int key,
                                               uint32_t pred, bool trylock) {
 check_pred:
   uint32_t pretail;
-  MQLNode *qnode = &MQLNodeTable[me][key];
-  MQLNode *p = &MQLNodeTable[pred][key];
+  MQLNode *qnode = &MQLNodePool[me];
+  MQLNode *p = &MQLNodePool[pred];
   // wait for the previous canceling dude to leave
   while (!(p->sucInfo.atomicLoadNext() == (uint32_t)SentinelValue::None &&
            p->sucInfo.atomicLoadStype() == LockMode::None))
@@ -228,14 +383,17 @@ check_pred:
   expected.init(false, LockMode::None, LockStatus::Waiting,
                 (uint32_t)SentinelValue::None);
   desired.init(false, LockMode::Reader, LockStatus::Waiting, me);
-  __atomic_compare_exchange_n(&(p->sucInfo.obj), &expected.obj, desired.obj,
-                              false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
-
-  if (p->sucInfo.atomicLoadBusy() == false &&
-      p->sucInfo.atomicLoadStype() == LockMode::Reader &&
-      p->sucInfo.atomicLoadStatus() == LockStatus::Waiting) {  // succeeded
+  // decide by the result of the CAS. pred may be granted right after it, and
+  // then I'm still its registered successor.
+  if (p->atomicCASSucInfo(expected, desired)) {  // succeeded
     // link_pred(pred, me)
     p->sucInfo.atomicStoreNext(me);
+    // pred waits for my prev to hand the lock over.
+    if (qnode->prev.exchange(pred) == (uint32_t)SentinelValue::Acquired) {
+      while (qnode->granted.load(std::memory_order_acquire) != true)
+        ;
+      return finish_acquire_reader_lock(me, key);
+    }
 
     // if me.granted becomes True before timing out
     //    return finish_reader_acquire
@@ -261,7 +419,7 @@ check_pred:
     // if pred did cancel, it will give me a new pred;
     // if it got the lock it will wake me up
     qnode->prev.store(pred, std::memory_order_release);
-    while (qnode->prev.load(std::memory_order_acquire) != pred)
+    while (qnode->prev.load(std::memory_order_acquire) == pred)
       ;
     // consume it and retry
     pretail = qnode->prev.exchange((uint32_t)SentinelValue::None);
@@ -270,7 +428,7 @@ check_pred:
         ;
       return finish_acquire_reader_lock(me, key);
     }
-    p = &MQLNodeTable[pretail][key];
+    p = &MQLNodePool[pretail];
     if (p->type.load(std::memory_order_acquire) == LockMode::Writer)
       return acquire_reader_lock_check_writer_pred(me, key, pretail, trylock);
     pred = pretail;
@@ -280,20 +438,19 @@ check_pred:
     // I didn't register, pred won't wake me up, but if pred is leaving_granted,
     // we need to tell it not to poke me in its finish-acquire call.
     // For direct_granted,
-    // also set its next.id to None so it knows that there's no need to wait and
-    // examine successor upon release. This also covers the
+    // also set its next.id to NoSuccessor so it knows that there's no need to
+    // wait and examine successor upon release. This also covers the
     // case when pred.next.flags has Busy set.
-    p->sucInfo.atomicStoreNext((uint32_t)SentinelValue::None);
+    p->sucInfo.atomicStoreNext((uint32_t)SentinelValue::NoSuccessor);
     nreaders++;
     qnode->granted.store(true, std::memory_order_release);
     return finish_acquire_reader_lock(me, key);
   }
 }
 
-MQL_RESULT
+inline MQL_RESULT
 MQLock::cancel_reader_lock(uint32_t me, unsigned int key) {
-  NNN;
-  MQLNode *qnode = &MQLNodeTable[me][key];
+  MQLNode *qnode = &MQLNodePool[me];
   uint32_t pred = qnode->prev.exchange((uint32_t)SentinelValue::None);
   // prevent from cancelling
 
@@ -311,20 +468,19 @@ MQLock::cancel_reader_lock(uint32_t me, unsigned int key) {
 
   // pred not equal qnode->prev.
   // この関数冒頭で exchange しているから．
-  if (MQLNodeTable[pred][key].type.load(std::memory_order_acquire) ==
+  if (MQLNodePool[pred].type.load(std::memory_order_acquire) ==
       LockMode::Reader) {
     return cancel_reader_lock_with_reader_pred(me, key, pred);
   }
   return cancel_reader_lock_with_writer_pred(me, key, pred);
 }
 
-MQL_RESULT
+inline MQL_RESULT
 MQLock::cancel_reader_lock_with_writer_pred(uint32_t me, unsigned int key,
                                             uint32_t pred) {
-  NNN;
 retry:
-  MQLNode *qnode = &MQLNodeTable[me][key];
-  MQLNode *p = &MQLNodeTable[pred][key];
+  MQLNode *qnode = &MQLNodePool[me];
+  MQLNode *p = &MQLNodePool[pred];
   // wait for the cancelling pred to finish relink
   // spin until pred.next is me and pred.stype is Reader
   // pred is a writer, so I can go as long as it's not also leaving (cancelling
@@ -337,7 +493,7 @@ retry:
       // pred should give me a new pred, after its CAS trying to pass me the
       // lock failed
       qnode->prev.store(pred, std::memory_order_release);
-      while (qnode->prev.load(std::memory_order_acquire) != pred)
+      while (qnode->prev.load(std::memory_order_acquire) == pred)
         ;
       pred = qnode->prev.exchange((uint32_t)SentinelValue::None);
       if (pred == (uint32_t)SentinelValue::None ||
@@ -352,7 +508,7 @@ retry:
                (uint32_t)SentinelValue::SuccessorLeaving)
           ;
         // (tanabe) pred may be changed to new value at L:340
-        p = &MQLNodeTable[pred][key];
+        p = &MQLNodePool[pred];
         if (p->type.load(std::memory_order_acquire) == LockMode::Reader)
           // (tanabe) if it gets new reader pred, it executes cancel for reader
           return cancel_reader_lock_with_reader_pred(me, key, pred);
@@ -366,7 +522,7 @@ retry:
       return finish_acquire_reader_lock(me, key);
     }
     // try to tell pred I'm leaving
-    p = &MQLNodeTable[pred][key];
+    p = &MQLNodePool[pred];
     MQLMetaInfo expected, desired;
     expected = eflags;
     expected.next = me;
@@ -377,10 +533,11 @@ retry:
 
   // pred now has SuccessorLeaving on its next.id, it won't try to wake me up
   // during release now link the new successor and pred
+  uint32_t localme = me;
   if (qnode->sucInfo.atomicLoadNext() == (uint32_t)SentinelValue::None &&
-      tail.compare_exchange_strong(me, pred, std::memory_order_acq_rel,
+      tail.compare_exchange_strong(localme, pred, std::memory_order_acq_rel,
                                    std::memory_order_acquire)) {
-    p = &MQLNodeTable[pred][key];
+    p = &MQLNodePool[pred];
     p->sucInfo.atomicStoreStype(LockMode::None);
     p->sucInfo.atomicStoreNext((uint32_t)SentinelValue::None);
     return MQL_RESULT::Cancelled;
@@ -390,13 +547,12 @@ retry:
   return MQL_RESULT::Cancelled;
 }
 
-MQL_RESULT
+inline MQL_RESULT
 MQLock::cancel_reader_lock_with_reader_pred(uint32_t me, unsigned int key,
                                             uint32_t pred) {
-  NNN;
 retry:
-  MQLNode *qnode = &MQLNodeTable[me][key];
-  MQLNode *p = &MQLNodeTable[pred][key];
+  MQLNode *qnode = &MQLNodePool[me];
+  MQLNode *p = &MQLNodePool[pred];
   // now successor can't attach to me assuming I'm waiting or has already done
   // so. CAS out of pred.next (including id and flags) wait for the canceling
   // pred to finish the relink spin until pred.stype is Reader and (pred.next is
@@ -424,7 +580,7 @@ retry:
       // pred has higher priority to leave, and it should already have me on its
       // next.id
       qnode->prev.store(pred, std::memory_order_release);
-      while (qnode->prev.load(std::memory_order_acquire) != pred)
+      while (qnode->prev.load(std::memory_order_acquire) == pred)
         ;
       // consume it and retry
       pred = qnode->prev.exchange((uint32_t)SentinelValue::None);
@@ -433,7 +589,7 @@ retry:
           ;
         return finish_acquire_reader_lock(me, key);
       }
-      MQLNode *p = &MQLNodeTable[pred][key];
+      MQLNode *p = &MQLNodePool[pred];
       if (p->type.load(std::memory_order_acquire) == LockMode::Writer)
         return cancel_reader_lock_with_writer_pred(me, key, pred);
       goto retry;
@@ -441,8 +597,9 @@ retry:
   } else {
     // at this point pred will be waiting for a new successor if it decides
     // to move and successor will be waiting for a new pred
+    uint32_t localme = me;
     if (qnode->sucInfo.atomicLoadStype() == LockMode::None &&
-        tail.compare_exchange_strong(me, pred, std::memory_order_acq_rel,
+        tail.compare_exchange_strong(localme, pred, std::memory_order_acq_rel,
                                      std::memory_order_acquire)) {
       // newly arriving successor for this pred will wait
       // for the SuccessorLeaving mark to go away before trying the CAS
@@ -455,12 +612,11 @@ retry:
   return MQL_RESULT::Cancelled;
 }
 
-MQL_RESULT
+inline MQL_RESULT
 MQLock::cancel_reader_lock_relink(uint32_t pred, uint32_t me,
-                                  unsigned int key) {
-  NNN;
-  MQLNode *qnode = &MQLNodeTable[me][key];
-  MQLNode *p = &MQLNodeTable[pred][key];
+                                  [[maybe_unused]] unsigned int key) {
+  MQLNode *qnode = &MQLNodePool[me];
+  MQLNode *p = &MQLNodePool[pred];
   while (qnode->sucInfo.atomicLoadNext() == (uint32_t)SentinelValue::None)
     ;
   for (;;) {  // preserve pred.flags
@@ -469,14 +625,13 @@ MQLock::cancel_reader_lock_relink(uint32_t pred, uint32_t me,
     desired = expected;
     desired.next = qnode->sucInfo.atomicLoadNext();
     desired.stype = qnode->sucInfo.atomicLoadStype();
-    desired.busy = qnode->sucInfo.atomicLoadBusy();
     if (p->atomicCASSucInfo(expected, desired)) break;
   }
 
   // I believe we should do this after setting pred.id, see the comment in
   // cancel_writer_lock. retry untill CAS(me,next.prev, me, pred) is True
   for (;;) {
-    MQLNode *suc = &MQLNodeTable[qnode->sucInfo.atomicLoadNext()][key];
+    MQLNode *suc = &MQLNodePool[qnode->sucInfo.atomicLoadNext()];
     uint32_t expected = me;
     if (suc->prev.compare_exchange_strong(expected, pred,
                                           std::memory_order_acq_rel,
@@ -486,14 +641,14 @@ MQLock::cancel_reader_lock_relink(uint32_t pred, uint32_t me,
   return MQL_RESULT::Cancelled;
 }
 
-MQL_RESULT
+inline MQL_RESULT
 MQLock::acquire_reader_lock_check_writer_pred(uint32_t me, unsigned int key,
                                               uint32_t pred, bool trylock) {
   // wait for the previous canceling dude to leave spin
   // until pred.next is NULL and pred.stype is None
   // pred is a writer, we have to wait anyway, so register and wait with timeout
-  MQLNode *qnode = &MQLNodeTable[me][key];
-  MQLNode *p = &MQLNodeTable[pred][key];
+  MQLNode *qnode = &MQLNodePool[me];
+  MQLNode *p = &MQLNodePool[pred];
   p->sucInfo.atomicStoreStype(LockMode::Reader);
   p->sucInfo.atomicStoreNext(me);
   if (qnode->prev.exchange(pred) == (uint32_t)SentinelValue::Acquired) {
@@ -514,10 +669,10 @@ MQLock::acquire_reader_lock_check_writer_pred(uint32_t me, unsigned int key,
   }
 }
 
-void MQLock::release_reader_lock(uint32_t me, unsigned int key) {
+inline void MQLock::release_reader_lock(uint32_t me, unsigned int key) {
   // make sure successor can't leave; readers, however, can still get the lock
   // as usual by seeing me.next.flags.granted set
-  MQLNode *qnode = &MQLNodeTable[me][key];
+  MQLNode *qnode = &MQLNodePool[me];
   qnode->sucInfo.atomicStoreBusy(true);
   while (qnode->sucInfo.atomicLoadNext() ==
          (uint32_t)SentinelValue::SuccessorLeaving)
@@ -531,16 +686,17 @@ void MQLock::release_reader_lock(uint32_t me, unsigned int key) {
                                      std::memory_order_acquire)) {
       return finish_release_reader_lock(me, key);
     }
-    printf("th %d : rl rl %d : next %d tail %d\n", me, key,
-           qnode->sucInfo.atomicLoadNext(), tail.load());
+    _mm_pause();
   }
 
   if (qnode->sucInfo.atomicLoadNext() != (uint32_t)SentinelValue::None &&
+      qnode->sucInfo.atomicLoadNext() !=
+          (uint32_t)SentinelValue::NoSuccessor &&
       qnode->sucInfo.atomicLoadStype() == LockMode::Writer) {
     // put it in next_writer
     next_writer = (uint32_t)qnode->sucInfo.atomicLoadNext();
     // also tell successor it doesn't have pred any more
-    MQLNode *suc = &MQLNodeTable[next_writer][key];
+    MQLNode *suc = &MQLNodePool[next_writer];
     expected = me;
     while (!suc->prev.compare_exchange_strong(
         expected, (uint32_t)SentinelValue::None, std::memory_order_acq_rel,
@@ -552,7 +708,8 @@ void MQLock::release_reader_lock(uint32_t me, unsigned int key) {
   return finish_release_reader_lock(me, key);
 }
 
-void MQLock::finish_release_reader_lock(uint32_t me, unsigned int key) {
+inline void MQLock::finish_release_reader_lock([[maybe_unused]] uint32_t me,
+                                        [[maybe_unused]] unsigned int key) {
   if (nreaders.fetch_sub(1) == 1) {
     // I'm the last reader, must handle the next writer.
     uint32_t nw = next_writer;
@@ -563,25 +720,26 @@ void MQLock::finish_release_reader_lock(uint32_t me, unsigned int key) {
                                             std::memory_order_acquire)) {
       for (;;) {
         uint32_t expected = (uint32_t)SentinelValue::None;
-        if (MQLNodeTable[nw][key].prev.compare_exchange_strong(
+        if (MQLNodePool[nw].prev.compare_exchange_strong(
                 expected, (uint32_t)SentinelValue::Acquired,
                 std::memory_order_acq_rel, std::memory_order_acquire))
           break;
       }
-      MQLNodeTable[nw][key].granted.store(true, std::memory_order_release);
+      MQLNodePool[nw].granted.store(true, std::memory_order_release);
     }
   }
 }
 
-MQL_RESULT
+inline MQL_RESULT
 MQLock::acquire_writer_lock(uint32_t me, unsigned int key, bool trylock) {
-  MQLNode *qnode = &MQLNodeTable[me][key];
+  MQLNode *qnode = &MQLNodePool[me];
   qnode->init(LockMode::Writer, (uint32_t)SentinelValue::None, false, false,
               LockMode::None, LockStatus::Waiting,
               (uint32_t)SentinelValue::None);
+  qnode->key_ = key;
 
   uint32_t pred = tail.exchange(me);
-  MQLNode *p = &MQLNodeTable[pred][key];
+  MQLNode *p = &MQLNodePool[pred];
   if (pred == (uint32_t)SentinelValue::None) {
     next_writer.store(me, std::memory_order_release);
     if (nreaders.load(std::memory_order_acquire) == 0 &&
@@ -590,14 +748,12 @@ MQLock::acquire_writer_lock(uint32_t me, unsigned int key, bool trylock) {
       return MQL_RESULT::Acquired;
     }
   } else {
-    // MQLNode *p = &MQLNodeTable[pred][key];
+    // MQLNode *p = &MQLNodePool[pred];
     // spin until pred.stype is None and pred.next is NULL
     while (!(p->sucInfo.atomicLoadStype() == LockMode::None &&
              p->sucInfo.atomicLoadNext() == (uint32_t)SentinelValue::None)) {
-      printf("th %d : aq wl %d : p->stype %d p->next %d\n", me, key,
-             (int)p->sucInfo.atomicLoadStype(), p->sucInfo.atomicLoadNext());
+      _mm_pause();
     }
-    // printf("th %d : acquire wl %d\n", me, key);
     // register on pred.flags as a writer successor,
     // then fill in pred.next.id and wait
     // must register on pred.flags first
@@ -624,14 +780,15 @@ MQLock::acquire_writer_lock(uint32_t me, unsigned int key, bool trylock) {
   }
 
   while (qnode->granted.load(std::memory_order_acquire) != true) {
-    printf("th %d : aq wl %d : infinite roop, pred %d\n", me, key, pred);
+    _mm_pause();
   }
   qnode->sucInfo.atomicStoreStatus(LockStatus::Granted);
   return MQL_RESULT::Acquired;
 }
 
-void MQLock::release_writer_lock(uint32_t me, unsigned int key) {
-  MQLNode *qnode = &MQLNodeTable[me][key];
+inline void MQLock::release_writer_lock(uint32_t me,
+                                       [[maybe_unused]] unsigned int key) {
+  MQLNode *qnode = &MQLNodePool[me];
   qnode->sucInfo.atomicStoreBusy(true);
   // make sure successor can't leave
   while (qnode->sucInfo.atomicLoadNext() ==
@@ -639,7 +796,6 @@ void MQLock::release_writer_lock(uint32_t me, unsigned int key) {
     ;
 
   while (qnode->sucInfo.atomicLoadNext() == (uint32_t)SentinelValue::None) {
-    // printf("th %d : release wl %d\n", me, key);
     uint32_t expected, desired;
     expected = me;
     desired = (uint32_t)SentinelValue::None;
@@ -651,14 +807,13 @@ void MQLock::release_writer_lock(uint32_t me, unsigned int key) {
                   (uint32_t)SentinelValue::None);
       return;
     }
-    printf("th %d : rl wl %d : next %d tail %d\n", me, key,
-           qnode->sucInfo.atomicLoadNext(), tail.load());
+    _mm_pause();
   }
 
   MQLNode *suc;
   for (;;) {
     uint32_t expected(me), desired((uint32_t)SentinelValue::Acquired);
-    suc = &MQLNodeTable[qnode->sucInfo.atomicLoadNext()][key];
+    suc = &MQLNodePool[qnode->sucInfo.atomicLoadNext()];
     if (suc->prev.compare_exchange_strong(expected, desired,
                                           std::memory_order_acq_rel,
                                           std::memory_order_acquire))
@@ -674,13 +829,12 @@ void MQLock::release_writer_lock(uint32_t me, unsigned int key) {
   return;
 }
 
-MQL_RESULT
+inline MQL_RESULT
 MQLock::cancel_writer_lock(uint32_t me, unsigned int key) {
-  NNN;
 start_cancel:
-  MQLNode *qnode = &MQLNodeTable[me][key];
+  MQLNode *qnode = &MQLNodePool[me];
   uint32_t pred = qnode->prev.exchange((uint32_t)SentinelValue::None);
-  MQLNode *p = &MQLNodeTable[pred][key];
+  MQLNode *p = &MQLNodePool[pred];
   // if pred is a releasing writer and already dereference my id, it will CAS
   // me.pred.id to Acquired, so we do a final check here; there's no way back
   // after this point (unless pred is a reader and it's already gone). After my
@@ -703,8 +857,7 @@ start_cancel:
   // that means my pred has put me on next_writer, deregister from there and go.
   // Note that the reader should first reset me.pred.id,
   // then put me on lock.nw
-  if (qnode->prev.load(std::memory_order_acquire) ==
-      (uint32_t)SentinelValue::None)
+  if (pred == (uint32_t)SentinelValue::None)
     return cancel_writer_lock_no_pred(me, key);
 
   for (;;) {
@@ -723,7 +876,12 @@ start_cancel:
       // in the later case it will.
       // So just recover me.pred.id and retry (can't reset
       // next.flags to Waiting - that will confuse our successor).
+      // Wait until pred decides, otherwise its CAS on me.pred.id may never
+      // fit between my store and xchg.
       qnode->prev.store(pred, std::memory_order_release);
+      while (qnode->prev.load(std::memory_order_acquire) == pred &&
+             p->sucInfo.atomicLoadStatus() == LockStatus::Leaving)
+        ;
       goto start_cancel;
     } else if (pflags.busy == true) {
       // pred is perhaps releasing (writer)? me.pred.id is 0,
@@ -736,7 +894,13 @@ start_cancel:
         qnode->sucInfo.atomicStoreStatus(LockStatus::Granted);
         return MQL_RESULT::Acquired;
       }
+      // a releasing reader pred resets me.pred.id and puts me on
+      // lock.next_writer, so give it my pred.id back and wait for that or for
+      // pred to finish its busy work.
       qnode->prev.store(pred, std::memory_order_release);
+      while (qnode->prev.load(std::memory_order_acquire) == pred &&
+             p->sucInfo.atomicLoadBusy())
+        ;
       pred = qnode->prev.exchange((uint32_t)SentinelValue::None);
       if (pred == (uint32_t)SentinelValue::None)
         return cancel_writer_lock_no_pred(me, key);
@@ -768,7 +932,7 @@ start_cancel:
       p->sucInfo.atomicStoreNext((uint32_t)SentinelValue::None);
 
       // initialize
-      MQLNodeTable[qnode->sucInfo.atomicLoadNext()][key].prev.store(
+      MQLNodePool[qnode->sucInfo.atomicLoadNext()].prev.store(
           (uint32_t)SentinelValue::None, std::memory_order_release);
       qnode->init(LockMode::None, (uint32_t)SentinelValue::None, false, false,
                   LockMode::None, LockStatus::Waiting,
@@ -790,28 +954,28 @@ retry:
   bool wakeup = false;
 
   if (p->type.load(std::memory_order_acquire) == LockMode::Reader &&
-      MQLNodeTable[qnode->sucInfo.atomicLoadNext()][key].type.load(
+      MQLNodePool[qnode->sucInfo.atomicLoadNext()].type.load(
           std::memory_order_acquire) == LockMode::Reader &&
       p->sucInfo.atomicLoadStatus() == LockStatus::Granted) {
     // There is a time window which starts after the pred finishedits "acquired"
     // block and ends before it releases. During this period my relink is
     // essentially invisible to pred. So we try to wake up the successor if this
     // the case.
-    successor.next = (uint32_t)SentinelValue::None;
+    successor.next = (uint32_t)SentinelValue::NoSuccessor;
     wakeup = true;
   }
 
-  if (p->sucInfo.atomicLoadBusy() == true) {
-    successor.busy = true;
-    if (!p->atomicCASSucInfo(expected, successor)) goto retry;
-  }
+  // relink pred to my successor, keeping pred's own flags.
+  successor.busy = expected.busy;
+  successor.status = expected.status;
+  if (!p->atomicCASSucInfo(expected, successor)) goto retry;
 
   // Now we need to wake up the successor if needed and set suc.pred.id - must
   // set suc.pred.id after setting pred.next.id: if we need to wake up
   // successor, we need to also set pred.next.id to NoSuccessor, which makes it
   // not safe for succ to spin on pred.next.id to wait for me finishing this
   // relink (pred might disappear any time because its next.id is NoSuccessor).
-  MQLNode *suc = &MQLNodeTable[qnode->sucInfo.atomicLoadNext()][key];
+  MQLNode *suc = &MQLNodePool[qnode->sucInfo.atomicLoadNext()];
   if (wakeup) {
     nreaders++;
     suc->granted.store(true, std::memory_order_release);
@@ -832,18 +996,16 @@ retry:
     }
   }
 
-  MQLNodeTable[qnode->sucInfo.atomicLoadNext()][key].prev.store(
-      (uint32_t)SentinelValue::None, std::memory_order_release);
   qnode->init(LockMode::None, (uint32_t)SentinelValue::None, false, false,
               LockMode::None, LockStatus::Waiting,
               (uint32_t)SentinelValue::None);
   return MQL_RESULT::Cancelled;
 }
 
-MQL_RESULT
-MQLock::cancel_writer_lock_no_pred(uint32_t me, unsigned int key) {
-  NNN;
-  MQLNode *qnode = &MQLNodeTable[me][key];
+inline MQL_RESULT
+MQLock::cancel_writer_lock_no_pred(uint32_t me,
+                                   [[maybe_unused]] unsigned int key) {
+  MQLNode *qnode = &MQLNodePool[me];
   while (!(next_writer != (uint32_t)SentinelValue::None ||
            qnode->granted.load(std::memory_order_acquire) == true))
     ;
@@ -865,7 +1027,7 @@ MQLock::cancel_writer_lock_no_pred(uint32_t me, unsigned int key) {
       tail.compare_exchange_strong(localme, (uint32_t)SentinelValue::None,
                                    std::memory_order_acq_rel,
                                    std::memory_order_acquire)) {
-    MQLNodeTable[qnode->sucInfo.atomicLoadNext()][key].prev.store(
+    MQLNodePool[qnode->sucInfo.atomicLoadNext()].prev.store(
         (uint32_t)SentinelValue::None, std::memory_order_release);
     qnode->init(LockMode::None, (uint32_t)SentinelValue::None, false, false,
                 LockMode::None, LockStatus::Waiting,
@@ -880,7 +1042,7 @@ MQLock::cancel_writer_lock_no_pred(uint32_t me, unsigned int key) {
   //
   // because I don't have a pred, if next_id is a writer, I should put it in
   // lock.nw
-  MQLNode *suc = &MQLNodeTable[localnext][key];
+  MQLNode *suc = &MQLNodePool[localnext];
   if (suc->type.load(std::memory_order_acquire) == LockMode::Writer) {
     // remaining readers will use CAS on lock.nw, so we blind write
     next_writer.store(localnext, std::memory_order_release);
@@ -903,7 +1065,7 @@ MQLock::cancel_writer_lock_no_pred(uint32_t me, unsigned int key) {
         if (suc->prev.compare_exchange_strong(
                 forSentiNone, (uint32_t)SentinelValue::Acquired,
                 std::memory_order_acq_rel, std::memory_order_acquire))
-          ;
+          break;
       }
       suc->granted.store(true, std::memory_order_release);
     }
@@ -920,83 +1082,8 @@ MQLock::cancel_writer_lock_no_pred(uint32_t me, unsigned int key) {
     suc->granted.store(true, std::memory_order_release);
   }
 
-  MQLNodeTable[qnode->sucInfo.atomicLoadNext()][key].prev.store(
-      (uint32_t)SentinelValue::None, std::memory_order_release);
   qnode->init(LockMode::None, (uint32_t)SentinelValue::None, false, false,
               LockMode::None, LockStatus::Waiting,
               (uint32_t)SentinelValue::None);
   return MQL_RESULT::Cancelled;
 }
-#endif  // MQLOCK
-
-#ifdef RWLOCK
-void RWLock::r_lock() {
-  int expected, desired;
-  expected = counter_.load(std::memory_order_acquire);
-  for (;;) {
-    if (expected != -1)
-      desired = expected + 1;
-    else {
-      expected = counter_.load(std::memory_order_acquire);
-      continue;
-    }
-    if (counter_.compare_exchange_strong(expected, desired,
-                                         std::memory_order_acq_rel,
-                                         std::memory_order_acquire))
-      break;
-  }
-}
-
-bool RWLock::r_trylock() {
-  int expected, desired;
-  expected = counter_.load(std::memory_order_acquire);
-  for (;;) {
-    if (expected != -1)
-      desired = expected + 1;
-    else
-      return false;
-
-    if (counter_.compare_exchange_strong(expected, desired,
-                                         std::memory_order_acq_rel,
-                                         std::memory_order_acquire))
-      return true;
-  }
-}
-
-void RWLock::r_unlock() { counter_--; }
-
-void RWLock::w_lock() {
-  int expected, desired(-1);
-  expected = counter_.load(std::memory_order_acquire);
-  for (;;) {
-    if (expected != 0) {
-      expected = counter_.load(std::memory_order_acquire);
-      continue;
-    }
-    if (counter_.compare_exchange_strong(expected, desired,
-                                         std::memory_order_acq_rel,
-                                         std::memory_order_acquire))
-      break;
-  }
-}
-
-bool RWLock::w_trylock() {
-  int expected, desired(-1);
-  expected = counter_.load(std::memory_order_acquire);
-  for (;;) {
-    if (expected != 0) return false;
-    if (counter_.compare_exchange_strong(expected, desired,
-                                         std::memory_order_acq_rel,
-                                         std::memory_order_acquire))
-      return true;
-  }
-}
-
-void RWLock::w_unlock() { counter_++; }
-
-bool RWLock::upgrade() {
-  int expected = 1;
-  return counter_.compare_exchange_weak(expected, -1,
-                                        std::memory_order_acq_rel);
-}
-#endif  // RWLOCK
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "cache_line_size.hh"
+
+/**
+ * @brief Epoch-based reclamation shared by MVCC engines, with a watermark of
+ * the timestamps which threads read at.
+ * @detail Each worker registers its slot. At a quiescent state, that is,
+ * between transactions when it holds no pointer to shared objects, it
+ * announces the current epoch and a lower bound of the timestamps which it
+ * reads at from then on. When all registered threads announced the current
+ * epoch, the leader advances the epoch and sets the watermark to the minimum
+ * of the announced timestamps. A version older than a newer version which is
+ * older than the watermark is never read again, so a worker detaches it from
+ * its chain and retires it to its LimboList. An object retired in epoch e is
+ * freed when the epoch reaches e + 2. By then every thread passed a quiescent
+ * state after it was detached, so no thread still traverses it.
+ */
+class EpochReclaimer {
+ public:
+  static constexpr uint64_t kIdle = UINT64_MAX;
+
+  EpochReclaimer() = default;
+  EpochReclaimer(const EpochReclaimer &) = delete;
+  EpochReclaimer &operator=(const EpochReclaimer &) = delete;
+
+  ~EpochReclaimer() { delete[] slots_; }
+
+  void init(std::size_t num) {
+    delete[] slots_;
+    slots_ = new Slot[num];
+    num_ = num;
+  }
+
+  /**
+   * @brief register the thread of the slot.
+   * @param [in] stamp lower bound of the timestamps it reads at.
+   * @return void
+   */
+  void enter(std::size_t thid, uint64_t stamp) { announce(thid, stamp); }
+
+  void leave(std::size_t thid) {
+    slots_[thid].epoch_.store(kIdle, std::memory_order_release);
+  }
+
+  /**
+   * @brief announce a quiescent state.
+   * @param [in] stamp lower bound of the timestamps the thread reads at from
+   * now on. It must not decrease.
+   * @return void
+   */
+  void announce(std::size_t thid, uint64_t stamp) {
+    slots_[thid].stamp_.store(stamp, std::memory_order_relaxed);
+    slots_[thid].epoch_.store(epoch_.load(std::memory_order_acquire),
+                              std::memory_order_release);
+  }
+
+  bool announced(std::size_t thid) {
+    return slots_[thid].epoch_.load(std::memory_order_relaxed) ==
+           epoch_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief advance the epoch and the watermark if all registered threads
+   * announced the current epoch.
+   * @detail It is called by a single leader.
+   * @return whether they advanced.
+   */
+  bool tryAdvance() {
+    uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+    uint64_t min = kIdle;
+    for (std::size_t i = 0; i < num_; ++i) {
+      uint64_t e = slots_[i].epoch_.load(std::memory_order_acquire);
+      if (e == kIdle) continue;
+      if (e != epoch) return false;
+      min = std::min(min, slots_[i].stamp_.load(std::memory_order_relaxed));
+    }
+    if (min != kIdle && min > watermark_.load(std::memory_order_relaxed))
+      watermark_.store(min, std::memory_order_release);
+    epoch_.store(epoch + 1, std::memory_order_release);
+    return true;
+  }
+
+  uint64_t epoch() { return epoch_.load(std::memory_order_acquire); }
+
+  uint64_t watermark() { return watermark_.load(std::memory_order_acquire); }
+
+  void display() {
+    std::cout << "reclaim_epochs:\t" << epoch() << std::endl;
+  }
+
+ private:
+  class alignas(CACHE_LINE_SIZE) Slot {
+   public:
+    std::atomic<uint64_t> epoch_{kIdle};
+    std::atomic<uint64_t> stamp_{0};
+  };
+
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> epoch_{0};
+  std::atomic<uint64_t> watermark_{0};
+  Slot *slots_ = nullptr;
+  std::size_t num_ = 0;
+};
+
+/**
+ * @brief Objects retired by a thread, grouped into bags by the epoch in which
+ * they were retired.
+ * @detail retire() collects objects into the open bag, and seal() labels it
+ * with the epoch after they were made unreachable. reclaim() frees the bags
+ * which are old enough in a batch.
+ */
+template <typename T>
+class LimboList {
+ public:
+  // statistics
+  uint64_t lag_sum_ = 0;  // age of the oldest bag at reclaim() [epochs]
+  uint64_t lag_max_ = 0;
+
+  void retire(const T &obj) { open_.emplace_back(obj); }
+
+  /**
+   * @brief close the open bag.
+   * @pre its objects are no longer reachable from shared data.
+   * @return void
+   */
+  void seal(EpochReclaimer &reclaimer) {
+    if (open_.empty()) return;
+    // the epoch must be read after the objects were detached.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t epoch = reclaimer.epoch();
+    if (!bags_.empty() && bags_.back().epoch_ == epoch) {
+      bags_.back().objs_.insert(bags_.back().objs_.end(), open_.begin(),
+                                open_.end());
+      open_.clear();
+      return;
+    }
+    bags_.emplace_back();
+    bags_.back().epoch_ = epoch;
+    bags_.back().objs_.swap(open_);
+    if (!spare_.empty()) {
+      open_.swap(spare_.back());
+      spare_.pop_back();
+    }
+  }
+
+  /**
+   * @brief free the objects of the bags which no thread can reach.
+   * @param [in] free callable which frees a retired object.
+   * @return void
+   */
+  template <typename Free>
+  void reclaim(EpochReclaimer &reclaimer, Free free) {
+    uint64_t epoch = reclaimer.epoch();
+    if (bags_.empty()) return;
+    uint64_t lag = epoch - bags_.front().epoch_;
+    lag_sum_ += lag;
+    if (lag > lag_max_) lag_max_ = lag;
+
+    while (!bags_.empty() && bags_.front().epoch_ + 2 <= epoch) {
+      std::vector<T> &objs = bags_.front().objs_;
+      for (auto itr = objs.begin(); itr != objs.end(); ++itr) free(*itr);
+      objs.clear();
+      spare_.emplace_back(std::move(objs));
+      bags_.pop_front();
+    }
+  }
+
+ private:
+  class Bag {
+   public:
+    uint64_t epoch_;
+    std::vector<T> objs_;
+  };
+
+  std::deque<Bag> bags_;
+  std::vector<T> open_;
+  std::vector<std::vector<T>> spare_;  // emptied bags to reuse their storage.
+};
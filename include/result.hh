@@ -15,19 +15,36 @@ class Result {
   uint64_t local_abort_by_validation_ = 0;
   uint64_t local_commit_latency_ = 0;
   uint64_t local_backoff_latency_ = 0;
+  uint64_t local_cascading_aborts_ = 0;
+  uint64_t local_dies_ = 0;
   uint64_t local_early_aborts_ = 0;
+  uint64_t local_early_releases_ = 0;
   uint64_t local_extra_reads_ = 0;
+  uint64_t local_gc_chain_length_ = 0;
+  uint64_t local_gc_chain_length_max_ = 0;
+  uint64_t local_gc_chains_ = 0;
   uint64_t local_gc_counts_ = 0;
   uint64_t local_gc_latency_ = 0;
   uint64_t local_gc_version_counts_ = 0;
   uint64_t local_gc_TMT_elements_counts_ = 0;
+  uint64_t local_lock_wait_latency_ = 0;
+  uint64_t local_log_bytes_ = 0;
+  uint64_t local_lsn_counts_ = 0;
+  uint64_t local_lsn_latency_ = 0;
   uint64_t local_make_procedure_latency_ = 0;
   uint64_t local_memcpys = 0;
   uint64_t local_preemptive_aborts_counts_ = 0;
   uint64_t local_read_latency_ = 0;
+  uint64_t local_reclaim_lag_ = 0;
+  uint64_t local_reclaim_lag_max_ = 0;
+  uint64_t local_repair_commit_counts_ = 0;
+  uint64_t local_repair_counts_ = 0;
+  uint64_t local_ronly_abort_counts_ = 0;
+  uint64_t local_ronly_commit_counts_ = 0;
   uint64_t local_rtsupd_ = 0;
   uint64_t local_rtsupd_chances_ = 0;
   uint64_t local_temperature_resets_ = 0;
+  uint64_t local_temperature_updates_ = 0;
   uint64_t local_timestamp_history_fail_counts_ = 0;
   uint64_t local_timestamp_history_success_counts_ = 0;
   uint64_t local_TMT_element_malloc_ = 0;
@@ -37,8 +54,14 @@ class Result {
   uint64_t local_validation_failure_by_tid_ = 0;
   uint64_t local_validation_failure_by_writelock_ = 0;
   uint64_t local_version_malloc_ = 0;
+  uint64_t local_version_remote_frees_ = 0;
   uint64_t local_version_reuse_ = 0;
+  uint64_t local_version_slab_bytes_ = 0;
+  uint64_t local_wounded_aborts_ = 0;
+  uint64_t local_wounds_ = 0;
   uint64_t local_write_latency_ = 0;
+  uint64_t local_write_lock_hold_ = 0;
+  uint64_t local_write_locks_ = 0;
 #endif
 
   uint64_t total_abort_counts_ = 0;
@@ -48,19 +71,36 @@ class Result {
   uint64_t total_abort_by_validation_ = 0;
   uint64_t total_commit_latency_ = 0;
   uint64_t total_backoff_latency_ = 0;
+  uint64_t total_cascading_aborts_ = 0;
+  uint64_t total_dies_ = 0;
   uint64_t total_early_aborts_ = 0;
+  uint64_t total_early_releases_ = 0;
   uint64_t total_extra_reads_ = 0;
+  uint64_t total_gc_chain_length_ = 0;
+  uint64_t total_gc_chain_length_max_ = 0;
+  uint64_t total_gc_chains_ = 0;
   uint64_t total_gc_counts_ = 0;
   uint64_t total_gc_latency_ = 0;
   uint64_t total_gc_version_counts_ = 0;
   uint64_t total_gc_TMT_elements_counts_ = 0;
+  uint64_t total_lock_wait_latency_ = 0;
+  uint64_t total_log_bytes_ = 0;
+  uint64_t total_lsn_counts_ = 0;
+  uint64_t total_lsn_latency_ = 0;
   uint64_t total_make_procedure_latency_ = 0;
   uint64_t total_memcpys = 0;
   uint64_t total_preemptive_aborts_counts_ = 0;
   uint64_t total_read_latency_ = 0;
+  uint64_t total_reclaim_lag_ = 0;
+  uint64_t total_reclaim_lag_max_ = 0;
+  uint64_t total_repair_commit_counts_ = 0;
+  uint64_t total_repair_counts_ = 0;
+  uint64_t total_ronly_abort_counts_ = 0;
+  uint64_t total_ronly_commit_counts_ = 0;
   uint64_t total_rtsupd_ = 0;
   uint64_t total_rtsupd_chances_ = 0;
   uint64_t total_temperature_resets_ = 0;
+  uint64_t total_temperature_updates_ = 0;
   uint64_t total_timestamp_history_fail_counts_ = 0;
   uint64_t total_timestamp_history_success_counts_ = 0;
   uint64_t total_TMT_element_malloc_ = 0;
@@ -70,8 +110,14 @@ class Result {
   uint64_t total_validation_failure_by_tid_ = 0;
   uint64_t total_validation_failure_by_writelock_ = 0;
   uint64_t total_version_malloc_ = 0;
+  uint64_t total_version_remote_frees_ = 0;
   uint64_t total_version_reuse_ = 0;
+  uint64_t total_version_slab_bytes_ = 0;
+  uint64_t total_wounded_aborts_ = 0;
+  uint64_t total_wounds_ = 0;
   uint64_t total_write_latency_ = 0;
+  uint64_t total_write_lock_hold_ = 0;
+  uint64_t total_write_locks_ = 0;
   // not exist local version.
   uint64_t total_latency_ = 0;
 #endif
@@ -88,13 +134,21 @@ class Result {
                                  size_t thread_num);
   void displayBackoffLatencyRate(size_t clocks_per_us, size_t extime,
                                  size_t thread_num);
+  void displayCascadingAborts();
+  void displayDies();
   void displayEarlyAbortRate();
+  void displayEarlyReleases();
   void displayExtraReads();
+  void displayGCChainLength();
   void displayGCCounts();
   void displayGCLatencyRate(size_t clocks_per_us, size_t extime,
                             size_t thread_num);
   void displayGCTMTElementsCounts();
   void displayGCVersionCounts();
+  void displayLockWaitLatencyRate(size_t clocks_per_us, size_t extime,
+                                  size_t thread_num);
+  void displayLogBytes();
+  void displayLsnLatency();
   void displayMakeProcedureLatencyRate(size_t clocks_per_us, size_t extime,
       size_t thread_num);
   void displayMemcpys();
@@ -104,13 +158,19 @@ class Result {
   void displayRatioOfPreemptiveAbortToTotalAbort();
   void displayReadLatencyRate(size_t clocks_per_us, size_t extime,
                               size_t thread_num);
+  void displayReclaimLag();
+  void displayRepairCounts();
+  void displayRonlyAbortRate();  // read only transactions
   void displayRtsupdRate();
   void displayTemperatureResets();
+  void displayTemperatureUpdates();
   void displayTimestampHistorySuccessCounts();
   void displayTimestampHistoryFailCounts();
   void displayTreeTraversal();
   void displayTMTElementMalloc();
   void displayTMTElementReuse();
+  void displayWounds();
+  void displayWriteLockHold(size_t clocks_per_us);
   void displayWriteLatencyRate(size_t clocks_per_us, size_t extime,
                                size_t thread_num);
   void displayValiLatencyRate(size_t clocks_per_us, size_t extime,
@@ -118,7 +178,9 @@ class Result {
   void displayValidationFailureByTidRate();
   void displayValidationFailureByWritelockRate();
   void displayVersionMalloc();
+  void displayVersionRemoteFrees();
   void displayVersionReuse();
+  void displayVersionSlabBytes();
 
 #endif
 
@@ -130,29 +192,52 @@ class Result {
   void addLocalAbortByValidation(const uint64_t count);
   void addLocalCommitLatency(const uint64_t count);
   void addLocalBackoffLatency(const uint64_t count);
+  void addLocalCascadingAborts(const uint64_t count);
+  void addLocalDies(const uint64_t count);
   void addLocalEarlyAborts(const uint64_t count);
+  void addLocalEarlyReleases(const uint64_t count);
   void addLocalExtraReads(const uint64_t count);
+  void addLocalGCChainLength(const uint64_t count);
+  void addLocalGCChainLengthMax(const uint64_t count);
+  void addLocalGCChains(const uint64_t count);
   void addLocalGCCounts(const uint64_t count);
   void addLocalGCLatency(const uint64_t count);
   void addLocalGCVersionCounts(const uint64_t count);
   void addLocalGCTMTElementsCounts(const uint64_t count);
+  void addLocalLockWaitLatency(const uint64_t count);
+  void addLocalLogBytes(const uint64_t count);
+  void addLocalLsnCounts(const uint64_t count);
+  void addLocalLsnLatency(const uint64_t count);
   void addLocalMakeProcedureLatency(const uint64_t count);
   void addLocalMemcpys(const uint64_t count);
   void addLocalPreemptiveAbortsCounts(const uint64_t count);
   void addLocalReadLatency(const uint64_t count);
+  void addLocalReclaimLag(const uint64_t count);
+  void addLocalReclaimLagMax(const uint64_t count);
+  void addLocalRepairCommitCounts(const uint64_t count);
+  void addLocalRepairCounts(const uint64_t count);
+  void addLocalRonlyAbortCounts(const uint64_t count);
+  void addLocalRonlyCommitCounts(const uint64_t count);
   void addLocalRtsupd(const uint64_t count);
   void addLocalRtsupdChances(const uint64_t count);
   void addLocalTimestampHistorySuccessCounts(const uint64_t count);
   void addLocalTimestampHistoryFailCounts(const uint64_t count);
   void addLocalTemperatureResets(uint64_t count);
+  void addLocalTemperatureUpdates(uint64_t count);
   void addLocalTMTElementsMalloc(const uint64_t count);
   void addLocalTMTElementsReuse(const uint64_t count);
   void addLocalTreeTraversal(const uint64_t count);
+  void addLocalWoundedAborts(const uint64_t count);
+  void addLocalWounds(const uint64_t count);
   void addLocalWriteLatency(const uint64_t count);
+  void addLocalWriteLockHold(const uint64_t count);
+  void addLocalWriteLocks(const uint64_t count);
   void addLocalValiLatency(const uint64_t count);
   void addLocalValidationFailureByTid(const uint64_t count);
   void addLocalValidationFailureByWritelock(const uint64_t count);
   void addLocalVersionMalloc(const uint64_t count);
+  void addLocalVersionRemoteFrees(const uint64_t count);
   void addLocalVersionReuse(const uint64_t count);
+  void addLocalVersionSlabBytes(const uint64_t count);
 #endif
 };
@@ -2,6 +2,7 @@
 
 #include <xmmintrin.h>
 #include <atomic>
+#include <cstddef>
 
 using namespace std;
 
@@ -16,6 +17,8 @@ class RWLock {
 
   void init() { counter.store(0, memory_order_release); }
 
+  static void initGlobal([[maybe_unused]] std::size_t thread_num) {}
+
   // Read lock
   void r_lock() {
     int expected, desired;
@@ -80,7 +83,7 @@ class RWLock {
   void w_unlock() { counter++; }
 
   // Upgrae, read -> write
-  void upgrade() {
+  bool upgrade() {
     int expected, desired(-1);
     expected = counter.load(memory_order_acquire);
     for (;;) {
@@ -91,7 +94,7 @@ class RWLock {
 
       if (counter.compare_exchange_strong(
               expected, desired, memory_order_acq_rel, memory_order_acquire))
-        return;
+        return true;
     }
   }
 
@@ -106,4 +109,9 @@ class RWLock {
         return true;
     }
   }
+
+  // Downgrade, write -> read
+  void downgrade() { counter.store(1, memory_order_release); }
+
+  bool w_locked() { return counter.load(memory_order_acquire) == -1; }
 };
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include "cache_line_size.hh"
+#include "debug.hh"
+
+/**
+ * @brief Per-thread slab allocator of fixed size objects such as versions.
+ * @detail Objects are carved from chunks of kChunkSize bytes which are aligned
+ * to kChunkSize, so the header of the chunk, which knows the owner, is found
+ * by masking the address of an object. A freed object is linked into an
+ * intrusive free list through its own storage. The owner links it into its
+ * local free list. Another thread pushes it to the remote free list of the
+ * owner, which the owner takes at once when its local list runs out, so
+ * objects go back to the memory of their owner. Chunks are released only when
+ * the allocator is destroyed.
+ *
+ * With numa_local, each chunk is bound to the NUMA node of the thread which
+ * allocates it (MPOL_LOCAL) even if the process runs under
+ * numactl --interleave. Otherwise the process policy places it, which is
+ * first touch by default.
+ */
+template <typename T>
+class SlabAllocator {
+ public:
+  static constexpr std::size_t kChunkSize = 2 << 20;
+
+  // statistics
+  uint64_t chunks_ = 0;
+  uint64_t fresh_ = 0;         // objects carved from chunks
+  uint64_t reuses_ = 0;        // objects taken from free lists
+  uint64_t remote_frees_ = 0;  // objects returned to other owners
+
+  SlabAllocator() = default;
+  SlabAllocator(const SlabAllocator &) = delete;
+  SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+  ~SlabAllocator() {
+    for (auto itr = chunks_list_.begin(); itr != chunks_list_.end(); ++itr)
+      ::munmap(*itr, kChunkSize);
+  }
+
+  /**
+   * @param [in] numa_local bind chunks to the local NUMA node.
+   * @param [in] remote_free whether the owner takes objects freed by other
+   * threads. If false, they are kept by the threads which free them. It is
+   * for owners which stop allocating, such as loaders.
+   * @return void
+   */
+  void init(bool numa_local, bool remote_free = true) {
+    numa_local_ = numa_local;
+    remote_free_ = remote_free;
+  }
+
+  /**
+   * @brief allocate chunks for num objects in advance.
+   * @detail It is called by the owner so the chunks are local to it.
+   * @return void
+   */
+  void reserve(std::size_t num) {
+    for (std::size_t i = 0; i < num; ++i) {
+      Node *node = reinterpret_cast<Node *>(carve());
+      node->next_ = free_;
+      free_ = node;
+    }
+  }
+
+  T *allocate() {
+    void *p = pop();
+    if (p != nullptr) {
+      ++reuses_;
+    } else {
+      p = carve();
+      ++fresh_;
+    }
+    return new (p) T();
+  }
+
+  /**
+   * @brief free an object allocated by any allocator.
+   * @pre this is the allocator of the calling thread.
+   * @return void
+   */
+  void free(T *obj) {
+    obj->~T();
+    Node *node = reinterpret_cast<Node *>(obj);
+    SlabAllocator *owner = ownerOf(obj);
+    if (owner == this || !owner->remote_free_) {
+      node->next_ = free_;
+      free_ = node;
+      return;
+    }
+
+    Node *head = owner->remote_.load(std::memory_order_relaxed);
+    do {
+      node->next_ = head;
+    } while (!owner->remote_.compare_exchange_weak(
+        head, node, std::memory_order_release, std::memory_order_relaxed));
+    ++remote_frees_;
+  }
+
+  static SlabAllocator *ownerOf(T *obj) {
+    return reinterpret_cast<ChunkHeader *>(reinterpret_cast<uintptr_t>(obj) &
+                                           ~(kChunkSize - 1))
+        ->owner_;
+  }
+
+ private:
+  class Node {
+   public:
+    Node *next_;
+  };
+
+  class alignas(CACHE_LINE_SIZE) ChunkHeader {
+   public:
+    SlabAllocator *owner_;
+  };
+
+  static constexpr std::size_t kObjectSize =
+      (sizeof(T) + alignof(T) - 1) / alignof(T) * alignof(T);
+  static constexpr std::size_t kHeaderSize =
+      (sizeof(ChunkHeader) + alignof(T) - 1) / alignof(T) * alignof(T);
+  static_assert(sizeof(T) >= sizeof(Node), "object is smaller than a link");
+  static_assert(kHeaderSize + kObjectSize <= kChunkSize, "object is too big");
+
+  Node *free_ = nullptr;
+  char *next_ = nullptr;  // next object to carve in the current chunk
+  char *end_ = nullptr;
+  std::vector<void *> chunks_list_;
+  bool numa_local_ = false;
+  bool remote_free_ = true;
+  alignas(CACHE_LINE_SIZE) std::atomic<Node *> remote_{nullptr};
+
+  void *pop() {
+    if (free_ == nullptr && remote_free_)
+      free_ = remote_.exchange(nullptr, std::memory_order_acquire);
+    if (free_ == nullptr) return nullptr;
+    Node *node = free_;
+    free_ = node->next_;
+    return node;
+  }
+
+  void *carve() {
+    if (next_ + kObjectSize > end_) addChunk();
+    void *p = next_;
+    next_ += kObjectSize;
+    return p;
+  }
+
+  void addChunk() {
+    // map twice the size and trim it to get the alignment.
+    void *map = ::mmap(nullptr, 2 * kChunkSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) throw std::bad_alloc();
+    uintptr_t addr = reinterpret_cast<uintptr_t>(map);
+    uintptr_t chunk = (addr + kChunkSize - 1) & ~(kChunkSize - 1);
+    if (chunk > addr) ::munmap(map, chunk - addr);
+    if (chunk + kChunkSize < addr + 2 * kChunkSize)
+      ::munmap(reinterpret_cast<void *>(chunk + kChunkSize),
+               addr + kChunkSize - chunk);
+
+#ifdef Linux
+#ifdef MADV_HUGEPAGE
+    ::madvise(reinterpret_cast<void *>(chunk), kChunkSize, MADV_HUGEPAGE);
+#endif
+#ifdef SYS_mbind
+    // MPOL_LOCAL. It is advice, so failure is ignored.
+    if (numa_local_)
+      ::syscall(SYS_mbind, chunk, kChunkSize, 4, nullptr, 0, 0);
+#endif
+#endif  // Linux
+
+    // the first touch is by the allocating thread.
+    reinterpret_cast<ChunkHeader *>(chunk)->owner_ = this;
+    chunks_list_.emplace_back(reinterpret_cast<void *>(chunk));
+    next_ = reinterpret_cast<char *>(chunk) + kHeaderSize;
+    end_ = reinterpret_cast<char *>(chunk) + kChunkSize;
+    ++chunks_;
+  }
+};
@@ -0,0 +1,327 @@
+#include <ctype.h>  //isdigit,
+#include <pthread.h>
+#include <string.h>       //strlen,
+#include <sys/syscall.h>  //syscall(SYS_gettid),
+#include <sys/types.h>    //syscall(SYS_gettid),
+#include <time.h>
+#include <unistd.h>  //syscall(SYS_gettid),
+#include <xmmintrin.h>
+
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>  //string
+#include <thread>
+#include <vector>
+
+#include "../include/atomic_wrapper.hh"
+#include "../include/cache_line_size.hh"
+#include "../include/debug.hh"
+#include "../include/locks.hh"
+#include "../include/random.hh"
+#include "../include/tsc.hh"
+#include "../include/util.hh"
+
+using namespace std;
+
+extern bool isReady(const std::vector<char>& readys);
+extern void waitForReady(const std::vector<char>& readys);
+extern void sleepMs(size_t ms);
+
+alignas(CACHE_LINE_SIZE) size_t LOCK_KIND;
+alignas(CACHE_LINE_SIZE) size_t THREAD_NUM;
+alignas(CACHE_LINE_SIZE) size_t RRATIO;        // [%]
+alignas(CACHE_LINE_SIZE) uint64_t CS_CLOCKS;   // critical section [clocks]
+alignas(CACHE_LINE_SIZE) size_t LOCK_NUM;      // number of lock instances
+alignas(CACHE_LINE_SIZE) size_t TIMEOUT_RATE;  // [%]
+alignas(CACHE_LINE_SIZE) uint64_t TIMEOUT_CLOCKS;
+#define EXTIME 3
+
+/**
+ * @brief Log-linear histogram of latencies [clocks].
+ * @detail Values under 2^SUB_BITS are exact. Larger values are counted in
+ * 2^SUB_BITS buckets per power of two, so a percentile is within 1/2^SUB_BITS
+ * of the true value.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr size_t SUB_BITS = 4;
+  static constexpr size_t SUB = 1 << SUB_BITS;
+  static constexpr size_t BUCKETS = SUB + (64 - SUB_BITS) * SUB;
+
+  uint64_t count_[BUCKETS] = {};
+  uint64_t max_ = 0;
+
+  void add(uint64_t v) {
+    ++count_[index(v)];
+    if (v > max_) max_ = v;
+  }
+
+  void merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKETS; ++i) count_[i] += other.count_[i];
+    if (other.max_ > max_) max_ = other.max_;
+  }
+
+  /**
+   * @brief upper bound of the bucket which holds the p-th percentile.
+   */
+  uint64_t percentile(double p) const {
+    uint64_t total(0);
+    for (size_t i = 0; i < BUCKETS; ++i) total += count_[i];
+    if (total == 0) return 0;
+    uint64_t rank = std::ceil(total * p / 100);
+    if (rank == 0) rank = 1;
+    uint64_t sum(0);
+    for (size_t i = 0; i < BUCKETS; ++i) {
+      sum += count_[i];
+      if (sum >= rank) return std::min(upper(i), max_);
+    }
+    return max_;
+  }
+
+ private:
+  static size_t index(uint64_t v) {
+    if (v < SUB) return v;
+    size_t msb = 63 - __builtin_clzll(v);
+    size_t sub = (v >> (msb - SUB_BITS)) & (SUB - 1);
+    return SUB + (msb - SUB_BITS) * SUB + sub;
+  }
+
+  static uint64_t upper(size_t i) {
+    if (i < SUB) return i;
+    size_t msb = (i - SUB) / SUB + SUB_BITS;
+    uint64_t sub = (i - SUB) % SUB;
+    return ((SUB + sub + 1) << (msb - SUB_BITS)) - 1;
+  }
+};
+
+class Stat {
+ public:
+  uint64_t acquires_ = 0;
+  uint64_t timeouts_ = 0;
+  uint64_t writes_ = 0;
+  LatencyHistogram latency_;
+};
+
+template <typename Lock>
+class alignas(CACHE_LINE_SIZE) LockedRecord {
+ public:
+  Lock lock_;
+  // updated only in the critical section of writers.
+  uint64_t writes_ = 0;
+};
+
+static bool chkInt(const char* arg) {
+  for (unsigned int i = 0; i < strlen(arg); ++i) {
+    if (!isdigit(arg[i])) {
+      cout << std::string(arg) << " is not a number." << endl;
+      exit(0);
+    }
+  }
+  return true;
+}
+
+static void chkArg(const int argc, const char* argv[]) {
+  if (argc != 8) {
+    cout << "usage: ./lock_bench LOCK_KIND THREAD_NUM RRATIO CS_CLOCKS "
+            "LOCK_NUM TIMEOUT_RATE TIMEOUT_CLOCKS"
+         << endl;
+    cout << "example: ./lock_bench 5 24 80 100 16 10 10000" << endl;
+    cout << "LOCK_KIND(int): 0 RWLock, 1 TTASLock, 2 TicketLock, 3 MCSLock, "
+            "4 MCSRWLock, 5 MQLRWLock, 6 ReaderBiasedLock, 7 DistributedRWLock "
+            "(see locks.hh)"
+         << endl;
+    cout << "THREAD_NUM(int): total numbers of worker thread" << endl;
+    cout << "RRATIO(int): percentage of read acquisitions" << endl;
+    cout << "CS_CLOCKS(int): length of critical section [clocks]" << endl;
+    cout << "LOCK_NUM(int): number of lock instances" << endl;
+    cout << "TIMEOUT_RATE(int): percentage of acquisitions with timeout"
+         << endl;
+    cout << "TIMEOUT_CLOCKS(int): timeout of those acquisitions [clocks]"
+         << endl;
+    cout << "argc == " << argc << endl;
+
+    exit(0);
+  }
+
+  for (int i = 1; i < argc; ++i) chkInt(argv[i]);
+
+  LOCK_KIND = atoi(argv[1]);
+  THREAD_NUM = atoi(argv[2]);
+  RRATIO = atoi(argv[3]);
+  CS_CLOCKS = atoll(argv[4]);
+  LOCK_NUM = atoi(argv[5]);
+  TIMEOUT_RATE = atoi(argv[6]);
+  TIMEOUT_CLOCKS = atoll(argv[7]);
+  if (LOCK_KIND > 7) {
+    cout << "LOCK_KIND must be 0..7" << endl;
+    ERR;
+  }
+  if (THREAD_NUM < 1) {
+    cout << "THREAD_NUM must be larger than 0" << endl;
+    ERR;
+  }
+  if (RRATIO > 100 || TIMEOUT_RATE > 100) {
+    cout << "RRATIO and TIMEOUT_RATE must be 0..100" << endl;
+    ERR;
+  }
+  if (LOCK_NUM < 1) {
+    cout << "LOCK_NUM must be larger than 0" << endl;
+    ERR;
+  }
+}
+
+static void spinClocks(uint64_t clocks) {
+  if (clocks == 0) return;
+  uint64_t start = rdtscp();
+  while (rdtscp() - start < clocks) _mm_pause();
+}
+
+/**
+ * @brief acquire the lock, giving up after TIMEOUT_CLOCKS.
+ * @detail The locks have no timed acquisition, so it polls trylock like
+ * mocc's retrospective locking does with its trylock.
+ */
+template <typename Lock>
+static bool timedLock(Lock& lock, bool read, uint64_t start) {
+  for (;;) {
+    if (read ? lock.r_trylock() : lock.w_trylock()) return true;
+    if (rdtscp() - start >= TIMEOUT_CLOCKS) return false;
+    _mm_pause();
+  }
+}
+
+template <typename Lock>
+void worker(size_t thid, char& ready, const bool& start, const bool& quit,
+            std::vector<LockedRecord<Lock>>& records, Stat& stat) {
+  pid_t pid;
+  cpu_set_t cpu_set;
+
+  pid = syscall(SYS_gettid);
+  CPU_ZERO(&cpu_set);
+  CPU_SET(thid % sysconf(_SC_NPROCESSORS_CONF), &cpu_set);
+
+  if (sched_setaffinity(pid, sizeof(cpu_set_t), &cpu_set) != 0) {
+    ERR;
+  }
+
+  Xoroshiro128Plus rnd;
+  rnd.init();
+  Stat lstat;
+  storeRelease(ready, 1);
+  while (!loadAcquire(start)) _mm_pause();
+  while (!loadAcquire(quit)) {
+    LockedRecord<Lock>& rec = records[rnd.next() % LOCK_NUM];
+    bool read = rnd.next() % 100 < RRATIO;
+    bool timed = rnd.next() % 100 < TIMEOUT_RATE;
+
+    uint64_t bgn = rdtscp();
+    if (timed) {
+      if (!timedLock(rec.lock_, read, bgn)) {
+        ++lstat.timeouts_;
+        continue;
+      }
+    } else if (read) {
+      rec.lock_.r_lock();
+    } else {
+      rec.lock_.w_lock();
+    }
+    lstat.latency_.add(rdtscp() - bgn);
+
+    spinClocks(CS_CLOCKS);
+    if (read) {
+      rec.lock_.r_unlock();
+    } else {
+      ++rec.writes_;
+      rec.lock_.w_unlock();
+      ++lstat.writes_;
+    }
+    ++lstat.acquires_;
+  }
+
+  stat = lstat;
+  return;
+}
+
+template <typename Lock>
+void run(const char* name) {
+  std::vector<LockedRecord<Lock>> records(LOCK_NUM);
+  for (auto& rec : records) rec.lock_.init();
+  Lock::initGlobal(THREAD_NUM);
+
+  bool start(false), quit(false);
+  std::vector<std::thread> ths;
+  std::vector<char> readys(THREAD_NUM);
+  std::vector<Stat> stats(THREAD_NUM);
+
+  for (size_t i = 0; i < THREAD_NUM; ++i)
+    ths.emplace_back(worker<Lock>, i, std::ref(readys[i]), std::ref(start),
+                     std::ref(quit), std::ref(records), std::ref(stats[i]));
+
+  waitForReady(readys);
+  storeRelease(start, true);
+  for (size_t i = 0; i < EXTIME; ++i) sleepMs(1000);
+  storeRelease(quit, true);
+
+  for (auto& t : ths) t.join();
+
+  Stat total;
+  double sq(0);
+  uint64_t min(UINT64_MAX), max(0);
+  for (size_t i = 0; i < THREAD_NUM; ++i) {
+    cout << "cpu#" << i << ":\t" << stats[i].acquires_ << endl;
+    total.acquires_ += stats[i].acquires_;
+    total.timeouts_ += stats[i].timeouts_;
+    total.writes_ += stats[i].writes_;
+    total.latency_.merge(stats[i].latency_);
+    sq += (double)stats[i].acquires_ * stats[i].acquires_;
+    min = std::min(min, stats[i].acquires_);
+    max = std::max(max, stats[i].acquires_);
+  }
+
+  // writes_ counts writers in critical sections, so it matches only if the
+  // lock excluded them.
+  uint64_t writes(0);
+  for (auto& rec : records) writes += rec.writes_;
+
+  uint64_t tries = total.acquires_ + total.timeouts_;
+  cout << "lock:\t" << name << endl;
+  cout << "throughput[acq/s]:\t" << total.acquires_ / EXTIME << endl;
+  cout << "timeout_rate:\t" << fixed << setprecision(4)
+       << (tries ? (double)total.timeouts_ / tries : 0) << endl;
+  cout << "latency[clocks] p50:\t" << total.latency_.percentile(50) << endl;
+  cout << "latency[clocks] p90:\t" << total.latency_.percentile(90) << endl;
+  cout << "latency[clocks] p99:\t" << total.latency_.percentile(99) << endl;
+  cout << "latency[clocks] p99.9:\t" << total.latency_.percentile(99.9)
+       << endl;
+  cout << "latency[clocks] max:\t" << total.latency_.max_ << endl;
+  // Jain's fairness index of acquisitions per thread. 1 is fair.
+  cout << "fairness:\t"
+       << (sq > 0 ? (double)total.acquires_ * total.acquires_ /
+                        (THREAD_NUM * sq)
+                  : 1)
+       << endl;
+  cout << "min/max acquisitions:\t" << (max ? (double)min / max : 1) << endl;
+  if (writes != total.writes_) {
+    cout << "lost updates: " << total.writes_ - writes << endl;
+    ERR;
+  }
+}
+
+template <int Kind>
+void runKind(size_t kind) {
+  if constexpr (Kind <= 7) {
+    if (kind == Kind)
+      run<typename LockOf<Kind>::type>(LockOf<Kind>::name);
+    else
+      runKind<Kind + 1>(kind);
+  }
+}
+
+int main(const int argc, const char* argv[]) {
+  chkArg(argc, argv);
+  runKind<0>(LOCK_KIND);
+
+  return 0;
+}
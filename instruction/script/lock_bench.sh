@@ -0,0 +1,48 @@
+#lock_bench.sh
+# sweep each lock over thread count, read ratio, critical section, number of
+# locks and timeout rate. One line per run in lock_bench.dat.
+host=`hostname`
+dbs11="dbs11"
+
+#basically
+inith=4
+enth=24
+inc=4
+if test $host = $dbs11 ; then
+  inith=28
+  enth=224
+  inc=28
+fi
+timeout_clocks=100000
+
+result=lock_bench.dat
+rm $result
+echo "#kind, thnr, rratio, cs_clocks, lock_num, timeout_rate, throughput, timeout_rate(measured), p50, p99, p99.9, fairness" >> $result
+
+for kind in 0 1 2 3 4 5 6 7
+do
+for ((thread=$inith; thread<=$enth; thread+=$inc))
+do
+for rratio in 0 50 95
+do
+for cs in 0 100 1000
+do
+for locknum in 1 16 1024
+do
+for timeout in 0 50
+do
+  echo "#kind: $kind, #thread: $thread, rratio: $rratio, cs: $cs, locknum: $locknum, timeout: $timeout"
+  numactl --interleave=all ../lock_bench $kind $thread $rratio $cs $locknum $timeout $timeout_clocks > out
+  tps=`grep "throughput" out | awk '{print $2}'`
+  tor=`grep "timeout_rate" out | awk '{print $2}'`
+  p50=`grep "p50" out | awk '{print $3}'`
+  p99=`grep "p99:" out | awk '{print $3}'`
+  p999=`grep "p99.9" out | awk '{print $3}'`
+  fair=`grep "fairness" out | awk '{print $2}'`
+  echo "$kind $thread $rratio $cs $locknum $timeout $tps $tor $p50 $p99 $p999 $fair" >> $result
+done
+done
+done
+done
+done
+done
@@ -7,6 +7,7 @@
 #include "../../include/cache_line_size.hh"
 #include "../../include/config.hh"
 #include "../../include/int64byte.hh"
+#include "../../include/maintenance.hh"
 #include "../../include/masstree_wrapper.hh"
 #include "../../include/random.hh"
 
@@ -34,12 +35,27 @@ DEFINE_uint64(clocks_per_us, 2100,
               "CPU_MHz. Use this info for measuring time.");
 DEFINE_uint64(epoch_time, 40, "Epoch interval[msec].");
 DEFINE_uint64(extime, 3, "Execution time[sec].");
+DEFINE_uint64(maintenance_tick_us, 100,
+              "Tick of the maintenance thread[us]. It is used by "
+              "MAINTENANCE_THREAD.");
 DEFINE_uint64(max_ope, 10,
               "Total number of operations per single transaction.");
 DEFINE_uint64(per_xx_temp, 4096, "What record size (bytes) does it integrate about temperature statistics.");
 DEFINE_bool(rmw, false,
             "True means read modify write, false means blind write.");
 DEFINE_uint64(rratio, 50, "read ratio of single transaction.");
+DEFINE_uint64(temp_half_life, 1,
+              "Temperature halves every this number of epochs. It is used by "
+              "TEMPERATURE_DECAY.");
+DEFINE_string(temp_heatmap, "",
+              "File to which it dumps the temperature of each page at the "
+              "end. Empty means no dump.");
+DEFINE_uint64(temp_split_gap, 3,
+              "A page whose temperature is higher than its neighbours' by "
+              "this is split into finer pages.");
+DEFINE_uint64(temp_split_max, 0,
+              "Max number of pages which are split into finer pages. 0 means "
+              "fixed per_xx_temp.");
 DEFINE_uint64(thread_num, 10, "Total number of worker threads.");
 DEFINE_uint64(tuple_num, 1000000, "Total number of records.");
 DEFINE_bool(ycsb, true,
@@ -49,10 +65,15 @@ DEFINE_double(zipf_skew, 0, "zipf skew. 0 ~ 0.999...");
 DECLARE_uint64(clocks_per_us);
 DECLARE_uint64(epoch_time);
 DECLARE_uint64(extime);
+DECLARE_uint64(maintenance_tick_us);
 DECLARE_uint64(max_ope);
 DECLARE_uint64(per_xx_temp);
 DECLARE_bool(rmw);
 DECLARE_uint64(rratio);
+DECLARE_uint64(temp_half_life);
+DECLARE_string(temp_heatmap);
+DECLARE_uint64(temp_split_gap);
+DECLARE_uint64(temp_split_max);
 DECLARE_uint64(thread_num);
 DECLARE_uint64(tuple_num);
 DECLARE_bool(ycsb);
@@ -60,8 +81,17 @@ DECLARE_double(zipf_skew);
 #endif
 
 GLOBAL RWLock CtrLock;
+GLOBAL MaintenanceStat EpochStat;
 // temperature, min 0, max 20
 alignas(PAGE_SIZE) GLOBAL Epotemp *EpotempAry;
+// index of the finer pages of each page in TempSplitPool + 1. 0 means the page
+// isn't split. it is used if temp_split_max > 0.
+alignas(CACHE_LINE_SIZE) GLOBAL uint32_t *TempSplitAry;
+// temp_split_max sets of TEMP_SPLIT finer pages.
+alignas(PAGE_SIZE) GLOBAL Epotemp *TempSplitPool;
+// statistics of splitting pages. only the leader updates them.
+GLOBAL uint64_t TempSplits;
+GLOBAL uint64_t TempMerges;
 
 // for logging emulation
 alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte *Start;
@@ -69,13 +99,6 @@ alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte *Stop;
 
 alignas(CACHE_LINE_SIZE) GLOBAL Tuple *Table;
 
-// 下記，ifdef で外すと lock.cc のコードから
-// 参照出来なくてエラーが起きる．
-// lock.hh, lock.cc の全てを ifdef で分岐させるのは大変な労力なので，
-// 行わず，これは RWLOCK モードでも宣言だけしておく．
-alignas(CACHE_LINE_SIZE) GLOBAL MQLNode **MQLNodeTable;
-// first dimension index number corresponds to the thread number.
-// second dimension index number corresponds to the key of records.
-// the element mean MQLnode whihch is owned by the thread which has the thread
-// number corresponding to index number. for MQL sentinel value index 0 mean
-// None. index 1 mean Acquired. index 2 mean SuccessorLeaving.
+// MQLOCK : MQLNodePool (include/mql_lock.hh) holds the queue nodes. after the
+// sentinels, each thread owns FLAGS_max_ope nodes, that is, the nodes of
+// thread thid are MQL_NODE_ID_BASE + thid * FLAGS_max_ope + [0, FLAGS_max_ope).
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "../../include/atomic_wrapper.hh"
+#include "../../include/inline.hh"
+#include "../../include/random.hh"
+#include "../../include/result.hh"
+#include "atomic_tool.hh"
+#include "common.hh"
+#include "tuple.hh"
+
+/**
+ * @brief Temperature word of the record.
+ * @detail Records of per_xx_temp bytes (a page) share a temperature. If the
+ * page is split (temp_split_max > 0), the record uses the finer page which it
+ * belongs to.
+ * @param [in] key The key of key-value.
+ * @return pointer to the temperature word.
+ */
+INLINE Epotemp *temperatureOf(uint64_t key) {
+  uint64_t offset = key * sizeof(Tuple);
+  size_t page = offset / FLAGS_per_xx_temp;
+  if (FLAGS_temp_split_max) {
+    uint32_t split = loadAcquire(TempSplitAry[page]);
+    if (split != 0)
+      return &TempSplitPool[(split - 1) * TEMP_SPLIT +
+                            offset % FLAGS_per_xx_temp * TEMP_SPLIT /
+                                FLAGS_per_xx_temp];
+  }
+  return &EpotempAry[page];
+}
+
+/**
+ * @brief Temperature at the epoch.
+ * @detail Temperature is an approximate logarithmic counter of aborts, so
+ * halving the count is decrementing the temperature. With TEMPERATURE_DECAY, it
+ * decrements once per temp_half_life epochs since the epoch of epotemp, instead
+ * of resetting to 0 at every epoch. The epoch advances by the decayed epochs.
+ * @param [in] epotemp temperature word.
+ * @param [in] nowepo current global epoch.
+ * @return decayed temperature word.
+ */
+INLINE Epotemp decayTemperature(Epotemp epotemp,
+                                [[maybe_unused]] uint64_t nowepo) {
+#if TEMPERATURE_DECAY
+  if (nowepo <= epotemp.epoch) return epotemp;
+  uint64_t halves = (nowepo - epotemp.epoch) / FLAGS_temp_half_life;
+  if (halves == 0) return epotemp;
+  epotemp.temp = epotemp.temp > halves ? epotemp.temp - halves : 0;
+  epotemp.epoch = epotemp.epoch + halves * FLAGS_temp_half_life;
+#endif
+  return epotemp;
+}
+
+/**
+ * @brief Load the temperature of the record.
+ * @param [in] key The key of key-value.
+ * @return temperature.
+ */
+INLINE uint64_t loadTemperature(uint64_t key) {
+  Epotemp epotemp;
+  epotemp.obj_ = loadAcquire(temperatureOf(key)->obj_);
+#if TEMPERATURE_DECAY
+  epotemp = decayTemperature(epotemp, (loadAcquireGE()).obj_);
+#endif
+  return epotemp.temp;
+}
+
+/**
+ * @brief Raise the temperature of the record because an access to it aborted
+ * its transaction.
+ * @detail It increments temperature with probability 1 / 2^temperature, so
+ * hot records are rarely written. With TEMPERATURE_DECAY, it tries the CAS
+ * only once. If another thread updated it, this sample is dropped.
+ * @param [in] key The key of key-value.
+ * @param [in] rnd random generator of this thread.
+ * @param [in] res result of this thread.
+ * @return void
+ */
+INLINE void heatUp(uint64_t key, Xoroshiro128Plus &rnd,
+                   [[maybe_unused]] Result &res) {
+  Epotemp *epotemp = temperatureOf(key);
+  Epotemp expected, desired;
+  expected.obj_ = loadAcquire(epotemp->obj_);
+
+#if TEMPERATURE_DECAY
+  desired = decayTemperature(expected, (loadAcquireGE()).obj_);
+  if (desired.temp == TEMP_MAX || rnd.next() % (1 << desired.temp) != 0)
+    return;
+  ++desired.temp;
+  if (compareExchange(epotemp->obj_, expected.obj_, desired.obj_)) {
+#if ADD_ANALYSIS
+    ++res.local_temperature_updates_;
+#endif
+  }
+#else
+#if TEMPERATURE_RESET_OPT
+  uint64_t nowepo;
+  nowepo = (loadAcquireGE()).obj_;
+  if (expected.epoch != nowepo) {
+    desired.epoch = nowepo;
+    desired.temp = 0;
+    storeRelease(epotemp->obj_, desired.obj_);
+    expected = desired;
+#if ADD_ANALYSIS
+    ++res.local_temperature_resets_;
+#endif
+  }
+#endif
+
+  for (;;) {
+    if (expected.temp == TEMP_MAX) {
+      break;
+    } else if (rnd.next() % (1 << expected.temp) == 0) {
+      desired = expected;
+      desired.temp = expected.temp + 1;
+    } else {
+      break;
+    }
+
+    if (compareExchange(epotemp->obj_, expected.obj_, desired.obj_)) {
+#if ADD_ANALYSIS
+      ++res.local_temperature_updates_;
+#endif
+      break;
+    }
+  }
+#endif
+}
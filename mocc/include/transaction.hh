@@ -1,5 +1,6 @@
 #pragma once
 
+#include <deque>
 #include <vector>
 
 #include "../../include/procedure.hh"
@@ -25,12 +26,14 @@ class TxExecutor {
   vector<WriteElement<Tuple>> write_set_;
   vector<Procedure> pro_set_;
 #ifdef RWLOCK
-  vector<LockElement<RWLock>> RLL_;
-  vector<LockElement<RWLock>> CLL_;
+  vector<LockElement<SelectedLock>> RLL_;
+  vector<LockElement<SelectedLock>> CLL_;
 #endif  // RWLOCK
 #ifdef MQLOCK
   vector<LockElement<MQLock>> RLL_;
   vector<LockElement<MQLock>> CLL_;
+  // ids of free queue nodes of this thread. released nodes are reused last.
+  std::deque<uint32_t> qnode_free_;
 #endif  // MQLOCK
   TransactionStatus status_;
 
@@ -58,18 +61,30 @@ class TxExecutor {
     max_wset_.obj_ = 0;
 
     genStringRepeatedNumber(write_val_, VAL_SIZE, thid);
+
+#ifdef MQLOCK
+    for (uint32_t i = 0; i < FLAGS_max_ope; ++i)
+      qnode_free_.emplace_back(MQL_NODE_ID_BASE + thid * FLAGS_max_ope + i);
+#endif  // MQLOCK
   }
 
   ReadElement<Tuple> *searchReadSet(uint64_t key);
   WriteElement<Tuple> *searchWriteSet(uint64_t key);
   template <typename T>
   T *searchRLL(uint64_t key);
+#ifdef RWLOCK
+  LockElement<SelectedLock> *searchCLL(uint64_t key);
+#endif  // RWLOCK
   void removeFromCLL(uint64_t key);
   void begin();
   void read(uint64_t key);
   void write(uint64_t key);
   void read_write(uint64_t key);
   void lock(uint64_t key, Tuple *tuple, bool mode);
+#ifdef MQLOCK
+  bool mqlLock(uint64_t key, MQLock *lock, bool mode, bool trylock);
+  void mqlUnlock(LockElement<MQLock> &le);
+#endif  // MQLOCK
   void construct_RLL();  // invoked on abort;
   void unlockCLL();
   bool commit();
@@ -11,6 +11,8 @@
 #define TEMP_THRESHOLD 5
 #define TEMP_MAX 20
 #define TEMP_RESET_US 100
+// the number of finer pages into which a hot page is split.
+#define TEMP_SPLIT 16
 
 struct Tidword {
   union {
@@ -59,8 +61,8 @@ class Tuple {
  public:
   alignas(CACHE_LINE_SIZE) Tidword tidword_;
 #ifdef RWLOCK
-  RWLock rwlock_;  // 4byte
-  // size to here is 20 bytes
+  // lock of the include/locks.hh chosen by LOCK_KIND.
+  SelectedLock rwlock_;
 #endif
 #ifdef MQLOCK
   MQLock mqlock_;
@@ -1,5 +1,7 @@
 #pragma once
 
+extern void adaptTemperatureGranularity();
+
 extern void chkArg();
 
 extern bool chkEpochLoaded();
@@ -8,6 +10,8 @@ extern void displayDB();
 
 extern void displayParameter();
 
+extern void dumpTemperatureHeatMap();
+
 extern void displayLockedTuple();
 
 extern void leaderWork(uint64_t &epoch_timer_start, uint64_t &epoch_timer_stop,
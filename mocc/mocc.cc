@@ -33,7 +33,9 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
   rnd.init();
   TxExecutor trans(thid, &rnd, (Result*)&MoccResult[thid]);
   FastZipf zipf(&rnd, FLAGS_zipf_skew, FLAGS_tuple_num);
+#if !MAINTENANCE_THREAD
   uint64_t epoch_timer_start, epoch_timer_stop;
+#endif
   Backoff backoff(FLAGS_clocks_per_us);
   Result& myres = std::ref(MoccResult[thid]);
 
@@ -47,13 +49,17 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
 
   storeRelease(ready, 1);
   while (!loadAcquire(start)) _mm_pause();
+#if !MAINTENANCE_THREAD
   if (thid == 0) epoch_timer_start = rdtscp();
+#endif
   while (!loadAcquire(quit)) {
     makeProcedure(trans.pro_set_, rnd, zipf, FLAGS_tuple_num, FLAGS_max_ope, FLAGS_thread_num,
                   FLAGS_rratio, FLAGS_rmw, FLAGS_ycsb, false, thid, myres);
   RETRY:
     if (thid == 0) {
+#if !MAINTENANCE_THREAD
       leaderWork(epoch_timer_start, epoch_timer_stop, myres);
+#endif
       leaderBackoffWork(backoff, MoccResult);
     }
     if (loadAcquire(quit)) break;
@@ -118,16 +124,46 @@ int main(int argc, char* argv[]) try {
                      std::ref(quit));
   waitForReady(readys);
   storeRelease(start, true);
+#if MAINTENANCE_THREAD
+  Result maintenance_res;
+  MaintenanceThread maintainer;
+  maintainer.start(FLAGS_maintenance_tick_us, FLAGS_clocks_per_us,
+                   [epoch_timer_start = rdtscp(), epoch_timer_stop = uint64_t(0),
+                    &maintenance_res]() mutable {
+                     leaderWork(epoch_timer_start, epoch_timer_stop,
+                                maintenance_res);
+                   });
+#endif
   for (size_t i = 0; i < FLAGS_extime; ++i) {
     sleepMs(1000);
   }
   storeRelease(quit, true);
   for (auto& th : thv) th.join();
+#if MAINTENANCE_THREAD
+  maintainer.stop();
+  MoccResult[0].addLocalAllResult(maintenance_res);
+#endif
 
   for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
     MoccResult[0].addLocalAllResult(MoccResult[i]);
   }
   MoccResult[0].displayAllResult(FLAGS_clocks_per_us, FLAGS_extime, FLAGS_thread_num);
+  EpochStat.display("epoch", FLAGS_clocks_per_us);
+#if MAINTENANCE_THREAD
+  maintainer.display();
+#endif
+#ifdef MQLOCK
+  // queue nodes are per thread, so this doesn't depend on tuple_num.
+  cout << "mql_qnode_bytes:\t"
+       << MQLNodePoolSize * sizeof(MQLNode)
+       << endl;
+#endif  // MQLOCK
+  cout << "tuple_bytes:\t" << sizeof(Tuple) << endl;
+  if (FLAGS_temp_split_max) {
+    cout << "temp_splits:\t" << TempSplits << endl;
+    cout << "temp_merges:\t" << TempMerges << endl;
+  }
+  if (!FLAGS_temp_heatmap.empty()) dumpTemperatureHeatMap();
 
   return 0;
 } catch (bad_alloc) {
@@ -10,6 +10,7 @@
 #include "../include/debug.hh"
 #include "../include/tsc.hh"
 #include "include/atomic_tool.hh"
+#include "include/temperature.hh"
 #include "include/transaction.hh"
 #include "include/tuple.hh"
 
@@ -62,6 +63,21 @@ T *TxExecutor::searchRLL(uint64_t key) {
   return nullptr;
 }
 
+/**
+ * @brief Search element from current lock list.
+ * @param key [in] The key of key-value
+ * @return Corresponding element of current lock list
+ */
+#ifdef RWLOCK
+LockElement<SelectedLock> *TxExecutor::searchCLL(uint64_t key) {
+  for (auto itr = CLL_.begin(); itr != CLL_.end(); ++itr) {
+    if ((*itr).key_ == key) return &(*itr);
+  }
+
+  return nullptr;
+}
+#endif  // RWLOCK
+
 /**
  * @brief Remove element from current lock list
  * @param [in] key The kye of key-value.
@@ -108,7 +124,6 @@ void TxExecutor::read(uint64_t key) {
   // Default constructor of these variable cause error (-fpermissive)
   // "crosses initialization of ..."
   // So it locate before first goto instruction.
-  Epotemp loadepot;
   Tidword expected, desired;
 
   /**
@@ -132,8 +147,8 @@ void TxExecutor::read(uint64_t key) {
 
   // tuple doesn't exist in read/write set.
 #ifdef RWLOCK
-  LockElement<RWLock> *inRLL;
-  inRLL = searchRLL<LockElement<RWLock>>(key);
+  LockElement<SelectedLock> *inRLL;
+  inRLL = searchRLL<LockElement<SelectedLock>>(key);
 #endif  // RWLOCK
 #ifdef MQLOCK
   LockElement<MQLock> *inRLL;
@@ -143,9 +158,8 @@ void TxExecutor::read(uint64_t key) {
   /**
    * Check corresponding temperature.
    */
-  size_t epotemp_index;
-  epotemp_index = key * sizeof(Tuple) / FLAGS_per_xx_temp;
-  loadepot.obj_ = loadAcquire(EpotempAry[epotemp_index].obj_);
+  uint64_t temp;
+  temp = loadTemperature(key);
   bool needVerification;
   needVerification = true;
 
@@ -165,12 +179,12 @@ void TxExecutor::read(uint64_t key) {
        * Because it could acquire lock.
        */
     }
-  } else if (loadepot.temp >= TEMP_THRESHOLD) {
+  } else if (temp >= TEMP_THRESHOLD) {
     /**
      * This transaction is not after abort, 
      * however, it accesses high temperature record.
      */
-    // printf("key:\t%lu, temp:\t%lu\n", key, loadepot.temp_);
+    // printf("key:\t%lu, temp:\t%lu\n", key, temp);
     lock(key, tuple, false);
     if (this->status_ == TransactionStatus::aborted) {
       /**
@@ -192,8 +206,11 @@ void TxExecutor::read(uint64_t key) {
     expected.obj_ = __atomic_load_n(&(tuple->tidword_.obj_), __ATOMIC_ACQUIRE);
     for (;;) {
 #ifdef RWLOCK
-      while (tuple->rwlock_.ldAcqCounter() == W_LOCKED) {
+      while (tuple->rwlock_.w_locked()) {
 #endif  // RWLOCK
+#ifdef MQLOCK
+      while (tuple->mqlock_.ldAcqWlocked()) {
+#endif  // MQLOCK
         /* if you wait due to being write-locked, it may occur dead lock.
         // it need to guarantee that this parts definitely progress.
         // So it sholud wait expected.lock because it will be released
@@ -246,11 +263,6 @@ void TxExecutor::write(uint64_t key) {
   uint64_t start = rdtscp();
 #endif
 
-  // these variable cause error (-fpermissive)
-  // "crosses initialization of ..."
-  // So it locate before first goto instruction.
-  Epotemp loadepot;
-
   // tuple exists in write set.
   if (searchWriteSet(key)) goto FINISH_WRITE;
 
@@ -279,25 +291,25 @@ void TxExecutor::write(uint64_t key) {
   /**
    * Check corresponding temperature.
    */
-  size_t epotemp_index;
-  epotemp_index = key * sizeof(Tuple) / FLAGS_per_xx_temp;
-  loadepot.obj_ = loadAcquire(EpotempAry[epotemp_index].obj_);
+  uint64_t temp;
+  temp = loadTemperature(key);
 
   /**
    * If this record has high temperature, use lock.
    */
-  if (loadepot.temp >= TEMP_THRESHOLD) lock(key, tuple, true);
+  if (temp >= TEMP_THRESHOLD) lock(key, tuple, true);
   /**
    * If it failed locking, it aborts.
    */
   if (this->status_ == TransactionStatus::aborted) goto FINISH_WRITE;
 
 #ifdef RWLOCK
-  LockElement<RWLock> *inRLL;
-  inRLL = searchRLL<LockElement<RWLock>>(key);
+  LockElement<SelectedLock> *inRLL;
+  inRLL = searchRLL<LockElement<SelectedLock>>(key);
 #endif  // RWLOCK
 #ifdef MQLOCK
-  LockElement<MQLock> *inRLL = searchRLL<LockElement<MQLock>>(key);
+  LockElement<MQLock> *inRLL;
+  inRLL = searchRLL<LockElement<MQLock>>(key);
 #endif  // MQLOCK
   if (inRLL != nullptr) lock(key, tuple, true);
   if (this->status_ == TransactionStatus::aborted) goto FINISH_WRITE;
@@ -316,7 +328,6 @@ void TxExecutor::read_write(uint64_t key) {
   // Default constructor of these variable cause error (-fpermissive)
   // "crosses initialization of ..."
   // So it locate before first goto instruction.
-  Epotemp loadepot;
   Tidword expected, desired;
 
   Tuple *tuple;
@@ -342,8 +353,8 @@ void TxExecutor::read_write(uint64_t key) {
 
   // tuple doesn't exist in read/write set.
 #ifdef RWLOCK
-  LockElement<RWLock> *inRLL;
-  inRLL = searchRLL<LockElement<RWLock>>(key);
+  LockElement<SelectedLock> *inRLL;
+  inRLL = searchRLL<LockElement<SelectedLock>>(key);
 #endif  // RWLOCK
 #ifdef MQLOCK
   LockElement<MQLock> *inRLL;
@@ -353,9 +364,8 @@ void TxExecutor::read_write(uint64_t key) {
   /**
    * Check corresponding temperature.
    */
-  size_t epotemp_index;
-  epotemp_index = key * sizeof(Tuple) / FLAGS_per_xx_temp;
-  loadepot.obj_ = loadAcquire(EpotempAry[epotemp_index].obj_);
+  uint64_t temp;
+  temp = loadTemperature(key);
   bool needVerification;
   needVerification = true;
 
@@ -366,8 +376,8 @@ void TxExecutor::read_write(uint64_t key) {
     } else {
       needVerification = false;
     }
-  } else if (loadepot.temp >= TEMP_THRESHOLD) {
-    // printf("key:\t%lu, temp:\t%lu\n", key, loadepot.temp_);
+  } else if (temp >= TEMP_THRESHOLD) {
+    // printf("key:\t%lu, temp:\t%lu\n", key, temp);
     // this lock for write, so write-mode.
     lock(key, tuple, true);
     if (this->status_ == TransactionStatus::aborted) {
@@ -381,8 +391,11 @@ void TxExecutor::read_write(uint64_t key) {
     expected.obj_ = __atomic_load_n(&(tuple->tidword_.obj_), __ATOMIC_ACQUIRE);
     for (;;) {
 #ifdef RWLOCK
-      while (tuple->rwlock_.ldAcqCounter() == W_LOCKED) {
+      while (tuple->rwlock_.w_locked()) {
 #endif  // RWLOCK
+#ifdef MQLOCK
+      while (tuple->mqlock_.ldAcqWlocked()) {
+#endif  // MQLOCK
         /* if you wait due to being write-locked, it may occur dead lock.
         // it need to guarantee that this parts definitely progress.
         // So it sholud wait expected.lock because it will be released
@@ -433,11 +446,14 @@ void TxExecutor::lock(uint64_t key, Tuple *tuple, bool mode) {
   bool upgrade = false;
 
 #ifdef RWLOCK
-  LockElement<RWLock> *le = nullptr;
+  LockElement<SelectedLock> *le = nullptr;
 #endif  // RWLOCK
+#ifdef MQLOCK
+  LockElement<MQLock> *le = nullptr;
+#endif  // MQLOCK
   // RWLOCK : アップグレードするとき，CLL_ ループで該当する
   // エレメントを記憶しておき，そのエレメントを更新するため．
-  // MQLOCK : アップグレード機能が無いので，不要．
+  // MQLOCK : アップグレード機能が無いので，
   // reader ロックを解放して，CLL_ から除去して，writer ロックをかける．
 
   // lock exists in CLL_ (current lock list)
@@ -450,9 +466,7 @@ void TxExecutor::lock(uint64_t key, Tuple *tuple, bool mode) {
       if (mode == (*itr).mode_ || mode < (*itr).mode_)
         return;
       else {
-#ifdef RWLOCK
         le = &(*itr);
-#endif  // RWLOCK
         upgrade = true;
       }
     }
@@ -476,7 +490,7 @@ void TxExecutor::lock(uint64_t key, Tuple *tuple, bool mode) {
 #ifdef RWLOCK
     if (mode) {
       if (upgrade) {
-        if (tuple->rwlock_.upgrade()) {
+        if (tuple->rwlock_.tryupgrade()) {
           le->mode_ = true;
           return;
         } else {
@@ -484,7 +498,7 @@ void TxExecutor::lock(uint64_t key, Tuple *tuple, bool mode) {
           return;
         }
       } else if (tuple->rwlock_.w_trylock()) {
-        CLL_.push_back(LockElement<RWLock>(key, &(tuple->rwlock_), true));
+        CLL_.push_back(LockElement<SelectedLock>(key, &(tuple->rwlock_), true));
         return;
       } else {
         this->status_ = TransactionStatus::aborted;
@@ -492,7 +506,7 @@ void TxExecutor::lock(uint64_t key, Tuple *tuple, bool mode) {
       }
     } else {
       if (tuple->rwlock_.r_trylock()) {
-        CLL_.push_back(LockElement<RWLock>(key, &(tuple->rwlock_), false));
+        CLL_.push_back(LockElement<SelectedLock>(key, &(tuple->rwlock_), false));
         return;
       } else {
         this->status_ = TransactionStatus::aborted;
@@ -501,36 +515,13 @@ void TxExecutor::lock(uint64_t key, Tuple *tuple, bool mode) {
     }
 #endif  // RWLOCK
 #ifdef MQLOCK
-    if (mode) {
-      if (upgrade) {
-        tuple->mqlock.release_reader_lock(this->locknum, key);
-        removeFromCLL(key);
-        if (tuple->mqlock.acquire_writer_lock(this->locknum, key, true) ==
-            MQL_RESULT::Acquired) {
-          CLL_.push_back(LockElement<MQLock>(key, &(tuple->mqlock), true));
-          return;
-        } else {
-          this->status = TransactionStatus::aborted;
-          return;
-        }
-      } else if (tuple->mqlock.acquire_writer_lock(this->locknum, key, true) ==
-                 MQL_RESULT::Acquired) {
-        CLL_.push_back(LockElement<MQLock>(key, &(tuple->mqlock), true));
-        return;
-      } else {
-        this->status = TransactionStatus::aborted;
-        return;
-      }
-    } else {
-      if (tuple->mqlock.acquire_reader_lock(this->locknum, key, true) ==
-          MQL_RESULT::Acquired) {
-        CLL_.push_back(LockElement<MQLock>(key, &(tuple->mqlock), false));
-        return;
-      } else {
-        this->status = TransactionStatus::aborted;
-        return;
-      }
+    if (upgrade) {
+      mqlUnlock(*le);
+      removeFromCLL(key);
     }
+    if (!mqlLock(key, &(tuple->mqlock_), mode, true))
+      this->status_ = TransactionStatus::aborted;
+    return;
 #endif  // MQLOCK
   }
 
@@ -546,10 +537,7 @@ void TxExecutor::lock(uint64_t key, Tuple *tuple, bool mode) {
 #endif  // RWLOCK
 
 #ifdef MQLOCK
-      if ((*itr).mode_)
-        (*itr).lock_->release_writer_lock(this->locknum, key);
-      else
-        (*itr).lock_->release_reader_lock(this->locknum, key);
+      mqlUnlock(*itr);
 #endif  // MQLOCK
     }
 
@@ -569,16 +557,12 @@ void TxExecutor::lock(uint64_t key, Tuple *tuple, bool mode) {
         (*itr).lock_->w_lock();
       else
         (*itr).lock_->r_lock();
+      CLL_.emplace_back((*itr).key_, (*itr).lock_, (*itr).mode_);
 #endif  // RWLOCK
 
 #ifdef MQLOCK
-      if ((*itr).mode_)
-        (*itr).lock_->acquire_writer_lock(this->locknum, key);
-      else
-        (*itr).lock_->acquire_reader_lock(this->locknum, key);
+      mqlLock((*itr).key_, (*itr).lock_, (*itr).mode_, false);
 #endif  // MQLOCK
-
-      CLL_.emplace_back((*itr).key_, (*itr).lock_, (*itr).mode_);
     } else
       break;
   }
@@ -593,15 +577,60 @@ void TxExecutor::lock(uint64_t key, Tuple *tuple, bool mode) {
 #endif  // RWLOCK
 
 #ifdef MQLOCK
-  if (mode)
-    tuple->mqlock.acquire_writer_lock(this->locknum, key, false);
-  else
-    tuple->mqlock.acquire_reader_lock(this->locknum, key, false);
-  CLL_.push_back(LockElement<MQLock>(key, tuple->mqlock, mode));
+  mqlLock(key, &(tuple->mqlock_), mode, false);
   return;
 #endif  // MQLOCK
 }
 
+#ifdef MQLOCK
+/**
+ * @brief Acquire MQL lock with a free queue node of this thread.
+ * @param [in] key The key of key-value.
+ * @param [in] lock MQL lock of the record.
+ * @param [in] mode 0 read-mode, 1 write-mode.
+ * @param [in] trylock If this is true, it cancels the acquisition when it
+ * isn't granted at once.
+ * @return true if it acquired the lock and appended it to CLL_.
+ */
+bool TxExecutor::mqlLock(uint64_t key, MQLock *lock, bool mode, bool trylock) {
+  // CLL_ never has more than max_ope locks, so a node is always free.
+  if (qnode_free_.empty()) ERR;
+  uint32_t qnode = qnode_free_.front();
+  qnode_free_.pop_front();
+
+  MQL_RESULT result;
+  if (mode)
+    result = lock->acquire_writer_lock(qnode, key, trylock);
+  else
+    result = lock->acquire_reader_lock(qnode, key, trylock);
+  if (result != MQL_RESULT::Acquired) {
+    // the node left the queue by cancellation.
+    qnode_free_.emplace_back(qnode);
+    return false;
+  }
+
+  // seq_cst keeps the validation of my read set from being reordered before
+  // the flag, which a concurrent validation of the record reads.
+  if (mode) lock->wlocked.store(true, std::memory_order_seq_cst);
+  CLL_.emplace_back(key, lock, mode, qnode);
+  return true;
+}
+
+/**
+ * @brief Release MQL lock and return its queue node to the pool.
+ * @param [in] le The element of CLL_. The caller removes it from CLL_.
+ * @return void
+ */
+void TxExecutor::mqlUnlock(LockElement<MQLock> &le) {
+  if (le.mode_) {
+    le.lock_->wlocked.store(false, std::memory_order_release);
+    le.lock_->release_writer_lock(le.qnode_, le.key_);
+  } else
+    le.lock_->release_reader_lock(le.qnode_, le.key_);
+  qnode_free_.emplace_back(le.qnode_);
+}
+#endif  // MQLOCK
+
 void TxExecutor::construct_RLL() {
   RLL_.clear();
 
@@ -610,56 +639,23 @@ void TxExecutor::construct_RLL() {
     RLL_.emplace_back((*itr).key_, &((*itr).rcdptr_->rwlock_), true);
 #endif  // RWLOCK
 #ifdef MQLOCK
-    RLL_.push_back(
-        LockElement<MQLock>((*itr).key_, &(Table[(*itr).key_].mqlock), true));
+    RLL_.emplace_back((*itr).key_, &((*itr).rcdptr_->mqlock_), true);
 #endif  // MQLOCK
   }
 
   for (auto itr = read_set_.begin(); itr != read_set_.end(); ++itr) {
     // maintain temprature p
-    size_t epotemp_index = (*itr).key_ * sizeof(Tuple) / FLAGS_per_xx_temp;
     if ((*itr).failed_verification_) {
       /**
        * This transaction aborted by this operation.
        * So our custom optimization does temperature management targeting this record.
        */
-      Epotemp expected, desired;
-      expected.obj_ = loadAcquire(EpotempAry[epotemp_index].obj_);
-
-#if TEMPERATURE_RESET_OPT
-      uint64_t nowepo;
-      nowepo = (loadAcquireGE()).obj_;
-      if (expected.epoch != nowepo) {
-        desired.epoch = nowepo;
-        desired.temp = 0;
-        storeRelease(EpotempAry[epotemp_index].obj_, desired.obj_);
-#if ADD_ANALYSIS
-        ++mres_->local_temperature_resets_;
-#endif
-      }
-#endif
-
-      for (;;) {
-        // printf("key:\t%lu,\ttemp_index:\t%zu,\ttemp:\t%lu\n", (*itr).key_,
-        // epotemp_index, expected.temp_);
-        if (expected.temp == TEMP_MAX) {
-          break;
-        } else if (rnd_->next() % (1 << expected.temp) == 0) {
-          desired = expected;
-          desired.temp = expected.temp + 1;
-        } else {
-          break;
-        }
-
-        if (compareExchange(EpotempAry[epotemp_index].obj_, expected.obj_,
-                            desired.obj_))
-          break;
-      }
+      heatUp((*itr).key_, *rnd_, *mres_);
     }
 
     // check whether itr exists in RLL_
 #ifdef RWLOCK
-    if (searchRLL<LockElement<RWLock>>((*itr).key_) != nullptr) continue;
+    if (searchRLL<LockElement<SelectedLock>>((*itr).key_) != nullptr) continue;
 #endif  // RWLOCK
 #ifdef MQLOCK
     if (searchRLL<LockElement<MQLock>>((*itr).key_) != nullptr) continue;
@@ -668,15 +664,13 @@ void TxExecutor::construct_RLL() {
     // r not in RLL_
     // if temprature >= threshold
     //  || r failed verification
-    Epotemp loadepot;
-    loadepot.obj_ = loadAcquire(EpotempAry[epotemp_index].obj_);
-    if (loadepot.temp >= TEMP_THRESHOLD || (*itr).failed_verification_) {
+    if (loadTemperature((*itr).key_) >= TEMP_THRESHOLD ||
+        (*itr).failed_verification_) {
 #ifdef RWLOCK
       RLL_.emplace_back((*itr).key_, &((*itr).rcdptr_->rwlock_), false);
 #endif  // RWLOCK
 #ifdef MQLOCK
-      RLL_.push_back(
-          LockElement<MQLock>((*itr).key_, &((*itr).rcdptr_->mqlock_), false));
+      RLL_.emplace_back((*itr).key_, &((*itr).rcdptr_->mqlock_), false);
 #endif  // MQLOCK
     }
   }
@@ -721,9 +715,15 @@ bool TxExecutor::commit() {
 
     // Silo protocol
 #ifdef RWLOCK
-    if ((*itr).rcdptr_->rwlock_.ldAcqCounter() == W_LOCKED &&
-        searchWriteSet((*itr).key_) == nullptr) {
+    // with exclusive locks, a record which I read-locked looks write-locked.
+    if ((*itr).rcdptr_->rwlock_.w_locked() &&
+        searchWriteSet((*itr).key_) == nullptr &&
+        searchCLL((*itr).key_) == nullptr) {
 #endif  // RWLOCK
+#ifdef MQLOCK
+    if ((*itr).rcdptr_->mqlock_.ldAcqWlocked() &&
+        searchWriteSet((*itr).key_) == nullptr) {
+#endif  // MQLOCK
       // if the rwlock is already acquired and the owner isn't me, abort.
       (*itr).failed_verification_ = true;
       this->status_ = TransactionStatus::aborted;
@@ -783,11 +783,8 @@ void TxExecutor::unlockCLL() {
 #endif  // RWLOCK
 
 #ifdef MQLOCK
-    if ((*itr).mode_) {
-      (*itr).lock_->release_writer_lock(this->locknum, (*itr).key_);
-    } else
-      (*itr).lock_->release_reader_lock(this->locknum, (*itr).key_);
-#endif
+    mqlUnlock(*itr);
+#endif  // MQLOCK
   }
   CLL_.clear();
 }
@@ -13,6 +13,7 @@
 #include <iostream>
 #include <limits>
 #include <random>
+#include <vector>
 
 #include "../include/atomic_wrapper.hh"
 #include "../include/config.hh"
@@ -25,6 +26,7 @@
 #include "../include/zipf.hh"
 #include "include/atomic_tool.hh"
 #include "include/common.hh"
+#include "include/temperature.hh"
 #include "include/tuple.hh"
 #include "include/util.hh"
 
@@ -53,6 +55,11 @@ void chkArg() {
     ERR;
   }
 
+  if (FLAGS_temp_half_life == 0) {
+    cout << "FLAGS_temp_half_life must be larger than 0." << endl;
+    ERR;
+  }
+
   if (posix_memalign((void **)&Start, 64,
                      FLAGS_thread_num * sizeof(uint64_t_64byte)) != 0)
     ERR;
@@ -63,12 +70,12 @@ void chkArg() {
                      FLAGS_thread_num * sizeof(uint64_t_64byte)) != 0)
     ERR;
 #ifdef MQLOCK
-  // if (posix_memalign((void**)&MQLNodeList, 64, (FLAGS_thread_num + 3) *
-  // sizeof(MQLNode)) != 0) ERR;
-  MQLNodeTable = new MQLNode *[FLAGS_thread_num + 3];
-  for (unsigned int i = 0; i < FLAGS_thread_num + 3; ++i)
-    MQLNodeTable[i] = new MQLNode[FLAGS_tuple_num];
+  // a transaction holds at most FLAGS_max_ope locks at a time.
+  initMQLNodePool(FLAGS_thread_num * FLAGS_max_ope);
 #endif  // MQLOCK
+#ifdef RWLOCK
+  SelectedLock::initGlobal(FLAGS_thread_num);
+#endif  // RWLOCK
 
   for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
     ThLocalEpoch[i].obj_ = 0;
@@ -83,7 +90,12 @@ void displayDB() {
     cout << "----------" << endl;  // - is 10
     cout << "key: " << i << endl;
     cout << "val: " << tuple->val_ << endl;
-    cout << "lockctr: " << tuple->rwlock_.counter_ << endl;
+#ifdef RWLOCK
+    cout << "wlocked: " << tuple->rwlock_.w_locked() << endl;
+#endif  // RWLOCK
+#ifdef MQLOCK
+    cout << "wlocked: " << tuple->mqlock_.ldAcqWlocked() << endl;
+#endif  // MQLOCK
     cout << "TIDword: " << tuple->tidword_.obj_ << endl;
     cout << "bit: " << static_cast<bitset<64>>(tuple->tidword_.obj_) << endl;
     cout << endl;
@@ -93,8 +105,11 @@ void displayDB() {
 void displayLockedTuple() {
   for (unsigned int i = 0; i < FLAGS_tuple_num; ++i) {
 #ifdef RWLOCK
-    if (Table[i].rwlock_.counter_.load(memory_order_relaxed) == -1) {
+    if (Table[i].rwlock_.w_locked()) {
 #endif  // RWLOCK
+#ifdef MQLOCK
+    if (Table[i].mqlock_.ldAcqWlocked()) {
+#endif  // MQLOCK
       cout << "key : " << i << " is locked!." << endl;
     }
   }
@@ -104,10 +119,15 @@ void displayParameter() {
   cout << "#FLAGS_clocks_per_us:\t" << FLAGS_clocks_per_us << endl;
   cout << "#FLAGS_epoch_time:\t" << FLAGS_epoch_time << endl;
   cout << "#FLAGS_extime:\t\t" << FLAGS_extime << endl;
+  cout << "#FLAGS_maintenance_tick_us:\t" << FLAGS_maintenance_tick_us << endl;
   cout << "#FLAGS_max_ope:\t\t" << FLAGS_max_ope << endl;
   cout << "#FLAGS_per_xx_temp\t" << FLAGS_per_xx_temp << endl;
   cout << "#FLAGS_rmw:\t\t" << FLAGS_rmw << endl;
   cout << "#FLAGS_rratio:\t\t" << FLAGS_rratio << endl;
+  cout << "#FLAGS_temp_half_life:\t" << FLAGS_temp_half_life << endl;
+  cout << "#FLAGS_temp_heatmap:\t" << FLAGS_temp_heatmap << endl;
+  cout << "#FLAGS_temp_split_gap:\t" << FLAGS_temp_split_gap << endl;
+  cout << "#FLAGS_temp_split_max:\t" << FLAGS_temp_split_max << endl;
   cout << "#FLAGS_thread_num:\t" << FLAGS_thread_num << endl;
   cout << "#FLAGS_tuple_num:\t" << FLAGS_tuple_num << endl;
   cout << "#FLAGS_ycsb:\t\t" << FLAGS_ycsb << endl;
@@ -126,6 +146,9 @@ void partTableInit([[maybe_unused]] size_t thid, uint64_t start, uint64_t end) {
     tmp->tidword_.tid = 0;
     tmp->val_[0] = 'a';
     tmp->val_[1] = '\0';
+#ifdef RWLOCK
+    tmp->rwlock_.init();
+#endif  // RWLOCK
 
     Epotemp epotemp(0, 1);
     size_t epotemp_index = i * sizeof(Tuple) / FLAGS_per_xx_temp;
@@ -151,6 +174,13 @@ void makeDB() {
   if (posix_memalign((void **)&EpotempAry, PAGE_SIZE,
                      epotemp_length * sizeof(Epotemp)) != 0)
     ERR;
+  if (FLAGS_temp_split_max) {
+    TempSplitAry = new uint32_t[epotemp_length]();
+    if (posix_memalign((void **)&TempSplitPool, PAGE_SIZE,
+                       FLAGS_temp_split_max * TEMP_SPLIT * sizeof(Epotemp)) !=
+        0)
+      ERR;
+  }
 
   size_t maxthread = decideParallelBuildNumber(FLAGS_tuple_num);
   std::vector<std::thread> thv;
@@ -163,7 +193,9 @@ void makeDB() {
 
 bool chkEpochLoaded() {
   uint64_t_64byte nowepo = loadAcquireGE();
-  for (unsigned int i = 1; i < FLAGS_thread_num; ++i) {
+  // Thread 0 is the leader unless the maintenance thread advances epochs.
+  for (unsigned int i = MAINTENANCE_THREAD ? 0 : 1; i < FLAGS_thread_num;
+       ++i) {
     if (__atomic_load_n(&(ThLocalEpoch[i].obj_), __ATOMIC_ACQUIRE) !=
         nowepo.obj_)
       return false;
@@ -181,9 +213,13 @@ void leaderWork(uint64_t &epoch_timer_start, uint64_t &epoch_timer_stop,
                  FLAGS_epoch_time * FLAGS_clocks_per_us * 1000) &&
       chkEpochLoaded()) {
     atomicAddGE();
+    EpochStat.record(epoch_timer_stop,
+                     FLAGS_epoch_time * FLAGS_clocks_per_us * 1000);
     epoch_timer_start = epoch_timer_stop;
 
-#if TEMPERATURE_RESET_OPT
+    // before the eager reset below clears the temperature of the last epoch.
+    if (FLAGS_temp_split_max) adaptTemperatureGranularity();
+#if TEMPERATURE_DECAY || TEMPERATURE_RESET_OPT
 #else
     size_t epotemp_length = FLAGS_tuple_num * sizeof(Tuple) / FLAGS_per_xx_temp + 1;
     uint64_t nowepo = (loadAcquireGE()).obj_;
@@ -191,6 +227,10 @@ void leaderWork(uint64_t &epoch_timer_start, uint64_t &epoch_timer_stop,
       Epotemp epotemp(0, nowepo);
       storeRelease(EpotempAry[i].obj_, epotemp.obj_);
     }
+    for (uint64_t i = 0; i < FLAGS_temp_split_max * TEMP_SPLIT; ++i) {
+      Epotemp epotemp(0, nowepo);
+      storeRelease(TempSplitPool[i].obj_, epotemp.obj_);
+    }
 #if ADD_ANALYSIS
     res.local_temperature_resets_ += epotemp_length;
 #endif
@@ -198,10 +238,151 @@ void leaderWork(uint64_t &epoch_timer_start, uint64_t &epoch_timer_stop,
   }
 }
 
+/**
+ * @brief Temperature which decides the granularity.
+ * @detail Without TEMPERATURE_DECAY, temperature is measured per epoch, so a
+ * word which wasn't updated in the last epoch is cold even if its count is
+ * left. TEMPERATURE_RESET_OPT resets it only at the next abort.
+ * @param [in] epotemp temperature word.
+ * @param [in] nowepo current global epoch.
+ * @return temperature.
+ */
+static uint64_t currentTemperature(Epotemp epotemp, uint64_t nowepo) {
+#if TEMPERATURE_DECAY
+  return decayTemperature(epotemp, nowepo).temp;
+#else
+  return epotemp.epoch + 1 >= nowepo ? epotemp.temp : 0;
+#endif
+}
+
+/**
+ * @brief Temperature of the page. It is the hottest finer page if the page is
+ * split.
+ * @param [in] page index of EpotempAry.
+ * @param [in] nowepo current global epoch.
+ * @return temperature.
+ */
+static uint64_t pageTemperature(size_t page, uint64_t nowepo) {
+  Epotemp epotemp;
+  uint32_t split = loadAcquire(TempSplitAry[page]);
+  if (split == 0) {
+    epotemp.obj_ = loadAcquire(EpotempAry[page].obj_);
+    return currentTemperature(epotemp, nowepo);
+  }
+
+  uint64_t temp = 0;
+  for (size_t i = 0; i < TEMP_SPLIT; ++i) {
+    epotemp.obj_ =
+        loadAcquire(TempSplitPool[(split - 1) * TEMP_SPLIT + i].obj_);
+    temp = max(temp, currentTemperature(epotemp, nowepo));
+  }
+  return temp;
+}
+
+/**
+ * @brief Adapt the granularity of temperature statistics.
+ * @detail A hot page whose temperature exceeds its neighbours' by
+ * temp_split_gap is split into TEMP_SPLIT finer pages, so cold records which
+ * share the page with a hot spot keep using OCC. A split page is merged when it
+ * cools down below TEMP_THRESHOLD. At most temp_split_max pages are split at a
+ * time. Only the leader calls this, just after it advances the epoch.
+ * A worker which loaded the location of a finer page just before merging may
+ * update it after that. It only affects statistics.
+ * @return void
+ */
+void adaptTemperatureGranularity() {
+  static std::vector<uint32_t> free_splits;
+  static bool initialized = false;
+  if (!initialized) {
+    for (uint32_t i = FLAGS_temp_split_max; i > 0; --i)
+      free_splits.emplace_back(i);
+    initialized = true;
+  }
+
+  size_t epotemp_length =
+      FLAGS_tuple_num * sizeof(Tuple) / FLAGS_per_xx_temp + 1;
+  uint64_t nowepo = (loadAcquireGE()).obj_;
+  for (size_t page = 0; page < epotemp_length; ++page) {
+    uint32_t split = loadAcquire(TempSplitAry[page]);
+    uint64_t temp = pageTemperature(page, nowepo);
+    if (split != 0) {
+      if (temp < TEMP_THRESHOLD) {
+        Epotemp epotemp(temp, nowepo);
+        storeRelease(EpotempAry[page].obj_, epotemp.obj_);
+        storeRelease(TempSplitAry[page], 0);
+        free_splits.emplace_back(split);
+        ++TempMerges;
+      }
+      continue;
+    }
+    if (temp < TEMP_THRESHOLD || free_splits.empty()) continue;
+
+    uint64_t neighbour = 0;
+    if (page > 0) neighbour = pageTemperature(page - 1, nowepo);
+    if (page + 1 < epotemp_length)
+      neighbour = max(neighbour, pageTemperature(page + 1, nowepo));
+    if (temp < neighbour + FLAGS_temp_split_gap) continue;
+
+    // finer pages start with the temperature of the page.
+    split = free_splits.back();
+    free_splits.pop_back();
+    for (size_t i = 0; i < TEMP_SPLIT; ++i) {
+      Epotemp epotemp(temp, nowepo);
+      storeRelease(TempSplitPool[(split - 1) * TEMP_SPLIT + i].obj_,
+                   epotemp.obj_);
+    }
+    storeRelease(TempSplitAry[page], split);
+    ++TempSplits;
+  }
+}
+
+/**
+ * @brief Dump the temperature of each page to FLAGS_temp_heatmap.
+ * @detail Each line is "page split sub first_key temp". A split page has
+ * TEMP_SPLIT lines, one for each finer page (sub).
+ * @return void
+ */
+void dumpTemperatureHeatMap() {
+  ofstream ofs(FLAGS_temp_heatmap);
+  if (!ofs) ERR;
+
+  size_t epotemp_length =
+      FLAGS_tuple_num * sizeof(Tuple) / FLAGS_per_xx_temp + 1;
+  uint64_t nowepo = (loadAcquireGE()).obj_;
+  ofs << "#page\tsplit\tsub\tfirst_key\ttemp" << endl;
+  for (size_t page = 0; page < epotemp_length; ++page) {
+    uint64_t offset = page * FLAGS_per_xx_temp;
+    uint32_t split = FLAGS_temp_split_max ? loadAcquire(TempSplitAry[page]) : 0;
+    Epotemp epotemp;
+    if (split == 0) {
+      epotemp.obj_ = loadAcquire(EpotempAry[page].obj_);
+      ofs << page << "\t0\t0\t" << (offset + sizeof(Tuple) - 1) / sizeof(Tuple)
+          << "\t" << decayTemperature(epotemp, nowepo).temp << endl;
+      continue;
+    }
+    for (size_t i = 0; i < TEMP_SPLIT; ++i) {
+      uint64_t suboffset = offset + i * FLAGS_per_xx_temp / TEMP_SPLIT;
+      epotemp.obj_ =
+        loadAcquire(TempSplitPool[(split - 1) * TEMP_SPLIT + i].obj_);
+      ofs << page << "\t1\t" << i << "\t"
+          << (suboffset + sizeof(Tuple) - 1) / sizeof(Tuple) << "\t"
+          << decayTemperature(epotemp, nowepo).temp << endl;
+    }
+  }
+}
+
 void ShowOptParameters() {
   cout << "#ShowOptParameters() "
        << ": ADD_ANALYSIS " << ADD_ANALYSIS << ": BACK_OFF " << BACK_OFF
-       << ": MASSTREE_USE " << MASSTREE_USE << ": KEY_SIZE " << KEY_SIZE
-       << ": KEY_SORT " << KEY_SORT << ": TEMPERATURE_RESET_OPT "
-       << TEMPERATURE_RESET_OPT << ": VAL_SIZE " << VAL_SIZE << endl;
+#ifdef RWLOCK
+       << ": LOCK_KIND " << LOCK_KIND << " (" << LockOf<LOCK_KIND>::name << ")"
+#endif  // RWLOCK
+#ifdef MQLOCK
+       << ": MQLOCK "
+#endif  // MQLOCK
+       << ": MAINTENANCE_THREAD " << MAINTENANCE_THREAD << ": MASSTREE_USE "
+       << MASSTREE_USE << ": KEY_SIZE " << KEY_SIZE << ": KEY_SORT "
+       << KEY_SORT << ": TEMPERATURE_DECAY " << TEMPERATURE_DECAY
+       << ": TEMPERATURE_RESET_OPT " << TEMPERATURE_RESET_OPT << ": VAL_SIZE "
+       << VAL_SIZE << endl;
 }
@@ -5,22 +5,30 @@
 
 #include "../../include/cache_line_size.hh"
 #include "../../include/int64byte.hh"
+#include "../../include/maintenance.hh"
 #include "../../include/masstree_wrapper.hh"
+#include "../../include/reclaim.hh"
+#include "../../include/slab.hh"
 #include "transaction_table.hh"
 #include "tuple.hh"
 
 #include "gflags/gflags.h"
 #include "glog/logging.h"
 
+#define MAX_THREAD_NUM 65536  // thread ids are uint16_t.
+
 #ifdef GLOBAL_VALUE_DEFINE
 #define GLOBAL
 alignas(CACHE_LINE_SIZE) GLOBAL std::atomic<uint64_t> CCtr(0);
+// the latest cstamp of committed transactions, from which snapshots are taken.
+alignas(CACHE_LINE_SIZE) GLOBAL std::atomic<uint64_t> MaxCstamp(0);
 #if MASSTREE_USE
 alignas(CACHE_LINE_SIZE) GLOBAL MasstreeWrapper<Tuple> MT;
 #endif
 #else
 #define GLOBAL extern
 alignas(CACHE_LINE_SIZE) GLOBAL std::atomic<uint64_t> CCtr;
+alignas(CACHE_LINE_SIZE) GLOBAL std::atomic<uint64_t> MaxCstamp;
 #if MASSTREE_USE
 alignas(CACHE_LINE_SIZE) GLOBAL MasstreeWrapper<Tuple> MT;
 #endif
@@ -31,11 +39,11 @@ DEFINE_uint64(clocks_per_us, 2100,
               "CPU_MHz. Use this info for measuring time.");
 DEFINE_uint64(extime, 3, "Execution time[sec].");
 DEFINE_uint64(gc_inter_us, 10, "GC interval[us].");
+DEFINE_uint64(maintenance_tick_us, 10,
+              "Tick of the maintenance thread[us]. It is used by "
+              "MAINTENANCE_THREAD.");
 DEFINE_uint64(max_ope, 10,
               "Total number of operations per single transaction.");
-DEFINE_uint64(
-    pre_reserve_tmt_element, 100,
-    "Pre-allocating memory for the transaction mapping table elements.");
 DEFINE_uint64(pre_reserve_version, 10000,
               "Pre-allocating memory for the version.");
 DEFINE_bool(rmw, false,
@@ -43,6 +51,8 @@ DEFINE_bool(rmw, false,
 DEFINE_uint64(rratio, 50, "read ratio of single transaction.");
 DEFINE_uint64(thread_num, 10, "Total number of worker threads.");
 DEFINE_uint64(tuple_num, 1000000, "Total number of records.");
+DEFINE_bool(version_numa_local, false,
+            "Bind version slabs to the NUMA node of their worker.");
 DEFINE_bool(ycsb, true,
             "True uses zipf_skew, false uses faster random generator.");
 DEFINE_double(zipf_skew, 0, "zipf skew. 0 ~ 0.999...");
@@ -50,19 +60,26 @@ DEFINE_double(zipf_skew, 0, "zipf skew. 0 ~ 0.999...");
 DECLARE_uint64(clocks_per_us);
 DECLARE_uint64(extime);
 DECLARE_uint64(gc_inter_us);
+DECLARE_uint64(maintenance_tick_us);
 DECLARE_uint64(max_ope);
-DECLARE_uint64(pre_reserve_tmt_element);
 DECLARE_uint64(pre_reserve_version);
 DECLARE_bool(rmw);
 DECLARE_uint64(rratio);
 DECLARE_uint64(thread_num);
 DECLARE_uint64(tuple_num);
+DECLARE_bool(version_numa_local);
 DECLARE_bool(ycsb);
 DECLARE_double(zipf_skew);
 #endif
 
+// version slab of each worker [thID], then of each loader.
+alignas(CACHE_LINE_SIZE) GLOBAL SlabAllocator<Version> *VersionAllocators;
+// reclamation of versions. Its watermark is the minimum txid.
+GLOBAL EpochReclaimer Reclaimer;
+
 #include "transaction.hh"
 
 alignas(CACHE_LINE_SIZE) GLOBAL Tuple *Table;
-alignas(CACHE_LINE_SIZE) GLOBAL
-    TransactionTable **TMT;  // Transaction Mapping Table
+// Transaction Mapping Table. [thID]
+alignas(CACHE_LINE_SIZE) GLOBAL TransactionTable *TMT;
+GLOBAL MaintenanceStat WatermarkStat;  // GC threshold
@@ -23,11 +23,11 @@ enum class TransactionStatus : uint8_t {
 
 class TxExecutor {
  public:
-  uint8_t thid_;         // thread ID
-  uint32_t cstamp_ = 0;  // Transaction end time, c(T)
-  uint32_t
+  uint16_t thid_;        // thread ID
+  uint64_t cstamp_ = 0;  // Transaction end time, c(T)
+  uint64_t
       txid_;  // TID and begin timestamp - the current log sequence number (LSN)
-  uint32_t pre_gc_threshold_ = 0;
+  uint64_t gc_epoch_ = 0;  // epoch of Reclaimer at the last collection
   uint64_t gcstart_, gcstop_;
   char return_val_[VAL_SIZE] = {};
   char write_val_[VAL_SIZE] = {};
@@ -41,28 +41,19 @@ class TxExecutor {
   TransactionStatus status_ =
       TransactionStatus::inFlight;  // Status: inFlight, committed, or aborted
 
-  TxExecutor(uint8_t thid, unsigned int max_ope, Result *sres)
+  TxExecutor(uint16_t thid, unsigned int max_ope, Result *sres)
       : thid_(thid), sres_(sres) {
     gcobject_.thid_ = thid;
     read_set_.reserve(max_ope);
     write_set_.reserve(max_ope);
     pro_set_.reserve(max_ope);
 
-    if (FLAGS_pre_reserve_tmt_element) {
-      for (size_t i = 0; i < FLAGS_pre_reserve_tmt_element; ++i)
-        gcobject_.reuse_TMT_element_from_gc_.emplace_back(
-            new TransactionTable());
-    }
-
-    if (FLAGS_pre_reserve_version) {
-      for (size_t i = 0; i < FLAGS_pre_reserve_version; ++i) {
-        gcobject_.reuse_version_from_gc_.emplace_back(new Version());
-      }
-    }
-
     genStringRepeatedNumber(write_val_, VAL_SIZE, thid);
+    Reclaimer.enter(thid_, 0);
   }
 
+  ~TxExecutor() { Reclaimer.leave(thid_); }
+
   SetElement<Tuple> *searchReadSet(uint64_t key);
   SetElement<Tuple> *searchWriteSet(uint64_t key);
   void tbegin();
@@ -71,6 +62,32 @@ class TxExecutor {
   void commit();
   void abort();
   void mainte();
+
+  Version *newVersionGeneration([[maybe_unused]] Tuple *tuple) {
+#if INLINE_VERSION_OPT
+    if (tuple->getInlineVersionRight()) {
+      tuple->inline_ver_.init();
+#if ADD_ANALYSIS
+      ++sres_->local_version_reuse_;
+#endif
+      return &tuple->inline_ver_;
+    }
+#endif  // if INLINE_VERSION_OPT
+    return VersionAllocators[thid_].allocate();
+  }
+
+  /**
+   * @brief make the commit visible to the snapshots of later transactions.
+   * @return void
+   */
+  void publishCstamp() {
+    uint64_t max_cstamp = MaxCstamp.load(std::memory_order_acquire);
+    while (max_cstamp < cstamp_ &&
+           !MaxCstamp.compare_exchange_weak(max_cstamp, cstamp_,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire))
+      ;
+  }
   void dispWS();
   void dispRS();
 
@@ -1,18 +1,27 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+
+#include "../../include/cache_line_size.hh"
+
+/**
+ * @brief Slot of a worker in the transaction mapping table. The next
+ * transaction of the worker updates it in place.
+ */
 class TransactionTable {
  public:
-  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> txid_;
-  std::atomic<uint32_t> lastcstamp_;
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> txid_;
+  std::atomic<uint64_t> lastcstamp_;
 
   TransactionTable(){};
 
-  TransactionTable(uint32_t txid, uint32_t lastcstamp) {
+  TransactionTable(uint64_t txid, uint64_t lastcstamp) {
     this->txid_.store(txid, std::memory_order_relaxed);
     this->lastcstamp_.store(lastcstamp, std::memory_order_relaxed);
   }
 
-  void set(uint32_t txid, uint32_t lastcstamp) {
+  void set(uint64_t txid, uint64_t lastcstamp) {
     this->txid_.store(txid, std::memory_order_relaxed);
     this->lastcstamp_.store(lastcstamp, std::memory_order_relaxed);
   }
@@ -9,78 +9,46 @@ enum class VersionStatus : uint8_t {
   inFlight,
   committed,
   aborted,
+  unused,  // the inline version of a tuple which no version list links
 };
 
+/**
+ * @brief pstamp and sstamp of a version.
+ * @detail Each is a 64-bit atomic, so they don't wrap around in long runs.
+ * They are updated independently of each other, so they need no double-width
+ * CAS, and they share a cache line.
+ */
 struct Psstamp {
-  union {
-    uint64_t obj_;
-    struct {
-      uint32_t pstamp;
-      uint32_t sstamp;
-    };
-  };
+  std::atomic<uint64_t> pstamp_;
+  std::atomic<uint64_t> sstamp_;
 
-  Psstamp() { obj_ = 0; }
+  Psstamp() : pstamp_(0), sstamp_(0) {}
 
-  void init(uint32_t pstamp, uint32_t sstamp) {
-    this->pstamp = pstamp;
-    this->sstamp = sstamp;
+  void init(uint64_t pstamp, uint64_t sstamp) {
+    pstamp_.store(pstamp, std::memory_order_relaxed);
+    sstamp_.store(sstamp, std::memory_order_relaxed);
   }
 
-  uint64_t atomicLoad() {
-    Psstamp expected;
-    expected.obj_ = __atomic_load_n(&obj_, __ATOMIC_ACQUIRE);
-    return expected.obj_;
+  bool atomicCASPstamp(uint64_t expectedPstamp, uint64_t desiredPstamp) {
+    return pstamp_.compare_exchange_strong(expectedPstamp, desiredPstamp,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_relaxed);
   }
 
-  bool atomicCASPstamp(uint32_t expectedPstamp, uint32_t desiredPstamp) {
-    Psstamp expected, desired;
-    expected.obj_ = __atomic_load_n(&obj_, __ATOMIC_ACQUIRE);
-    expected.pstamp = expectedPstamp;
-    desired = expected;
-    desired.pstamp = desiredPstamp;
-    if (__atomic_compare_exchange_n(&obj_, &expected.obj_, desired.obj_, false,
-                                    __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
-      return true;
-    else
-      return false;
+  uint64_t atomicLoadPstamp() {
+    return pstamp_.load(std::memory_order_acquire);
   }
 
-  uint32_t atomicLoadPstamp() {
-    Psstamp expected;
-    expected.obj_ = __atomic_load_n(&obj_, __ATOMIC_ACQUIRE);
-    return expected.pstamp;
+  uint64_t atomicLoadSstamp() {
+    return sstamp_.load(std::memory_order_acquire);
   }
 
-  uint32_t atomicLoadSstamp() {
-    Psstamp expected;
-    expected.obj_ = __atomic_load_n(&obj_, __ATOMIC_ACQUIRE);
-    return expected.sstamp;
-  }
-  void atomicStorePstamp(uint32_t newpstamp) {
-    Psstamp expected, desired;
-    expected.obj_ = __atomic_load_n(&obj_, __ATOMIC_ACQUIRE);
-    for (;;) {
-      desired = expected;
-      desired.pstamp = newpstamp;
-      if (__atomic_compare_exchange_n(&obj_, &expected.obj_, desired.obj_,
-                                      false, __ATOMIC_ACQ_REL,
-                                      __ATOMIC_ACQUIRE))
-        break;
-    }
+  void atomicStorePstamp(uint64_t newpstamp) {
+    pstamp_.exchange(newpstamp, std::memory_order_acq_rel);
   }
 
-  void atomicStoreSstamp(uint32_t newsstamp) {
-    Psstamp expected, desired;
-    expected.obj_ = __atomic_load_n(&obj_, __ATOMIC_ACQUIRE);
-    for (;;) {
-      desired = expected;
-      desired.sstamp = newsstamp;
-      if (__atomic_compare_exchange_n(&obj_, &expected.obj_, desired.obj_,
-                                      false, __ATOMIC_ACQ_REL,
-                                      __ATOMIC_ACQUIRE))
-        break;
-    }
+  void atomicStoreSstamp(uint64_t newsstamp) {
+    sstamp_.exchange(newsstamp, std::memory_order_acq_rel);
   }
 };
 
@@ -89,7 +57,7 @@ class Version {
   alignas(CACHE_LINE_SIZE) Version *prev_;  // Pointer to overwritten version
   Version *committed_prev_;  // Pointer to the next committed version, to reduce
                              // serach cost.
-  std::atomic<uint32_t> cstamp_;  // Version creation stamp, c(V)
+  std::atomic<uint64_t> cstamp_;  // Version creation stamp, c(V)
   std::atomic<VersionStatus> status_;
   char val_[VAL_SIZE] = {};
 
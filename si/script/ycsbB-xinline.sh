@@ -0,0 +1,40 @@
+#ycsbB-xinline.sh(si)
+# Read-mostly YCSB with and without INLINE_VERSION_OPT, varying the number
+# of threads. cache_misses_per_read is the cache misses of perf stat per
+# read of committed transactions.
+tuple=1000000
+maxope=10
+rratio=95
+skew=0.9
+cpu_mhz=2100
+gci=10
+extime=3
+
+host=`hostname`
+dbs11="dbs11"
+
+threads="1 4 8 12 16 20 24"
+if  test $host = $dbs11 ; then
+threads="1 28 56 84 112 140 168 196 224"
+fi
+
+result=result_si_ycsbB_tuple1m_ope10_skew09_xth_xinline.dat
+rm $result
+echo "#thread_num, INLINE_VERSION_OPT, throughput, cache_misses_per_read" >> $result
+
+for inline in 0 1
+do
+  cd ../
+  make clean; make -j INLINE_VERSION_OPT=$inline
+  cd script/
+
+  for thread in $threads
+  do
+    perf stat -e cache-misses -o si_cache_ana.txt numactl --interleave=all ../si.exe -clocks_per_us=$cpu_mhz -extime=$extime -gc_inter_us=$gci -max_ope=$maxope -rmw=0 -rratio=$rratio -thread_num=$thread -tuple_num=$tuple -ycsb=1 -zipf_skew=$skew > exp.txt
+    tmpTH=`grep throughput ./exp.txt | awk '{print $2}'`
+    tmpCC=`grep ^commit_counts_ ./exp.txt | awk '{print $2}'`
+    tmpCM=`grep cache-misses ./si_cache_ana.txt | awk '{print $1}' | tr -d ,`
+    tmpMR=`echo "$tmpCM / ($tmpCC * $maxope * $rratio / 100)" | bc -l`
+    echo "$thread $inline $tmpTH $tmpMR" >> $result
+  done
+done
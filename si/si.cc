@@ -35,7 +35,6 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
   Xoroshiro128Plus rnd;
   rnd.init();
   FastZipf zipf(&rnd, FLAGS_zipf_skew, FLAGS_tuple_num);
-  GarbageCollection gcob;
   Backoff backoff(FLAGS_clocks_per_us);
 
 #if MASSTREE_USE
@@ -49,7 +48,9 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
   // sysconf(_SC_NPROCESSORS_CONF));
 #endif  // Linux
 
-  if (thid == 0) gcob.decideFirstRange();
+  SlabAllocator<Version>& slab = VersionAllocators[thid];
+  slab.reserve(FLAGS_pre_reserve_version);
+
   storeRelease(ready, 1);
   while (!loadAcquire(start)) _mm_pause();
   trans.gcstart_ = rdtscp();
@@ -59,7 +60,9 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
                   thid, myres);
   RETRY:
     if (thid == 0) {
-      leaderWork(std::ref(gcob));
+#if !MAINTENANCE_THREAD
+      leaderWork();
+#endif
       leaderBackoffWork(backoff, SIResult);
     }
     if (loadAcquire(quit)) break;
@@ -97,6 +100,15 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
     trans.mainte();
   }
 
+#if ADD_ANALYSIS
+  myres.local_version_malloc_ += slab.fresh_;
+  myres.local_version_remote_frees_ += slab.remote_frees_;
+  myres.local_version_reuse_ += slab.reuses_;
+  myres.local_version_slab_bytes_ += slab.chunks_ * slab.kChunkSize;
+  myres.local_reclaim_lag_ += trans.gcobject_.limbo_versions_.lag_sum_;
+  myres.local_reclaim_lag_max_ = trans.gcobject_.limbo_versions_.lag_max_;
+#endif
+
   return;
 }
 
@@ -116,11 +128,19 @@ int main(int argc, char* argv[]) try {
                      std::ref(quit));
   waitForReady(readys);
   storeRelease(start, true);
+#if MAINTENANCE_THREAD
+  MaintenanceThread maintainer;
+  maintainer.start(FLAGS_maintenance_tick_us, FLAGS_clocks_per_us,
+                   []() { leaderWork(); });
+#endif
   for (size_t i = 0; i < FLAGS_extime; ++i) {
     sleepMs(1000);
   }
   storeRelease(quit, true);
   for (auto& th : thv) th.join();
+#if MAINTENANCE_THREAD
+  maintainer.stop();
+#endif
 
   for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
     SIResult[0].addLocalAllResult(SIResult[i]);
@@ -128,6 +148,11 @@ int main(int argc, char* argv[]) try {
   ShowOptParameters();
   SIResult[0].displayAllResult(FLAGS_clocks_per_us, FLAGS_extime,
                                FLAGS_thread_num);
+  WatermarkStat.display("watermark", FLAGS_clocks_per_us);
+  Reclaimer.display();
+#if MAINTENANCE_THREAD
+  maintainer.display();
+#endif
 
   return 0;
 } catch (bad_alloc) {
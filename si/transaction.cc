@@ -52,64 +52,31 @@ inline SetElement<Tuple> *TxExecutor::searchWriteSet(uint64_t key) {
  */
 void TxExecutor::tbegin() {
 #ifdef CCTR_ON
-  TransactionTable *newElement, *tmt;
-
-  tmt = loadAcquire(TMT[thid_]);
-  uint32_t lastcstamp;
+  TransactionTable *tmt = &TMT[thid_];
+  uint64_t lastcstamp;
   if (this->status_ == TransactionStatus::aborted) {
 		/**
 		 * If this transaction is retry by abort,
 		 * its lastcstamp is last one.
 		 */
-    lastcstamp = this->txid_ = tmt->lastcstamp_.load(std::memory_order_acquire);
+    lastcstamp = tmt->lastcstamp_.load(std::memory_order_acquire);
 	} else {
 		/**
 		 * If this transaction is after committed transaction,
 		 * its lastcstamp is that's one.
 		 */
-    lastcstamp = this->txid_ = cstamp_;
+    lastcstamp = cstamp_;
 	}
 
-  if (gcobject_.reuse_TMT_element_from_gc_.empty()) {
-		/**
-		 * If no cache,
-		 */
-    newElement = new TransactionTable(0, lastcstamp);
-#if ADD_ANALYSIS
-    ++sres_->local_TMT_element_malloc_;
-#endif
-  } else {
-		/**
-		 * If it has cache, this transaction use it.
-		 */
-    newElement = gcobject_.reuse_TMT_element_from_gc_.back();
-    gcobject_.reuse_TMT_element_from_gc_.pop_back();
-    newElement->set(0, lastcstamp);
-#if ADD_ANALYSIS
-    ++sres_->local_TMT_element_reuse_;
-#endif
-  }
-
 	/**
 	 * Check the latest commit timestamp.
 	 */
-  for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
-    do {
-      tmt = loadAcquire(TMT[i]);
-    } while (tmt == nullptr);
-    this->txid_ = max(this->txid_, tmt->lastcstamp_.load(memory_order_acquire));
-  }
-  this->txid_ += 1;
-  newElement->txid_ = this->txid_;
+  this->txid_ = max(lastcstamp, MaxCstamp.load(memory_order_acquire)) + 1;
 
 	/**
-	 * Old object becomes cache object.
-	 */
-  gcobject_.gcq_for_TMT_.emplace_back(loadAcquire(TMT[thid_]));
-	/**
-	 * New object is registerd to transaction mapping table.
+	 * Update the slot of this worker in transaction mapping table.
 	 */
-  storeRelease(TMT[thid_], newElement);
+  tmt->set(this->txid_, lastcstamp);
 #endif  // CCTR_ON
 
 #ifdef CCTR_TW
@@ -117,7 +84,7 @@ void TxExecutor::tbegin() {
 	 * An orthodoxy approach to take timestamp from shared counter at begin/end of transaction.
 	 */
   this->txid_ = ++CCtr;
-  TMT[thid_]->txid_.store(this->txid_, std::memory_order_release);
+  TMT[thid_].txid_.store(this->txid_, std::memory_order_release);
 #endif  // CCTR_TW
 
   status_ = TransactionStatus::inFlight;
@@ -232,18 +199,7 @@ void TxExecutor::twrite(uint64_t key) {
   // later than its begin timestamp.
 
   Version *expected, *desired;
-  if (gcobject_.reuse_version_from_gc_.empty()) {
-    desired = new Version();
-#if ADD_ANALYSIS
-    ++sres_->local_version_malloc_;
-#endif
-  } else {
-    desired = gcobject_.reuse_version_from_gc_.back();
-    gcobject_.reuse_version_from_gc_.pop_back();
-#if ADD_ANALYSIS
-    ++sres_->local_version_reuse_;
-#endif
-  }
+  desired = newVersionGeneration(tuple);
 
   desired->cstamp_.store(
       this->txid_,
@@ -271,7 +227,7 @@ void TxExecutor::twrite(uint64_t key) {
          */
         // if (1) {
         this->status_ = TransactionStatus::aborted;
-        gcobject_.reuse_version_from_gc_.emplace_back(desired);
+        gcobject_.freeVersion(tuple, desired);
         goto FINISH_WRITE;
         return;
       }
@@ -293,7 +249,7 @@ void TxExecutor::twrite(uint64_t key) {
       // Writers must abort if they would overwirte a version created after
       // their snapshot.
       this->status_ = TransactionStatus::aborted;
-      gcobject_.reuse_version_from_gc_.emplace_back(desired);
+      gcobject_.freeVersion(tuple, desired);
       goto FINISH_WRITE;
     }
 
@@ -353,7 +309,8 @@ void TxExecutor::commit() {
 	/**
 	 * update lastcstamp.
 	 */
-  TMT[thid_]->lastcstamp_.store(this->cstamp_, std::memory_order_release);
+  TMT[thid_].lastcstamp_.store(this->cstamp_, std::memory_order_release);
+  publishCstamp();
 #if ADD_ANALYSIS
   sres_->local_commit_latency_ += rdtscp() - start;
 #endif
@@ -415,23 +372,24 @@ void TxExecutor::dispRS() {
 }
 
 void TxExecutor::mainte() {
-  gcstop_ = rdtscp();
-  if (chkClkSpan(gcstart_, gcstop_, FLAGS_gc_inter_us * FLAGS_clocks_per_us)) {
-    uint32_t load_threshold = gcobject_.getGcThreshold();
-    if (pre_gc_threshold_ != load_threshold) {
+  uint64_t epoch = Reclaimer.epoch();
+  if (gc_epoch_ != epoch) {
 #if ADD_ANALYSIS
-      ++sres_->local_gc_counts_;
-      uint64_t start = rdtscp();
-#endif
-      gcobject_.gcVersion(sres_);
-      pre_gc_threshold_ = load_threshold;
-      gcstart_ = gcstop_;
-#ifdef CCTR_ON
-      gcobject_.gcTMTElements(sres_);
+    ++sres_->local_gc_counts_;
+    uint64_t start = rdtscp();
 #endif
+    gcobject_.gcVersion(sres_);
+    gc_epoch_ = epoch;
 #if ADD_ANALYSIS
-      sres_->local_gc_latency_ += rdtscp() - start;
+    sres_->local_gc_latency_ += rdtscp() - start;
 #endif
-    }
+  }
+
+  gcstop_ = rdtscp();
+  if (chkClkSpan(gcstart_, gcstop_, FLAGS_gc_inter_us * FLAGS_clocks_per_us) &&
+      !Reclaimer.announced(thid_)) {
+    // the next transaction begins at txid which is not older.
+    Reclaimer.announce(thid_, txid_);
+    gcstart_ = gcstop_;
   }
 }
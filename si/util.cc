@@ -47,10 +47,14 @@ void chkArg() {
     ERR;
   }
 
-  TMT = new TransactionTable *[FLAGS_thread_num];
+  if (FLAGS_thread_num > MAX_THREAD_NUM) {
+    cout << "thread_num must be at most " << MAX_THREAD_NUM << "." << endl;
+    ERR;
+  }
+
+  TMT = new TransactionTable[FLAGS_thread_num];
 
-  for (unsigned int i = 0; i < FLAGS_thread_num; ++i)
-    TMT[i] = new TransactionTable(0, 0);
+  Reclaimer.init(FLAGS_thread_num);
 }
 
 void displayDB() {
@@ -76,6 +80,9 @@ void displayDB() {
         case VersionStatus::committed:
           cout << "status_:  committed";
           break;
+        case VersionStatus::unused:
+          cout << "status_:  unused";
+          break;
       }
       cout << endl;
 
@@ -92,14 +99,14 @@ void displayParameter() {
   cout << "#FLAGS_clocks_per_us:\t\t\t" << FLAGS_clocks_per_us << endl;
   cout << "#FLAGS_extime:\t\t\t\t" << FLAGS_extime << endl;
   cout << "#FLAGS_gc_inter_us:\t\t\t" << FLAGS_gc_inter_us << endl;
+  cout << "#FLAGS_maintenance_tick_us:\t\t" << FLAGS_maintenance_tick_us << endl;
   cout << "#FLAGS_max_ope:\t\t\t\t" << FLAGS_max_ope << endl;
-  cout << "#FLAGS_pre_reserve_tmt_element:\t\t" << FLAGS_pre_reserve_tmt_element
-       << endl;
   cout << "#FLAGS_pre_reserve_version:\t\t" << FLAGS_pre_reserve_version
        << endl;
   cout << "#FLAGS_rmw:\t\t\t\t" << FLAGS_rmw << endl;
   cout << "#FLAGS_rratio:\t\t\t\t" << FLAGS_rratio << endl;
   cout << "#FLAGS_thread_num:\t\t\t" << FLAGS_thread_num << endl;
+  cout << "#FLAGS_version_numa_local:\t\t" << FLAGS_version_numa_local << endl;
   cout << "#FLAGS_ycsb:\t\t\t\t" << FLAGS_ycsb << endl;
   cout << "#FLAGS_zipf_skew:\t\t\t" << FLAGS_zipf_skew << endl;
 }
@@ -113,7 +120,13 @@ void partTableInit([[maybe_unused]] size_t thid, uint64_t start, uint64_t end) {
     Tuple *tmp;
     Version *verTmp;
     tmp = TxExecutor::get_tuple(Table, i);
-    tmp->latest_.store(new Version(), std::memory_order_release);
+#if INLINE_VERSION_OPT
+    tmp->inline_ver_.val_[0] = '\0';
+    tmp->latest_.store(&tmp->inline_ver_, std::memory_order_release);
+#else
+    tmp->latest_.store(VersionAllocators[FLAGS_thread_num + thid].allocate(),
+                       std::memory_order_release);
+#endif
     // if (posix_memalign((void**)&tmp->latest_, CACHE_LINE_SIZE,
     // sizeof(Version)) != 0) ERR;
     tmp->min_cstamp_ = 0;
@@ -139,6 +152,11 @@ void makeDB() {
 #endif
 
   size_t maxthread = decideParallelBuildNumber(FLAGS_tuple_num);
+  // slabs of the workers, then the loaders.
+  VersionAllocators = new SlabAllocator<Version>[FLAGS_thread_num + maxthread];
+  for (size_t i = 0; i < FLAGS_thread_num + maxthread; ++i)
+    VersionAllocators[i].init(FLAGS_version_numa_local,
+                              i < FLAGS_thread_num);
 
   std::vector<std::thread> thv;
   for (size_t i = 0; i < maxthread; ++i)
@@ -147,73 +165,16 @@ void makeDB() {
   for (auto &th : thv) th.join();
 }
 
-void naiveGarbageCollection(const bool &quit) {
-  TransactionTable *tmt;
-
-  uint32_t mintxID = UINT32_MAX;
-  for (unsigned int i = 1; i < FLAGS_thread_num; ++i) {
-    tmt = __atomic_load_n(&TMT[i], __ATOMIC_ACQUIRE);
-    mintxID = std::min(mintxID, tmt->txid_.load(std::memory_order_acquire));
-  }
-
-  if (mintxID == 0)
-    return;
-  else {
-    // mintxIDから到達不能なバージョンを削除する
-    Version *verTmp, *delTarget;
-    for (unsigned int i = 0; i < FLAGS_tuple_num; ++i) {
-      if (quit) return;
-
-#if MASSTREE_USE
-      Tuple *tuple = MT.get_value(i);
-#else
-      Tuple *tuple = TxExecutor::get_tuple(Table, i);
-#endif
-
-      verTmp = tuple->latest_.load(std::memory_order_acquire);
-      if (verTmp->status_.load(std::memory_order_acquire) !=
-          VersionStatus::committed)
-        verTmp = verTmp->committed_prev_;
-      // この時点で， verTmp はコミット済み最新バージョン
-
-      uint64_t verCstamp = verTmp->cstamp_.load(std::memory_order_acquire);
-      while (mintxID < (verCstamp >> 1)) {
-        verTmp = verTmp->committed_prev_;
-        if (verTmp == nullptr) break;
-        verCstamp = verTmp->cstamp_.load(std::memory_order_acquire);
-      }
-      if (verTmp == nullptr) continue;
-      // verTmp は mintxID によって到達可能．
-
-      // ssn commit protocol によってverTmp->commited_prev_ までアクセスされる．
-      verTmp = verTmp->committed_prev_;
-      if (verTmp == nullptr) continue;
-
-      // verTmp->prev_ からガベコレ可能
-      delTarget = verTmp->prev_;
-      if (delTarget == nullptr) continue;
-
-      verTmp->prev_ = nullptr;
-      while (delTarget != nullptr) {
-        verTmp = delTarget->prev_;
-        delete delTarget;
-        delTarget = verTmp;
-      }
-      //-----
-    }
-  }
-}
-
-void leaderWork(GarbageCollection &gcob) {
-  if (gcob.chkSecondRange()) {
-    gcob.decideGcThreshold();
-    gcob.mvSecondRangeToFirstRange();
-  }
+void leaderWork() {
+  if (Reclaimer.tryAdvance())
+    WatermarkStat.record(rdtscp(), FLAGS_gc_inter_us * FLAGS_clocks_per_us);
 }
 
 void ShowOptParameters() {
   cout << "#ShowOptParameters() "
        << ": ADD_ANALYSIS " << ADD_ANALYSIS << ": BACK_OFF " << BACK_OFF
+       << ": INLINE_VERSION_OPT " << INLINE_VERSION_OPT
+       << ": MAINTENANCE_THREAD " << MAINTENANCE_THREAD
        << ": MASSTREE_USE " << MASSTREE_USE << ": KEY_SIZE " << KEY_SIZE
        << ": VAL_SIZE " << VAL_SIZE << endl;
 }
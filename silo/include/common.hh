@@ -8,6 +8,7 @@
 
 #include "../../include/cache_line_size.hh"
 #include "../../include/int64byte.hh"
+#include "../../include/maintenance.hh"
 #include "../../include/masstree_wrapper.hh"
 
 #include "gflags/gflags.h"
@@ -16,12 +17,14 @@
 #ifdef GLOBAL_VALUE_DEFINE
 #define GLOBAL
 alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte GlobalEpoch(1);
+alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte DurableEpoch(0);
 #if MASSTREE_USE
 alignas(CACHE_LINE_SIZE) GLOBAL MasstreeWrapper<Tuple> MT;
 #endif
 #else
 #define GLOBAL extern
 alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte GlobalEpoch;
+alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte DurableEpoch;
 #if MASSTREE_USE
 alignas(CACHE_LINE_SIZE) GLOBAL MasstreeWrapper<Tuple> MT;
 #endif
@@ -32,11 +35,28 @@ DEFINE_uint64(clocks_per_us, 2100,
               "CPU_MHz. Use this info for measuring time.");
 DEFINE_uint64(epoch_time, 40, "Epoch interval[msec].");
 DEFINE_uint64(extime, 3, "Execution time[sec].");
+DEFINE_string(log_dirs, "",
+              "Comma-separated log directories. Log segments of each worker "
+              "are spread over them. Empty means ./log .");
+DEFINE_bool(log_recycle, false,
+            "Recycle log segments after the durable epoch passes them. "
+            "recovery.exe can't replay recycled logs.");
+DEFINE_uint64(log_segment_num, 4,
+              "Number of log segments preallocated per worker.");
+DEFINE_uint64(log_segment_size, 64 << 20, "Size of a log segment[byte].");
+DEFINE_uint64(maintenance_tick_us, 100,
+              "Tick of the maintenance thread[us]. It is used by "
+              "MAINTENANCE_THREAD.");
 DEFINE_uint64(max_ope, 10,
               "Total number of operations per single transaction.");
+DEFINE_uint64(repair_threshold, 2,
+              "Max number of records re-read by repair in a validation "
+              "phase. It is used by REPAIR.");
 DEFINE_bool(rmw, false,
             "True means read modify write, false means blind write.");
 DEFINE_uint64(rratio, 50, "read ratio of single transaction.");
+DEFINE_uint64(snapshot_interval, 25,
+              "Snapshot interval[epochs]. It is used by SNAPSHOT_READ.");
 DEFINE_uint64(thread_num, 10, "Total number of worker threads.");
 DEFINE_uint64(tuple_num, 1000000, "Total number of records.");
 DEFINE_bool(ycsb, true,
@@ -46,9 +66,16 @@ DEFINE_double(zipf_skew, 0, "zipf skew. 0 ~ 0.999...");
 DECLARE_uint64(clocks_per_us);
 DECLARE_uint64(epoch_time);
 DECLARE_uint64(extime);
+DECLARE_string(log_dirs);
+DECLARE_bool(log_recycle);
+DECLARE_uint64(log_segment_num);
+DECLARE_uint64(log_segment_size);
+DECLARE_uint64(maintenance_tick_us);
 DECLARE_uint64(max_ope);
+DECLARE_uint64(repair_threshold);
 DECLARE_bool(rmw);
 DECLARE_uint64(rratio);
+DECLARE_uint64(snapshot_interval);
 DECLARE_uint64(thread_num);
 DECLARE_uint64(tuple_num);
 DECLARE_bool(ycsb);
@@ -56,6 +83,13 @@ DECLARE_double(zipf_skew);
 #endif
 
 alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte *ThLocalEpoch;
+/**
+ * Logs of the worker up to this epoch have been written to its log segments
+ * and synced. DurableEpoch is the minimum of them.
+ */
+alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte *ThLocalDurableEpoch;
 alignas(CACHE_LINE_SIZE) GLOBAL uint64_t_64byte *CTIDW;
 
+GLOBAL MaintenanceStat EpochStat;
+
 alignas(CACHE_LINE_SIZE) GLOBAL Tuple *Table;
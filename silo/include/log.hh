@@ -5,6 +5,8 @@
 #include <cstdint>
 #include <memory>
 
+#include "../../include/procedure.hh"
+
 class LogHeader {
  public:
   int chkSum_ = 0;
@@ -52,3 +54,64 @@ class LogPackage {
   LogHeader header_;
   std::unique_ptr<LogRecord[]> log_records_;
 };
+
+/**
+ * @brief Header of a package of command log records.
+ * @detail Command logging (COMMAND_LOG) records what a committed transaction
+ * did instead of the after-images it produced. logWordNum_ is the number of
+ * 64 bit words which follow this header.
+ */
+class CmdLogHeader {
+ public:
+  int chkSum_ = 0;
+  unsigned int logTxNum_ = 0;
+  uint64_t logWordNum_ = 0;
+
+  void init() {
+    chkSum_ = 0;
+    logTxNum_ = 0;
+    logWordNum_ = 0;
+  }
+
+  void convertChkSumIntoComplementOnTwo() {
+    chkSum_ ^= 0xffffffff;
+    ++chkSum_;
+  }
+};
+
+/**
+ * @brief Command log record of a committed transaction.
+ * @detail The layout in the log file is
+ * [tid][thid << 32 | ope_num][ope 0]...[ope ope_num - 1],
+ * each of which is a 64 bit word.
+ * The value written by a worker is decided only by its thread id
+ * (genStringRepeatedNumber), so the thread id and the procedure vector are
+ * all the input parameters needed to re-execute the transaction.
+ */
+class CmdLogRecord {
+ public:
+  uint64_t tid_;
+  unsigned int thid_;
+  unsigned int ope_num_;
+
+  static constexpr std::size_t kHeaderWords = 2;
+
+  static uint64_t encodeOpe(const Procedure &pro) {
+    return (pro.key_ << 2) | static_cast<uint64_t>(pro.ope_);
+  }
+
+  static Procedure decodeOpe(uint64_t word) {
+    return Procedure(static_cast<Ope>(word & 3), word >> 2);
+  }
+
+  static int computeChkSum(const uint64_t *words, std::size_t num) {
+    int chkSum = 0;
+    const int *itr = reinterpret_cast<const int *>(words);
+    for (std::size_t i = 0; i < num * sizeof(uint64_t) / sizeof(int); ++i) {
+      chkSum += (*itr);
+      ++itr;
+    }
+
+    return chkSum;
+  }
+};
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "../../include/fileio.hh"
+#include "../../include/log_segment.hh"
 #include "../../include/procedure.hh"
 #include "../../include/result.hh"
 #include "../../include/string.hh"
@@ -31,6 +32,9 @@ class TxnExecutor {
 
   vector<LogRecord> log_set_;
   LogHeader latest_log_header_;
+  vector<uint64_t> cmd_log_set_;
+  CmdLogHeader cmd_log_header_;
+  uint64_t log_epoch_ = 0;  // epoch of the oldest buffered log record
 
   TransactionStatus status_;
   unsigned int thid_;
@@ -40,10 +44,13 @@ class TxnExecutor {
    */
   Result* sres_;
 
-  File logfile_;
+  LogSegmentManager logseg_;
 
   Tidword mrctid_;
   Tidword max_rset_, max_wset_;
+#if SNAPSHOT_READ
+  uint64_t snapshot_epoch_;
+#endif
 
   char write_val_[VAL_SIZE];
   char return_val_[VAL_SIZE];
@@ -71,10 +78,50 @@ class TxnExecutor {
   void abort();
   void writePhase();
   void wal(uint64_t ctid);
+  void cmdwal(uint64_t ctid);
+  void flushLog(uint64_t epoch);
+  bool logBuffered() {
+#if COMMAND_LOG
+    return !cmd_log_set_.empty();
+#else
+    return !log_set_.empty();
+#endif
+  }
+  void advanceDurableEpoch();
   void lockWriteSet();
   void unlockWriteSet();
+#if REPAIR
+  bool repairRead(ReadElement<Tuple>* re);
+#endif
   ReadElement<Tuple>* searchReadSet(uint64_t key);
   WriteElement<Tuple>* searchWriteSet(uint64_t key);
+#if SNAPSHOT_READ
+  bool beginSnapshot();
+  void snapshotRead(uint64_t key);
+  void keepSnapshotVersion(Tuple* tuple, Tidword newtid);
+  void gcSnapshotVersion(Tuple* tuple);
+
+  /**
+   * @brief snapshot epoch which a transaction begun at the epoch reads.
+   * @detail All transactions whose epoch is less than epoch - 1 are already
+   * committed, since the global epoch advances only after all workers loaded
+   * the previous epoch. Snapshot epochs are multiples of snapshot_interval.
+   * 0 means no snapshot is available yet.
+   */
+  static uint64_t snapshotEpoch(uint64_t epoch) {
+    if (epoch < 2) return 0;
+    return (epoch - 2) / FLAGS_snapshot_interval * FLAGS_snapshot_interval;
+  }
+
+  /**
+   * @brief An overwritten version must be kept if a snapshot epoch lies
+   * between it and the new version, that is, the buckets differ.
+   */
+  static uint64_t snapshotBucket(uint64_t epoch) {
+    if (epoch == 0) return 0;
+    return (epoch - 1) / FLAGS_snapshot_interval;
+  }
+#endif
 
   Tuple* get_tuple(Tuple* table, uint64_t key) { return &table[key]; }
 };
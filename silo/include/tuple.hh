@@ -29,9 +29,25 @@ struct Tidword {
   bool operator<(const Tidword& right) const { return this->obj_ < right.obj_; }
 };
 
+#if SNAPSHOT_READ
+/**
+ * @brief Older version kept for snapshot transactions.
+ * @detail A version is immutable after it is linked to the chain.
+ */
+class Version {
+ public:
+  Tidword tidword_;
+  Version* prev_;  // older version
+  char val_[VAL_SIZE];
+};
+#endif
+
 class Tuple {
  public:
   alignas(CACHE_LINE_SIZE) Tidword tidword_;
+#if SNAPSHOT_READ
+  Version* prev_;  // newest version which was overwritten, only for snapshot
+#endif
 
   char val_[VAL_SIZE];
 };
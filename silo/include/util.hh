@@ -18,3 +18,5 @@ extern void partTableInit([[maybe_unused]] size_t thid, uint64_t start,
                           uint64_t end);
 
 extern void ShowOptParameters();
+
+extern void updateDurableEpoch();
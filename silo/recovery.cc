@@ -0,0 +1,209 @@
+/**
+ * Recovery from the logs written by silo.exe (WAL=1).
+ * It reads the log segments of all workers (log_dirs, log_segment_num),
+ * rebuilds the table and reports the log size and the recovery time.
+ * - value logging : it installs each after-image whose tid is newer than the
+ *   record's one. The order of application doesn't matter.
+ * - command logging (COMMAND_LOG=1) : it sorts the transactions by commit tid
+ *   and re-executes their procedures. Silo's tid is larger than the tid of any
+ *   record which the transaction read or wrote, so tid order is a valid serial
+ *   order for conflicting transactions.
+ * The logs must be written by the binary built with the same COMMAND_LOG and
+ * VAL_SIZE.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define GLOBAL_VALUE_DEFINE
+#include "include/common.hh"
+#include "include/log.hh"
+#include "include/tuple.hh"
+
+#include "../include/config.hh"
+#include "../include/debug.hh"
+#include "../include/fileio.hh"
+#include "../include/log_segment.hh"
+#include "../include/procedure.hh"
+#if COMMAND_LOG
+#include "../include/string.hh"
+#endif
+#include "../include/tsc.hh"
+#include "../include/util.hh"
+
+using namespace std;
+
+void initTable() {
+  if (posix_memalign((void **)&Table, PAGE_SIZE,
+                     (FLAGS_tuple_num) * sizeof(Tuple)) != 0)
+    ERR;
+
+  for (uint64_t i = 0; i < FLAGS_tuple_num; ++i) {
+    Table[i].tidword_.obj_ = 0;
+#if SNAPSHOT_READ
+    Table[i].prev_ = nullptr;
+#endif
+    Table[i].val_[0] = 'a';
+    Table[i].val_[1] = '\0';
+  }
+}
+
+#if COMMAND_LOG
+/**
+ * @brief collect command log records of one log file.
+ * @detail A package whose checksum doesn't match and packages after it are
+ * ignored, because they may be torn.
+ * @param [in] buf contents of the log file.
+ * @param [out] recs head of each command log record.
+ * @return void
+ */
+void collectCmdLog(vector<char> &buf, vector<const uint64_t *> &recs) {
+  size_t pos = 0;
+  while (pos + sizeof(CmdLogHeader) <= buf.size()) {
+    CmdLogHeader *hd = reinterpret_cast<CmdLogHeader *>(&buf[pos]);
+    pos += sizeof(CmdLogHeader);
+    if (pos + hd->logWordNum_ * sizeof(uint64_t) > buf.size()) break;
+
+    const uint64_t *words = reinterpret_cast<const uint64_t *>(&buf[pos]);
+    if (hd->chkSum_ + CmdLogRecord::computeChkSum(words, hd->logWordNum_) != 0)
+      break;
+
+    uint64_t i = 0;
+    while (i < hd->logWordNum_) {
+      recs.emplace_back(&words[i]);
+      i += CmdLogRecord::kHeaderWords + (words[i + 1] & 0xffffffff);
+    }
+    pos += hd->logWordNum_ * sizeof(uint64_t);
+  }
+}
+
+/**
+ * @brief re-execute command log records in commit tid order.
+ * @param [in] recs head of each command log record.
+ * @return void
+ */
+void replayCmdLog(vector<const uint64_t *> &recs) {
+  stable_sort(recs.begin(), recs.end(),
+              [](const uint64_t *a, const uint64_t *b) { return a[0] < b[0]; });
+
+  vector<vector<char>> write_vals;
+  char return_val[VAL_SIZE];
+  for (auto itr = recs.begin(); itr != recs.end(); ++itr) {
+    const uint64_t *rec = *itr;
+    CmdLogRecord hd;
+    hd.tid_ = rec[0];
+    hd.thid_ = rec[1] >> 32;
+    hd.ope_num_ = rec[1] & 0xffffffff;
+
+    if (write_vals.size() <= hd.thid_) write_vals.resize(hd.thid_ + 1);
+    if (write_vals[hd.thid_].empty()) {
+      write_vals[hd.thid_].resize(VAL_SIZE);
+      genStringRepeatedNumber(&write_vals[hd.thid_][0], VAL_SIZE, hd.thid_);
+    }
+
+    for (unsigned int i = 0; i < hd.ope_num_; ++i) {
+      Procedure pro =
+          CmdLogRecord::decodeOpe(rec[CmdLogRecord::kHeaderWords + i]);
+      Tuple *tuple = &Table[pro.key_];
+      if (pro.ope_ == Ope::READ || pro.ope_ == Ope::READ_MODIFY_WRITE)
+        memcpy(return_val, tuple->val_, VAL_SIZE);
+      if (pro.ope_ == Ope::WRITE || pro.ope_ == Ope::READ_MODIFY_WRITE) {
+        memcpy(tuple->val_, &write_vals[hd.thid_][0], VAL_SIZE);
+        tuple->tidword_.obj_ = hd.tid_;
+      }
+    }
+  }
+}
+#else
+/**
+ * @brief install the after-images of one log file.
+ * @detail A package whose checksum doesn't match and packages after it are
+ * ignored, because they may be torn.
+ * @param [in] buf contents of the log file.
+ * @return the number of log records.
+ */
+uint64_t replayValueLog(vector<char> &buf) {
+  uint64_t recnum = 0;
+  size_t pos = 0;
+  while (pos + sizeof(LogHeader) <= buf.size()) {
+    LogHeader *hd = reinterpret_cast<LogHeader *>(&buf[pos]);
+    pos += sizeof(LogHeader);
+    if (pos + hd->logRecNum_ * sizeof(LogRecord) > buf.size()) break;
+
+    LogRecord *recs = reinterpret_cast<LogRecord *>(&buf[pos]);
+    int chkSum = 0;
+    for (unsigned int i = 0; i < hd->logRecNum_; ++i)
+      chkSum += recs[i].computeChkSum();
+    if (hd->chkSum_ + chkSum != 0) break;
+
+    for (unsigned int i = 0; i < hd->logRecNum_; ++i) {
+      Tuple *tuple = &Table[recs[i].key_];
+      if (tuple->tidword_.obj_ < recs[i].tid_) {
+        memcpy(tuple->val_, recs[i].val_, VAL_SIZE);
+        tuple->tidword_.obj_ = recs[i].tid_;
+      }
+    }
+    recnum += hd->logRecNum_;
+    pos += hd->logRecNum_ * sizeof(LogRecord);
+  }
+
+  return recnum;
+}
+#endif
+
+int main(int argc, char *argv[]) try {
+  gflags::SetUsageMessage("Silo recovery.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  initTable();
+
+  uint64_t start, read_end, stop;
+  uint64_t log_bytes(0), recnum(0);
+  vector<vector<char>> bufs(FLAGS_thread_num);
+
+  std::vector<std::string> log_dirs;
+  splitLogDirs(FLAGS_log_dirs, log_dirs);
+
+  start = rdtscp();
+  for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
+    if (!LogSegmentManager::readAll(log_dirs, i, FLAGS_log_segment_num,
+                                    bufs[i])) {
+      cout << "log segments of worker " << i
+           << " are missing. They were recycled (-log_recycle) or removed, "
+              "so the log can't be replayed."
+           << endl;
+      ERR;
+    }
+    log_bytes += bufs[i].size();
+  }
+  read_end = rdtscp();
+
+#if COMMAND_LOG
+  vector<const uint64_t *> recs;
+  for (auto &buf : bufs) collectCmdLog(buf, recs);
+  replayCmdLog(recs);
+  recnum = recs.size();
+#else
+  for (auto &buf : bufs) recnum += replayValueLog(buf);
+#endif
+  stop = rdtscp();
+
+  cout << "#COMMAND_LOG:\t" << COMMAND_LOG << endl;
+  cout << "log_bytes:\t" << log_bytes << endl;
+#if COMMAND_LOG
+  cout << "recovered_transactions:\t" << recnum << endl;
+#else
+  cout << "recovered_records:\t" << recnum << endl;
+#endif
+  cout << "read_log_time[ms]:\t"
+       << (read_end - start) / FLAGS_clocks_per_us / 1000 << endl;
+  cout << "replay_time[ms]:\t"
+       << (stop - read_end) / FLAGS_clocks_per_us / 1000 << endl;
+  cout << "recovery_time[ms]:\t"
+       << (stop - start) / FLAGS_clocks_per_us / 1000 << endl;
+
+  return 0;
+} catch (bad_alloc) {
+  ERR;
+}
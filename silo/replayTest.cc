@@ -7,27 +7,31 @@
 
 #include "../include/debug.hh"
 #include "../include/fileio.hh"
+#include "../include/log_segment.hh"
 
 using std::cout;
 using std::endl;
 
-extern void genLogFile(std::string &logpath, const int thid);
-
 int main() {
-  std::string logpath;
-  genLogFileName(logpath, 1);
-  File loadfile(logpath, O_RDONLY, 0644);
+  std::vector<std::string> log_dirs;
+  splitLogDirs("", log_dirs);
+  std::vector<char> buf;
+  if (!LogSegmentManager::readAll(log_dirs, 1, 4, buf)) ERR;
+  if (buf.size() < sizeof(LogHeader)) ERR;
 
   LogHeader loadhd;
   LogRecord logrec;
+  size_t pos = 0;
 
-  loadfile.read((void *)&loadhd, sizeof(LogHeader));
+  memcpy((void *)&loadhd, &buf[pos], sizeof(LogHeader));
+  pos += sizeof(LogHeader);
   cout << "chkSum_ : " << loadhd.chkSum_ << endl;
   cout << "logRecNum_ : " << loadhd.logRecNum_ << endl;
 
   int chkSum_ = 0;
   for (unsigned int i = 0; i < loadhd.logRecNum_; ++i) {
-    loadfile.read((void *)&logrec, sizeof(LogRecord));
+    memcpy((void *)&logrec, &buf[pos], sizeof(LogRecord));
+    pos += sizeof(LogRecord);
     chkSum_ += logrec.computeChkSum();
     cout << "tid : " << logrec.tid_ << endl;
     cout << "key : " << logrec.key_ << endl;
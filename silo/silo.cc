@@ -39,7 +39,9 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
   rnd.init();
   TxnExecutor trans(thid, (Result*)&myres);
   FastZipf zipf(&rnd, FLAGS_zipf_skew, FLAGS_tuple_num);
+#if !MAINTENANCE_THREAD
   uint64_t epoch_timer_start, epoch_timer_stop;
+#endif
 #if BACK_OFF
   Backoff backoff(FLAGS_clocks_per_us);
 #endif
@@ -56,10 +58,10 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
   }
   std::string logpath("/tmp/ccbench");
   */
-  std::string logpath;
-  genLogFile(logpath, thid);
-  trans.logfile_.open(logpath, O_CREAT | O_TRUNC | O_WRONLY, 0644);
-  trans.logfile_.ftruncate(10 ^ 9);
+  std::vector<std::string> log_dirs;
+  splitLogDirs(FLAGS_log_dirs, log_dirs);
+  trans.logseg_.init(log_dirs, thid, FLAGS_log_segment_size,
+                     FLAGS_log_segment_num);
 #endif
 
 #ifdef Linux
@@ -75,7 +77,9 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
 
   storeRelease(ready, 1);
   while (!loadAcquire(start)) _mm_pause();
+#if !MAINTENANCE_THREAD
   if (thid == 0) epoch_timer_start = rdtscp();
+#endif
   while (!loadAcquire(quit)) {
 #if PARTITION_TABLE
     makeProcedure(trans.pro_set_, rnd, zipf, FLAGS_tuple_num, FLAGS_max_ope,
@@ -86,6 +90,7 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
                   FLAGS_thread_num, FLAGS_rratio, FLAGS_rmw, FLAGS_ycsb, false,
                   thid, myres);
 #endif
+    [[maybe_unused]] bool ronly = (*trans.pro_set_.begin()).ronly_;
 
 #if PROCEDURE_SORT
     sort(trans.pro_set_.begin(), trans.pro_set_.end());
@@ -93,7 +98,9 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
 
   RETRY:
     if (thid == 0) {
+#if !MAINTENANCE_THREAD
       leaderWork(epoch_timer_start, epoch_timer_stop);
+#endif
 #if BACK_OFF
       leaderBackoffWork(backoff, Result);
 #endif
@@ -102,6 +109,25 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
 
     if (loadAcquire(quit)) break;
 
+#if SNAPSHOT_READ
+    /**
+     * A read only transaction reads the snapshot without read set and
+     * validation, so it never aborts.
+     * If no snapshot is available yet, it runs as a normal transaction.
+     */
+    if (ronly && trans.beginSnapshot()) {
+      for (auto itr = trans.pro_set_.begin(); itr != trans.pro_set_.end();
+           ++itr)
+        trans.snapshotRead((*itr).key_);
+      storeRelease(myres.local_commit_counts_,
+                   loadAcquire(myres.local_commit_counts_) + 1);
+#if ADD_ANALYSIS
+      ++myres.local_ronly_commit_counts_;
+#endif
+      continue;
+    }
+#endif
+
     trans.begin();
     for (auto itr = trans.pro_set_.begin(); itr != trans.pro_set_.end();
          ++itr) {
@@ -125,13 +151,25 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
        */
       storeRelease(myres.local_commit_counts_,
                    loadAcquire(myres.local_commit_counts_) + 1);
+#if ADD_ANALYSIS
+      if (ronly) ++myres.local_ronly_commit_counts_;
+#endif
     } else {
       trans.abort();
       ++myres.local_abort_counts_;
+#if ADD_ANALYSIS
+      if (ronly) ++myres.local_ronly_abort_counts_;
+#endif
       goto RETRY;
     }
   }
 
+#if WAL
+  // the last batch which didn't fill the log buffer.
+  if (trans.logBuffered())
+    trans.flushLog(loadAcquire(ThLocalEpoch[thid].obj_));
+#endif
+
   return;
 }
 
@@ -151,11 +189,22 @@ int main(int argc, char* argv[]) try {
                      std::ref(quit));
   waitForReady(readys);
   storeRelease(start, true);
+#if MAINTENANCE_THREAD
+  MaintenanceThread maintainer;
+  maintainer.start(FLAGS_maintenance_tick_us, FLAGS_clocks_per_us,
+                   [epoch_timer_start = rdtscp(),
+                    epoch_timer_stop = uint64_t(0)]() mutable {
+                     leaderWork(epoch_timer_start, epoch_timer_stop);
+                   });
+#endif
   for (size_t i = 0; i < FLAGS_extime; ++i) {
     sleepMs(1000);
   }
   storeRelease(quit, true);
   for (auto& th : thv) th.join();
+#if MAINTENANCE_THREAD
+  maintainer.stop();
+#endif
 
   for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
     SiloResult[0].addLocalAllResult(SiloResult[i]);
@@ -163,6 +212,17 @@ int main(int argc, char* argv[]) try {
   ShowOptParameters();
   SiloResult[0].displayAllResult(FLAGS_clocks_per_us, FLAGS_extime,
                                  FLAGS_thread_num);
+  EpochStat.display("epoch", FLAGS_clocks_per_us);
+#if MAINTENANCE_THREAD
+  maintainer.display();
+#endif
+#if SNAPSHOT_READ && ADD_ANALYSIS
+  cout << "snapshot_version_bytes:\t"
+       << (SiloResult[0].total_version_malloc_ -
+           SiloResult[0].total_gc_version_counts_) *
+              sizeof(Version)
+       << endl;
+#endif
 
   return 0;
 } catch (bad_alloc) {
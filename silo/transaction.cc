@@ -138,6 +138,135 @@ FINISH_READ:
   return;
 }
 
+#if SNAPSHOT_READ
+/**
+ * @brief Begin a snapshot transaction for a declared read only transaction.
+ * @detail It publishes the epoch at begin as its local epoch, so the global
+ * epoch can't advance more than one epoch while it runs. Therefore versions
+ * which it may read are not collected by gcSnapshotVersion().
+ * @return true it can read the snapshot.
+ * @return false no snapshot is available yet.
+ */
+bool TxnExecutor::beginSnapshot() {
+  uint64_t epoch = atomicLoadGE();
+  atomicStoreThLocalEpoch(thid_, epoch);
+  asm volatile("" ::: "memory");
+  snapshot_epoch_ = snapshotEpoch(epoch);
+  return snapshot_epoch_ != 0;
+}
+
+/**
+ * @brief Read the newest version whose epoch is not greater than the snapshot
+ * epoch. It needs neither read set nor validation, so it never aborts.
+ * @param [in] key The key of key-value
+ */
+void TxnExecutor::snapshotRead(uint64_t key) {
+#if ADD_ANALYSIS
+  uint64_t start = rdtscp();
+#endif
+
+  Tuple *tuple;
+#if MASSTREE_USE
+  tuple = MT.get_value(key);
+#if ADD_ANALYSIS
+  ++sres_->local_tree_traversal_;
+#endif
+#else
+  tuple = get_tuple(Table, key);
+#endif
+
+  Tidword expected, check;
+  Version *ver;
+  expected.obj_ = loadAcquire(tuple->tidword_.obj_);
+  for (;;) {
+    /**
+     * A writer keeps the version which this snapshot needs before it
+     * overwrites the record, so newer record doesn't need to wait for the lock.
+     */
+    if (expected.epoch > snapshot_epoch_) break;
+    if (expected.lock) {
+      expected.obj_ = loadAcquire(tuple->tidword_.obj_);
+      continue;
+    }
+    memcpy(return_val_, tuple->val_, VAL_SIZE);
+    check.obj_ = loadAcquire(tuple->tidword_.obj_);
+    if (expected == check) goto FINISH_SNAPSHOT_READ;
+    expected = check;
+#if ADD_ANALYSIS
+    ++sres_->local_extra_reads_;
+#endif
+  }
+
+  ver = loadAcquire(tuple->prev_);
+  while (ver != nullptr && ver->tidword_.epoch > snapshot_epoch_)
+    ver = loadAcquire(ver->prev_);
+  if (ver == nullptr) ERR;
+  memcpy(return_val_, ver->val_, VAL_SIZE);
+
+FINISH_SNAPSHOT_READ:
+
+#if ADD_ANALYSIS
+  sres_->local_read_latency_ += rdtscp() - start;
+#endif
+  return;
+}
+
+/**
+ * @brief Keep the current version of a locked record for snapshot
+ * transactions before it is overwritten.
+ * @param [in] tuple record locked by this transaction.
+ * @param [in] newtid tid of the new version.
+ * @return void
+ */
+void TxnExecutor::keepSnapshotVersion(Tuple *tuple, Tidword newtid) {
+  Tidword oldtid;
+  oldtid.obj_ = loadAcquire(tuple->tidword_.obj_);
+  if (snapshotBucket(oldtid.epoch) < snapshotBucket(newtid.epoch)) {
+    Version *ver = new Version();
+    ver->tidword_ = oldtid;
+    ver->tidword_.lock = 0;
+    ver->prev_ = tuple->prev_;
+    memcpy(ver->val_, tuple->val_, VAL_SIZE);
+    storeRelease(tuple->prev_, ver);
+#if ADD_ANALYSIS
+    ++sres_->local_version_malloc_;
+#endif
+  }
+
+  gcSnapshotVersion(tuple);
+}
+
+/**
+ * @brief Collect versions which no snapshot transaction reads.
+ * @detail Running snapshot transactions began at the global epoch - 1 or
+ * later, so their snapshot epochs are not less than min_snapshot.
+ * They stop at the first version whose epoch is not greater than
+ * min_snapshot, so versions older than it are garbage.
+ * @param [in] tuple record locked by this transaction.
+ * @return void
+ */
+void TxnExecutor::gcSnapshotVersion(Tuple *tuple) {
+  uint64_t min_snapshot = snapshotEpoch(atomicLoadGE() - 1);
+  if (min_snapshot == 0) return;
+
+  Version *ver = tuple->prev_;
+  while (ver != nullptr && ver->tidword_.epoch > min_snapshot)
+    ver = ver->prev_;
+  if (ver == nullptr) return;
+
+  Version *garbage = ver->prev_;
+  storeRelease(ver->prev_, nullptr);
+  while (garbage != nullptr) {
+    Version *next = garbage->prev_;
+    delete garbage;
+    garbage = next;
+#if ADD_ANALYSIS
+    ++sres_->local_gc_version_counts_;
+#endif
+  }
+}
+#endif
+
 /**
  * @brief Transaction write function.
  * @param [in] key The key of key-value
@@ -191,6 +320,14 @@ bool TxnExecutor::validationPhase() {
   if (this->status_ == TransactionStatus::kAborted) return false;
 #endif
 
+#if REPAIR
+  uint64_t repair_num(0);
+  bool repaired;
+VALIDATE:
+  repaired = false;
+  max_rset_.obj_ = 0;
+#endif
+
   asm volatile("" ::: "memory");
   atomicStoreThLocalEpoch(thid_, atomicLoadGE());
   asm volatile("" ::: "memory");
@@ -206,6 +343,13 @@ bool TxnExecutor::validationPhase() {
     check.obj_ = loadAcquire((*itr).rcdptr_->tidword_.obj_);
     if ((*itr).tidword_.epoch != check.epoch ||
         (*itr).tidword_.tid != check.tid) {
+#if REPAIR
+      if (repair_num < FLAGS_repair_threshold && repairRead(&(*itr))) {
+        ++repair_num;
+        repaired = true;
+        continue;
+      }
+#endif
 #if ADD_ANALYSIS
       sres_->local_vali_latency_ += rdtscp() - start;
 #endif
@@ -226,6 +370,19 @@ bool TxnExecutor::validationPhase() {
     max_rset_ = max(max_rset_, check);
   }
 
+#if REPAIR
+  /**
+   * Repaired reads happened after the epoch was loaded and after other
+   * elements were validated, so it loads the epoch and validates the whole
+   * read set again. Then all reads are valid at the same time, as they are
+   * without repair.
+   */
+  if (repaired) goto VALIDATE;
+#if ADD_ANALYSIS
+  if (repair_num) ++sres_->local_repair_commit_counts_;
+#endif
+#endif
+
   // goto Phase 3
 #if ADD_ANALYSIS
   sres_->local_vali_latency_ += rdtscp() - start;
@@ -234,6 +391,42 @@ bool TxnExecutor::validationPhase() {
   return true;
 }
 
+#if REPAIR
+/**
+ * @brief Re-read an invalidated record of the read set while holding the
+ * locks of the write set.
+ * @detail Write values and keys of operations don't depend on read values in
+ * this benchmark, so the re-read is all that dependent operations need.
+ * It never waits for the lock of other transactions, because they may wait
+ * for the locks which this transaction holds.
+ * @param [in,out] re invalidated element of the read set.
+ * @return true the element holds the current value and tid.
+ * @return false the record is locked by other transaction.
+ */
+bool TxnExecutor::repairRead(ReadElement<Tuple> *re) {
+  Tuple *tuple = re->rcdptr_;
+  Tidword expected, check;
+
+  expected.obj_ = loadAcquire(tuple->tidword_.obj_);
+  if (expected.lock) {
+    if (!searchWriteSet(re->key_)) return false;
+    // locked by this transaction, so nobody changes it.
+    memcpy(re->val_, tuple->val_, VAL_SIZE);
+    expected.lock = 0;
+  } else {
+    memcpy(re->val_, tuple->val_, VAL_SIZE);
+    check.obj_ = loadAcquire(tuple->tidword_.obj_);
+    if (expected != check) return false;
+  }
+  re->tidword_ = expected;
+
+#if ADD_ANALYSIS
+  ++sres_->local_repair_counts_;
+#endif
+  return true;
+}
+#endif
+
 /**
  * @brief function about abort.
  * Clean-up local read/write set.
@@ -246,6 +439,10 @@ void TxnExecutor::abort() {
   read_set_.clear();
   write_set_.clear();
 
+#if WAL
+  advanceDurableEpoch();
+#endif
+
 #if BACK_OFF
 #if ADD_ANALYSIS
   uint64_t start(rdtscp());
@@ -260,32 +457,115 @@ void TxnExecutor::abort() {
 }
 
 void TxnExecutor::wal(uint64_t ctid) {
+  Tidword tid;
+  tid.obj_ = ctid;
+  if (!write_set_.empty() && log_set_.empty()) log_epoch_ = tid.epoch;
   for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
     LogRecord log(ctid, (*itr).key_, write_val_);
     log_set_.emplace_back(log);
     latest_log_header_.chkSum_ += log.computeChkSum();
     ++latest_log_header_.logRecNum_;
+#if ADD_ANALYSIS
+    sres_->local_log_bytes_ += sizeof(LogRecord);
+#endif
   }
 
-  if (log_set_.size() > LOGSET_SIZE / 2) {
-    // prepare write header
-    latest_log_header_.convertChkSumIntoComplementOnTwo();
+  if (log_set_.size() > LOGSET_SIZE / 2) flushLog(tid.epoch);
+  advanceDurableEpoch();
+}
 
-    // write header
-    logfile_.write((void *)&latest_log_header_, sizeof(LogHeader));
+/**
+ * @brief command logging.
+ * @detail It appends the procedure vector of this transaction instead of
+ * after-images of its write set. The log size does not depend on VAL_SIZE.
+ * Read only transactions change nothing, so they are not logged.
+ * @param [in] ctid commit tid of this transaction.
+ * @return void
+ */
+void TxnExecutor::cmdwal(uint64_t ctid) {
+  Tidword tid;
+  tid.obj_ = ctid;
+  if (!write_set_.empty()) {
+    if (cmd_log_set_.empty()) log_epoch_ = tid.epoch;
+    size_t head = cmd_log_set_.size();
+    cmd_log_set_.emplace_back(ctid);
+    cmd_log_set_.emplace_back((static_cast<uint64_t>(thid_) << 32) |
+                              pro_set_.size());
+    for (auto itr = pro_set_.begin(); itr != pro_set_.end(); ++itr)
+      cmd_log_set_.emplace_back(CmdLogRecord::encodeOpe(*itr));
+
+    size_t words = cmd_log_set_.size() - head;
+    cmd_log_header_.chkSum_ +=
+        CmdLogRecord::computeChkSum(&cmd_log_set_[head], words);
+    ++cmd_log_header_.logTxNum_;
+    cmd_log_header_.logWordNum_ += words;
+#if ADD_ANALYSIS
+    sres_->local_log_bytes_ += words * sizeof(uint64_t);
+#endif
+  }
 
-    // write log record
-    // for (auto itr = log_set_.begin(); itr != log_set_.end(); ++itr)
-    //  logfile_.write((void *)&(*itr), sizeof(LogRecord));
-    logfile_.write((void *)&(log_set_[0]),
-                   sizeof(LogRecord) * latest_log_header_.logRecNum_);
+  if (cmd_log_header_.logTxNum_ > LOGSET_SIZE / 2) flushLog(tid.epoch);
+  advanceDurableEpoch();
+}
 
-    // logfile_.fdatasync();
+/**
+ * @brief write the buffered log to the log segment and sync it.
+ * @param [in] epoch the largest epoch of the buffered log records.
+ * @return void
+ */
+void TxnExecutor::flushLog(uint64_t epoch) {
+  if (FLAGS_log_recycle)
+    logseg_.setReclaimEpoch(loadAcquire(DurableEpoch.obj_));
+
+#if COMMAND_LOG
+  // prepare write header
+  cmd_log_header_.convertChkSumIntoComplementOnTwo();
+
+  // write header and log records
+  struct iovec iov[2] = {
+      {&cmd_log_header_, sizeof(CmdLogHeader)},
+      {&(cmd_log_set_[0]), sizeof(uint64_t) * cmd_log_header_.logWordNum_}};
+  logseg_.write(iov, 2, epoch);
+#if ADD_ANALYSIS
+  sres_->local_log_bytes_ += sizeof(CmdLogHeader);
+#endif
+  logseg_.fdatasync();
 
-    // clear for next transactions.
-    latest_log_header_.init();
-    log_set_.clear();
-  }
+  // clear for next transactions.
+  cmd_log_header_.init();
+  cmd_log_set_.clear();
+#else
+  // prepare write header
+  latest_log_header_.convertChkSumIntoComplementOnTwo();
+
+  // write header and log records
+  struct iovec iov[2] = {
+      {&latest_log_header_, sizeof(LogHeader)},
+      {&(log_set_[0]), sizeof(LogRecord) * latest_log_header_.logRecNum_}};
+  logseg_.write(iov, 2, epoch);
+#if ADD_ANALYSIS
+  sres_->local_log_bytes_ += sizeof(LogHeader);
+#endif
+  logseg_.fdatasync();
+
+  // clear for next transactions.
+  latest_log_header_.init();
+  log_set_.clear();
+#endif
+}
+
+/**
+ * @brief publish the epoch up to which logs of this worker are durable.
+ * @detail Logs buffered since an earlier epoch are flushed first, so every log
+ * record of the epochs before the local epoch is on the log segment. A worker
+ * which buffers nothing, e.g. a read only one, advances it as well, as Silo's
+ * loggers do, so that it doesn't hold back DurableEpoch.
+ * @return void
+ */
+void TxnExecutor::advanceDurableEpoch() {
+  uint64_t epoch = loadAcquire(ThLocalEpoch[thid_].obj_);
+  if (logBuffered() && log_epoch_ < epoch) flushLog(epoch);
+  if (epoch > 0) storeRelease(ThLocalDurableEpoch[thid_].obj_, epoch - 1);
 }
 
 void TxnExecutor::writePhase() {
@@ -316,11 +596,18 @@ void TxnExecutor::writePhase() {
   mrctid_ = maxtid;
 
 #if WAL
+#if COMMAND_LOG
+  cmdwal(maxtid.obj_);
+#else
   wal(maxtid.obj_);
+#endif
 #endif
 
   // write(record, commit-tid)
   for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
+#if SNAPSHOT_READ
+    keepSnapshotVersion((*itr).rcdptr_, maxtid);
+#endif
     // update and unlock
     memcpy((*itr).rcdptr_->val_, write_val_, VAL_SIZE);
     storeRelease((*itr).rcdptr_->tidword_.obj_, maxtid.obj_);
@@ -41,9 +41,17 @@ void chkArg() {
     ERR;
   }
 
+  if (FLAGS_snapshot_interval == 0) {
+    cout << "FLAGS_snapshot_interval must be larger than 0." << endl;
+    ERR;
+  }
+
   if (posix_memalign((void **)&ThLocalEpoch, CACHE_LINE_SIZE,
                      FLAGS_thread_num * sizeof(uint64_t_64byte)) != 0)
     ERR;
+  if (posix_memalign((void **)&ThLocalDurableEpoch, CACHE_LINE_SIZE,
+                     FLAGS_thread_num * sizeof(uint64_t_64byte)) != 0)
+    ERR;
   if (posix_memalign((void **)&CTIDW, CACHE_LINE_SIZE,
                      FLAGS_thread_num * sizeof(uint64_t_64byte)) != 0)
     ERR;
@@ -51,6 +59,7 @@ void chkArg() {
   // init
   for (unsigned int i = 0; i < FLAGS_thread_num; ++i) {
     ThLocalEpoch[i].obj_ = 0;
+    ThLocalDurableEpoch[i].obj_ = 0;
     CTIDW[i].obj_ = 0;
   }
 }
@@ -58,7 +67,9 @@ void chkArg() {
 bool chkEpochLoaded() {
   uint64_t nowepo = atomicLoadGE();
   //全てのワーカースレッドが最新エポックを読み込んだか確認する．
-  for (unsigned int i = 1; i < FLAGS_thread_num; ++i) {
+  // Thread 0 is the leader unless the maintenance thread advances epochs.
+  for (unsigned int i = MAINTENANCE_THREAD ? 0 : 1; i < FLAGS_thread_num;
+       ++i) {
     if (__atomic_load_n(&(ThLocalEpoch[i].obj_), __ATOMIC_ACQUIRE) != nowepo)
       return false;
   }
@@ -83,9 +94,16 @@ void displayParameter() {
   cout << "#FLAGS_clocks_per_us:\t" << FLAGS_clocks_per_us << endl;
   cout << "#FLAGS_epoch_time:\t" << FLAGS_epoch_time << endl;
   cout << "#FLAGS_extime:\t\t" << FLAGS_extime << endl;
+  cout << "#FLAGS_log_dirs:\t" << FLAGS_log_dirs << endl;
+  cout << "#FLAGS_log_recycle:\t" << FLAGS_log_recycle << endl;
+  cout << "#FLAGS_log_segment_num:\t" << FLAGS_log_segment_num << endl;
+  cout << "#FLAGS_log_segment_size:\t" << FLAGS_log_segment_size << endl;
+  cout << "#FLAGS_maintenance_tick_us:\t" << FLAGS_maintenance_tick_us << endl;
   cout << "#FLAGS_max_ope:\t\t" << FLAGS_max_ope << endl;
+  cout << "#FLAGS_repair_threshold:\t" << FLAGS_repair_threshold << endl;
   cout << "#FLAGS_rmw:\t\t" << FLAGS_rmw << endl;
   cout << "#FLAGS_rratio:\t\t" << FLAGS_rratio << endl;
+  cout << "#FLAGS_snapshot_interval:\t" << FLAGS_snapshot_interval << endl;
   cout << "#FLAGS_thread_num:\t" << FLAGS_thread_num << endl;
   cout << "#FLAGS_tuple_num:\t" << FLAGS_tuple_num << endl;
   cout << "#FLAGS_ycsb:\t\t" << FLAGS_ycsb << endl;
@@ -108,6 +126,9 @@ void partTableInit([[maybe_unused]] size_t thid, uint64_t start, uint64_t end) {
     tmp->tidword_.epoch = 1;
     tmp->tidword_.latest = 1;
     tmp->tidword_.lock = 0;
+#if SNAPSHOT_READ
+    tmp->prev_ = nullptr;
+#endif
     tmp->val_[0] = 'a';
     tmp->val_[1] = '\0';
 
@@ -142,16 +163,33 @@ void leaderWork(uint64_t &epoch_timer_start, uint64_t &epoch_timer_stop) {
                  FLAGS_epoch_time * FLAGS_clocks_per_us * 1000) &&
       chkEpochLoaded()) {
     atomicAddGE();
+    EpochStat.record(epoch_timer_stop,
+                     FLAGS_epoch_time * FLAGS_clocks_per_us * 1000);
     epoch_timer_start = epoch_timer_stop;
+#if WAL
+    updateDurableEpoch();
+    LogSegmentManager::refillAll();
+#endif
+  }
+}
+
+void updateDurableEpoch() {
+  uint64_t min_epoch = loadAcquire(ThLocalDurableEpoch[0].obj_);
+  for (unsigned int i = 1; i < FLAGS_thread_num; ++i) {
+    min_epoch = min(min_epoch, loadAcquire(ThLocalDurableEpoch[i].obj_));
   }
+  storeRelease(DurableEpoch.obj_, min_epoch);
 }
 
 void ShowOptParameters() {
   cout << "#ShowOptParameters()"
        << ": ADD_ANALYSIS " << ADD_ANALYSIS << ": BACK_OFF " << BACK_OFF
-       << ": KEY_SIZE " << KEY_SIZE << ": MASSTREE_USE " << MASSTREE_USE
+       << ": COMMAND_LOG " << COMMAND_LOG << ": KEY_SIZE " << KEY_SIZE
+       << ": MAINTENANCE_THREAD " << MAINTENANCE_THREAD << ": MASSTREE_USE "
+       << MASSTREE_USE
        << ": NO_WAIT_LOCKING_IN_VALIDATION " << NO_WAIT_LOCKING_IN_VALIDATION
        << ": PARTITION_TABLE " << PARTITION_TABLE << ": PROCEDURE_SORT "
-       << PROCEDURE_SORT << ": SLEEP_READ_PHASE " << SLEEP_READ_PHASE
+       << PROCEDURE_SORT << ": REPAIR " << REPAIR << ": SLEEP_READ_PHASE "
+       << SLEEP_READ_PHASE << ": SNAPSHOT_READ " << SNAPSHOT_READ
        << ": VAL_SIZE " << VAL_SIZE << ": WAL " << WAL << endl;
 }
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "../../include/cache_line_size.hh"
+
+/**
+ * @brief Outcome of the tries of the transactions of a worker thread for
+ * early lock release (BAMBOO).
+ * @detail Transactions which read data written by a try before it commits
+ * depend on the try, and read its outcome at their commit. Each try has its
+ * own sequence number. state_ has the sequence number and the status of the
+ * current try, and committed_ remembers which of the last kHistory tries
+ * committed. A try older than that is taken as aborted, which is always safe.
+ */
+class alignas(CACHE_LINE_SIZE) TxOutcome {
+ public:
+  enum Status : uint64_t {
+    running = 0,
+    committed = 1,
+    aborted = 2,
+  };
+  static constexpr uint64_t kHistory = 64;
+
+  std::atomic<uint64_t> state_;
+  std::atomic<uint64_t> committed_;
+
+  TxOutcome() : state_(0), committed_(0) {}
+
+  /**
+   * @brief start a new try.
+   * @return sequence number of the try.
+   */
+  uint64_t begin() {
+    uint64_t seq = (state_.load(std::memory_order_relaxed) >> 2) + 1;
+    // forget the try which shares the bit before the new try is visible.
+    committed_.fetch_and(~(1ULL << (seq % kHistory)));
+    state_.store(seq << 2 | running);
+    return seq;
+  }
+
+  void finish(bool commit) {
+    uint64_t seq = state_.load(std::memory_order_relaxed) >> 2;
+    if (commit) committed_.fetch_or(1ULL << (seq % kHistory));
+    state_.store(seq << 2 | (commit ? committed : aborted));
+  }
+
+  Status check(uint64_t seq) {
+    uint64_t state = state_.load();
+    if (state >> 2 == seq) return static_cast<Status>(state & 3);
+    uint64_t bits = committed_.load();
+    // the bit may belong to a later try.
+    if ((state_.load() >> 2) - seq >= kHistory) return aborted;
+    return (bits >> (seq % kHistory)) & 1 ? committed : aborted;
+  }
+};
+
+/**
+ * @brief Token of a try which wrote a record and released the lock early.
+ * 0 means no such try.
+ */
+inline uint64_t makeDirtyToken(std::size_t thid, uint64_t seq) {
+  return (static_cast<uint64_t>(thid) + 1) << 48 | seq;
+}
+
+inline std::size_t dirtyTokenThid(uint64_t token) { return (token >> 48) - 1; }
+
+inline uint64_t dirtyTokenSeq(uint64_t token) {
+  return token & ((1ULL << 48) - 1);
+}
@@ -5,11 +5,18 @@
 #include "../../include/cache_line_size.hh"
 #include "../../include/int64byte.hh"
 #include "../../include/masstree_wrapper.hh"
+#include "lock_table.hh"
 #include "tuple.hh"
 
 #include "gflags/gflags.h"
 #include "glog/logging.h"
 
+// early lock release breaks waits for commit dependencies by wound-wait, and
+// needs the lock of each record.
+#if BAMBOO && (!defined(DLR3) || LOCK_TABLE)
+#error "BAMBOO=1 needs DLR=3 and LOCK_TABLE=0."
+#endif
+
 #ifdef GLOBAL_VALUE_DEFINE
 #define GLOBAL
 
@@ -30,6 +37,8 @@ alignas(CACHE_LINE_SIZE) GLOBAL MasstreeWrapper<Tuple> MT;
 DEFINE_uint64(clocks_per_us, 2100,
               "CPU_MHz. Use this info for measuring time.");
 DEFINE_uint64(extime, 3, "Execution time[sec].");
+DEFINE_uint64(lock_buckets, 65536,
+              "Number of buckets of the lock table (LOCK_TABLE=1).");
 DEFINE_uint64(max_ope, 10,
               "Total number of operations per single transaction.");
 DEFINE_bool(rmw, false,
@@ -43,6 +52,7 @@ DEFINE_double(zipf_skew, 0, "zipf skew. 0 ~ 0.999...");
 #else
 DECLARE_uint64(clocks_per_us);
 DECLARE_uint64(extime);
+DECLARE_uint64(lock_buckets);
 DECLARE_uint64(max_ope);
 DECLARE_bool(rmw);
 DECLARE_uint64(rratio);
@@ -53,3 +63,12 @@ DECLARE_double(zipf_skew);
 #endif
 
 alignas(CACHE_LINE_SIZE) GLOBAL Tuple *Table;
+#if LOCK_TABLE
+alignas(CACHE_LINE_SIZE) GLOBAL LockTable LockTbl;
+#endif
+#if defined(DLR2) || defined(DLR3)
+alignas(CACHE_LINE_SIZE) GLOBAL TxPriority *Priorities;
+#endif
+#if BAMBOO
+alignas(CACHE_LINE_SIZE) GLOBAL TxOutcome *Outcomes;
+#endif
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "../../include/cache_line_size.hh"
+#include "../../include/locks.hh"
+
+/**
+ * @brief Lock request of a transaction in the lock table.
+ * @detail It is an owner of the key once granted_ is set. upgrading_ is set
+ * while an owner in shared mode waits for the upgrade to exclusive mode.
+ */
+class LockTableNode {
+ public:
+  uint64_t key_;
+  uint32_t thid_;
+  bool exclusive_;
+  bool upgrading_;
+  std::atomic<bool> granted_;
+  LockTableNode *next_;
+
+  void init(uint64_t key, uint32_t thid, bool exclusive) {
+    key_ = key;
+    thid_ = thid;
+    exclusive_ = exclusive;
+    upgrading_ = false;
+    granted_.store(false, std::memory_order_relaxed);
+    next_ = nullptr;
+  }
+};
+
+/**
+ * @brief Lock of a key which is held or waited for.
+ * @detail Upgrading owners are served before waiters_, and waiters_ are
+ * served in FIFO order. A head exists only while it has requests, so cold
+ * records cost nothing and keys need not exist.
+ */
+class LockHead {
+ public:
+  uint64_t key_;
+  LockTableNode *owners_ = nullptr;
+  LockTableNode *waiters_ = nullptr;
+  LockTableNode *waiters_tail_ = nullptr;
+  uint32_t upgrading_ = 0;
+  LockHead *next_ = nullptr;
+
+  bool compatible(bool exclusive) {
+    return waiters_ == nullptr && upgrading_ == 0 &&
+           (owners_ == nullptr || (!exclusive && !owners_->exclusive_));
+  }
+};
+
+/**
+ * @brief Bucket of the lock table. The latch protects its heads and their
+ * requests.
+ */
+class alignas(CACHE_LINE_SIZE) LockBucket {
+ public:
+  TTASLock latch_;
+  LockHead *heads_ = nullptr;
+  // recycled heads.
+  LockHead *free_ = nullptr;
+};
+
+/**
+ * @brief Centralized lock manager partitioned into hash buckets.
+ * @detail A waiter spins on granted_ of its own request, and the releaser
+ * grants it under the latch. The dead lock resolution (DLR0..3) decides what
+ * a conflicting request does: DLR0 waits, DLR1 aborts, DLR2 waits only for
+ * younger owners and waiters, and DLR3 wounds younger ones and waits.
+ */
+class LockTable {
+ public:
+  LockBucket *buckets_ = nullptr;
+  std::size_t mask_ = 0;
+
+  void init(std::size_t buckets);
+
+  /**
+   * @brief acquire the lock of node->key_.
+   * @return false if the transaction must abort.
+   */
+  bool lock(LockTableNode *node);
+
+  /**
+   * @brief upgrade the granted shared lock of node to exclusive mode.
+   * @return false if the transaction must abort. It still holds the shared
+   * lock then.
+   */
+  bool upgrade(LockTableNode *node);
+
+  void unlock(LockTableNode *node);
+
+ private:
+  LockBucket &bucketOf(uint64_t key) {
+    return buckets_[(key * 0x9e3779b97f4a7c15ULL >> 32) & mask_];
+  }
+
+  LockHead *findHead(LockBucket &bucket, uint64_t key, bool create);
+  void freeHeadIfUnused(LockBucket &bucket, LockHead *head);
+  void grant(LockHead *head);
+  bool conflict(LockHead *head, LockTableNode *node, bool waiters);
+  bool wait(LockBucket &bucket, LockHead *head, LockTableNode *node);
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "../../include/cache_line_size.hh"
+
+/**
+ * @brief Priority of the transaction of a worker thread for wait-die (DLR2)
+ * and wound-wait (DLR3).
+ * @detail ts_ is taken when a transaction starts and is kept across its
+ * retries, so a transaction gets relatively older until it commits. Ties are
+ * broken by thread id. wounded_ is set by an older transaction which waits for
+ * this one (DLR3).
+ */
+class alignas(CACHE_LINE_SIZE) TxPriority {
+ public:
+  std::atomic<uint64_t> ts_;
+  std::atomic<bool> wounded_;
+
+  TxPriority() : ts_(0), wounded_(false) {}
+};
+
+/**
+ * @brief whether the transaction of thread a is older than that of thread b.
+ * @param [in] prio priorities of all worker threads.
+ */
+inline bool olderThan(const TxPriority *prio, std::size_t a, std::size_t b) {
+  uint64_t ats = prio[a].ts_.load(std::memory_order_acquire);
+  uint64_t bts = prio[b].ts_.load(std::memory_order_acquire);
+  return ats < bts || (ats == bts && a < b);
+}
+
+/**
+ * @brief Set of worker threads, e.g. owners or waiters of the lock of a
+ * record.
+ * @detail An owner joins after it gets the lock and leaves before it releases
+ * the lock, so the owners are the holders except for these windows.
+ */
+class ThreadSet {
+ public:
+  static constexpr std::size_t kWords = 4;
+  static constexpr std::size_t kMaxThreads = kWords * 64;
+
+  std::atomic<uint64_t> bits_[kWords];
+
+  void init() {
+    for (std::size_t i = 0; i < kWords; ++i)
+      bits_[i].store(0, std::memory_order_relaxed);
+  }
+
+  void add(std::size_t thid) {
+    bits_[thid / 64].fetch_or(1ULL << (thid % 64), std::memory_order_release);
+  }
+
+  void remove(std::size_t thid) {
+    bits_[thid / 64].fetch_and(~(1ULL << (thid % 64)),
+                               std::memory_order_release);
+  }
+
+  /**
+   * @brief call f(thid) for each owner except me.
+   * @return whether there was another owner.
+   */
+  template <typename F>
+  bool forEachOther(std::size_t me, F f) {
+    bool found = false;
+    for (std::size_t i = 0; i < kWords; ++i) {
+      uint64_t bits = bits_[i].load(std::memory_order_acquire);
+      if (i == me / 64) bits &= ~(1ULL << (me % 64));
+      while (bits) {
+        found = true;
+        f(i * 64 + __builtin_ctzll(bits));
+        bits &= bits - 1;
+      }
+    }
+    return found;
+  }
+};
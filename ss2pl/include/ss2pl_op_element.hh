@@ -7,7 +7,18 @@ class SetElement : public OpElement<T> {
  public:
   using OpElement<T>::OpElement;
 
+  // value read, or the before image of a write with early lock release
+  // (BAMBOO).
   char val_[VAL_SIZE];
+#if ADD_ANALYSIS
+  uint64_t locked_at_;
+#endif
+#if BAMBOO
+  // dirty token of the record before the write.
+  uint64_t prev_dirty_;
+  // the write lock was released early.
+  bool retired_;
+#endif
 
   SetElement(uint64_t key, T *rcdptr) : OpElement<T>::OpElement(key, rcdptr) {}
 
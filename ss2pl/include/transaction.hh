@@ -4,7 +4,6 @@
 
 #include "../../include/procedure.hh"
 #include "../../include/result.hh"
-#include "../../include/rwlock.hh"
 #include "../../include/string.hh"
 #include "../../include/util.hh"
 #include "ss2pl_op_element.hh"
@@ -16,15 +15,35 @@ enum class TransactionStatus : uint8_t {
   aborted,
 };
 
+enum class LockRequest : uint8_t {
+  read,
+  write,
+  upgrade,
+};
+
 extern void writeValGenerator(char* writeVal, size_t val_size, size_t thid);
 
 class TxExecutor {
  public:
   alignas(CACHE_LINE_SIZE) int thid_;
-  std::vector<RWLock*> r_lock_list_;
-  std::vector<RWLock*> w_lock_list_;
+#if LOCK_TABLE
+  // requests to the lock table. lock_list_ has the granted ones.
+  std::vector<LockTableNode> lock_nodes_;
+  std::vector<LockTableNode*> lock_list_;
+#else
+  std::vector<SelectedLock*> r_lock_list_;
+  std::vector<SelectedLock*> w_lock_list_;
+#endif
   TransactionStatus status_ = TransactionStatus::inFlight;
   Result* sres_;
+#if BAMBOO
+  // token which marks records written by this try.
+  uint64_t dirty_token_ = 0;
+  // tokens of uncommitted writers it read from.
+  std::vector<uint64_t> deps_;
+  // number of operations started by this try.
+  std::size_t ope_idx_ = 0;
+#endif
   vector<SetElement<Tuple>> read_set_;
   vector<SetElement<Tuple>> write_set_;
   vector<Procedure> pro_set_;
@@ -36,14 +55,23 @@ class TxExecutor {
     read_set_.reserve(FLAGS_max_ope);
     write_set_.reserve(FLAGS_max_ope);
     pro_set_.reserve(FLAGS_max_ope);
+#if BAMBOO
+    deps_.reserve(FLAGS_max_ope);
+#endif
+#if LOCK_TABLE
+    lock_nodes_ = std::vector<LockTableNode>(FLAGS_max_ope);
+    lock_list_.reserve(FLAGS_max_ope);
+#else
     r_lock_list_.reserve(FLAGS_max_ope);
     w_lock_list_.reserve(FLAGS_max_ope);
+#endif
 
     genStringRepeatedNumber(write_val_, VAL_SIZE, thid);
   }
 
   SetElement<Tuple>* searchReadSet(uint64_t key);
   SetElement<Tuple>* searchWriteSet(uint64_t key);
+  void allocatePriority();
   void begin();
   void read(uint64_t key);
   void write(uint64_t key);
@@ -51,7 +79,34 @@ class TxExecutor {
   void commit();
   void abort();
   void unlockList();
+  void addWriteSet(uint64_t key, Tuple* tuple);
+#if BAMBOO
+  bool dependOn(Tuple* tuple, LockRequest req);
+  void installWrite(SetElement<Tuple>& we);
+  bool lastAccess(uint64_t key);
+  void undoRetiredWrites();
+  bool waitDependencies();
+#endif
+#if LOCK_TABLE
+  LockTableNode* searchLockList(uint64_t key);
+#elif defined(DLR2) || defined(DLR3)
+  bool lockByPriority(Tuple* tuple, LockRequest req);
+#endif
 
   // inline
   Tuple* get_tuple(Tuple* table, uint64_t key) { return &table[key]; }
+
+#if LOCK_TABLE
+  /**
+   * @brief Request a lock of the lock table.
+   * @return false if the transaction must abort.
+   */
+  bool lockTable(uint64_t key, bool exclusive) {
+    LockTableNode* node = &lock_nodes_[lock_list_.size()];
+    node->init(key, thid_, exclusive);
+    if (!LockTbl.lock(node)) return false;
+    lock_list_.emplace_back(node);
+    return true;
+  }
+#endif
 };
@@ -5,12 +5,27 @@
 
 #include "../../include/cache_line_size.hh"
 #include "../../include/inline.hh"
-#include "../../include/rwlock.hh"
+#include "../../include/locks.hh"
+#include "bamboo.hh"
+#include "priority.hh"
 
 using namespace std;
 
 class Tuple {
  public:
-  alignas(CACHE_LINE_SIZE) RWLock lock_;
+#if LOCK_TABLE
+  // locks are in the lock table.
+  alignas(CACHE_LINE_SIZE) char val_[VAL_SIZE];
+#else
+  alignas(CACHE_LINE_SIZE) SelectedLock lock_;
+#if defined(DLR2) || defined(DLR3)
+  ThreadSet owners_;
+  ThreadSet waiters_;
+#endif
+#if BAMBOO
+  // uncommitted writer which released the lock early.
+  std::atomic<uint64_t> dirty_;
+#endif
   char val_[VAL_SIZE];
+#endif
 };
@@ -0,0 +1,279 @@
+#include <xmmintrin.h>
+
+#include "../include/debug.hh"
+#include "../include/result.hh"
+#include "../include/tsc.hh"
+#include "include/common.hh"
+#include "include/lock_table.hh"
+#include "include/result.hh"
+
+/**
+ * @brief Allocate buckets.
+ * @param [in] buckets number of buckets. It is rounded up to a power of two.
+ * @return void
+ */
+void LockTable::init(std::size_t buckets) {
+  std::size_t size = 1;
+  while (size < buckets) size <<= 1;
+  buckets_ = new LockBucket[size];
+  mask_ = size - 1;
+}
+
+bool LockTable::lock(LockTableNode *node) {
+#ifdef DLR3
+  if (Priorities[node->thid_].wounded_.load(std::memory_order_acquire)) {
+#if ADD_ANALYSIS
+    ++SS2PLResult[node->thid_].local_wounded_aborts_;
+#endif
+    return false;
+  }
+#endif
+
+  LockBucket &bucket = bucketOf(node->key_);
+  bucket.latch_.w_lock();
+  LockHead *head = findHead(bucket, node->key_, true);
+  if (head->compatible(node->exclusive_)) {
+    node->next_ = head->owners_;
+    head->owners_ = node;
+    node->granted_.store(true, std::memory_order_relaxed);
+    bucket.latch_.w_unlock();
+    return true;
+  }
+
+  if (!conflict(head, node, true)) {
+    bucket.latch_.w_unlock();
+    return false;
+  }
+  if (head->waiters_tail_ != nullptr)
+    head->waiters_tail_->next_ = node;
+  else
+    head->waiters_ = node;
+  head->waiters_tail_ = node;
+  bucket.latch_.w_unlock();
+
+  return wait(bucket, head, node);
+}
+
+bool LockTable::upgrade(LockTableNode *node) {
+#ifdef DLR3
+  if (Priorities[node->thid_].wounded_.load(std::memory_order_acquire)) {
+#if ADD_ANALYSIS
+    ++SS2PLResult[node->thid_].local_wounded_aborts_;
+#endif
+    return false;
+  }
+#endif
+
+  LockBucket &bucket = bucketOf(node->key_);
+  bucket.latch_.w_lock();
+  LockHead *head = findHead(bucket, node->key_, false);
+  if (head->owners_ == node && node->next_ == nullptr) {
+    // sole owner.
+    node->exclusive_ = true;
+    bucket.latch_.w_unlock();
+    return true;
+  }
+
+  // two upgraders would wait for each other.
+  if (head->upgrading_ != 0 || !conflict(head, node, false)) {
+    bucket.latch_.w_unlock();
+    return false;
+  }
+  node->upgrading_ = true;
+  ++head->upgrading_;
+  node->granted_.store(false, std::memory_order_relaxed);
+  bucket.latch_.w_unlock();
+
+  return wait(bucket, head, node);
+}
+
+void LockTable::unlock(LockTableNode *node) {
+  LockBucket &bucket = bucketOf(node->key_);
+  bucket.latch_.w_lock();
+  LockHead *head = findHead(bucket, node->key_, false);
+  for (LockTableNode **itr = &head->owners_; *itr != nullptr;
+       itr = &(*itr)->next_) {
+    if (*itr == node) {
+      *itr = node->next_;
+      break;
+    }
+  }
+  grant(head);
+  freeHeadIfUnused(bucket, head);
+  bucket.latch_.w_unlock();
+}
+
+/**
+ * @brief find the head of the key in the bucket.
+ * @pre the latch of the bucket is held.
+ * @param [in] create create the head if it doesn't exist.
+ */
+LockHead *LockTable::findHead(LockBucket &bucket, uint64_t key, bool create) {
+  for (LockHead *head = bucket.heads_; head != nullptr; head = head->next_)
+    if (head->key_ == key) return head;
+  if (!create) ERR;
+
+  LockHead *head = bucket.free_;
+  if (head != nullptr)
+    bucket.free_ = head->next_;
+  else
+    head = new LockHead();
+  head->key_ = key;
+  head->owners_ = nullptr;
+  head->waiters_ = nullptr;
+  head->waiters_tail_ = nullptr;
+  head->upgrading_ = 0;
+  head->next_ = bucket.heads_;
+  bucket.heads_ = head;
+  return head;
+}
+
+/**
+ * @brief recycle the head if no request remains.
+ * @pre the latch of the bucket is held.
+ */
+void LockTable::freeHeadIfUnused(LockBucket &bucket, LockHead *head) {
+  if (head->owners_ != nullptr || head->waiters_ != nullptr ||
+      head->upgrading_ != 0)
+    return;
+  for (LockHead **itr = &bucket.heads_; *itr != nullptr;
+       itr = &(*itr)->next_) {
+    if (*itr == head) {
+      *itr = head->next_;
+      break;
+    }
+  }
+  head->next_ = bucket.free_;
+  bucket.free_ = head;
+}
+
+/**
+ * @brief grant the upgrade or the waiters which became compatible.
+ * @pre the latch of the bucket is held.
+ */
+void LockTable::grant(LockHead *head) {
+  if (head->upgrading_ != 0) {
+    // waiters wait behind the upgrader.
+    LockTableNode *owner = head->owners_;
+    if (owner->next_ == nullptr && owner->upgrading_) {
+      owner->upgrading_ = false;
+      owner->exclusive_ = true;
+      --head->upgrading_;
+      owner->granted_.store(true, std::memory_order_release);
+    }
+    return;
+  }
+
+  while (head->waiters_ != nullptr) {
+    LockTableNode *waiter = head->waiters_;
+    // an exclusive owner is the only owner.
+    if (head->owners_ != nullptr &&
+        (waiter->exclusive_ || head->owners_->exclusive_))
+      break;
+    head->waiters_ = waiter->next_;
+    if (head->waiters_ == nullptr) head->waiters_tail_ = nullptr;
+    waiter->next_ = head->owners_;
+    head->owners_ = waiter;
+    waiter->granted_.store(true, std::memory_order_release);
+  }
+}
+
+/**
+ * @brief decide whether the conflicting request waits, by DLRx.
+ * @pre the latch of the bucket is held.
+ * @param [in] waiters whether node waits behind the waiters too. An upgrade
+ * waits only for the other owners.
+ * @return true if it waits, false if the transaction must abort.
+ */
+bool LockTable::conflict([[maybe_unused]] LockHead *head,
+                         [[maybe_unused]] LockTableNode *node,
+                         [[maybe_unused]] bool waiters) {
+#ifdef DLR1
+  return false;
+#elif defined(DLR2) || defined(DLR3)
+  [[maybe_unused]] bool die = false;
+  auto decide = [&](LockTableNode *other) {
+    if (other == node) return;
+#ifdef DLR2
+    if (olderThan(Priorities, other->thid_, node->thid_)) die = true;
+#else
+    if (olderThan(Priorities, node->thid_, other->thid_) &&
+        !Priorities[other->thid_].wounded_.exchange(
+            true, std::memory_order_acq_rel)) {
+#if ADD_ANALYSIS
+      ++SS2PLResult[node->thid_].local_wounds_;
+#endif
+    }
+#endif
+  };
+  for (LockTableNode *itr = head->owners_; itr != nullptr; itr = itr->next_)
+    decide(itr);
+  if (waiters)
+    for (LockTableNode *itr = head->waiters_; itr != nullptr; itr = itr->next_)
+      decide(itr);
+#ifdef DLR2
+  if (die) {
+#if ADD_ANALYSIS
+    ++SS2PLResult[node->thid_].local_dies_;
+#endif
+    return false;
+  }
+#endif
+  return true;
+#else
+  return true;
+#endif
+}
+
+/**
+ * @brief wait until the request is granted.
+ * @detail With DLR3, a wounded waiter cancels its request.
+ * @pre the request is queued and the latch of the bucket is released.
+ * @return false if the transaction must abort.
+ */
+bool LockTable::wait([[maybe_unused]] LockBucket &bucket,
+                     [[maybe_unused]] LockHead *head, LockTableNode *node) {
+#if ADD_ANALYSIS
+  uint64_t start = rdtscp();
+#endif
+  bool granted = true;
+  while (!node->granted_.load(std::memory_order_acquire)) {
+#ifdef DLR3
+    if (Priorities[node->thid_].wounded_.load(std::memory_order_acquire)) {
+      bucket.latch_.w_lock();
+      if (!node->granted_.load(std::memory_order_relaxed)) {
+        if (node->upgrading_) {
+          // it still holds the shared lock.
+          node->upgrading_ = false;
+          --head->upgrading_;
+          node->granted_.store(true, std::memory_order_relaxed);
+        } else {
+          LockTableNode *prev = nullptr;
+          for (LockTableNode *itr = head->waiters_; itr != node;
+               itr = itr->next_)
+            prev = itr;
+          if (prev != nullptr)
+            prev->next_ = node->next_;
+          else
+            head->waiters_ = node->next_;
+          if (head->waiters_tail_ == node) head->waiters_tail_ = prev;
+        }
+        grant(head);
+        freeHeadIfUnused(bucket, head);
+        granted = false;
+#if ADD_ANALYSIS
+        ++SS2PLResult[node->thid_].local_wounded_aborts_;
+#endif
+      }
+      bucket.latch_.w_unlock();
+      break;
+    }
+#endif
+    _mm_pause();
+  }
+
+#if ADD_ANALYSIS
+  SS2PLResult[node->thid_].local_lock_wait_latency_ += rdtscp() - start;
+#endif
+  return granted;
+}
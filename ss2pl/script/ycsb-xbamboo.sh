@@ -0,0 +1,37 @@
+#ycsb-xbamboo.sh(ss2pl)
+# compare wound-wait with and without early lock release (BAMBOO) on a
+# skewed write-heavy workload.
+tuple=1000000
+maxope=16
+rratio=50
+skew=0.99
+cpu_mhz=2100
+extime=3
+
+host=`hostname`
+dbs11="dbs11"
+
+#basically
+thread=24
+if  test $host = $dbs11 ; then
+thread=224
+fi
+
+result=result_2pl_ycsbA_tuple1m_ope16_rmw_skew099_xbamboo.dat
+rm $result
+echo "#bamboo, tps, abort_rate, write_lock_hold[us], early_releases, cascading_aborts" >> $result
+
+for bamboo in 0 1
+do
+  cd ../
+  make clean; make -j DLR=3 BAMBOO=$bamboo
+  cd script/
+
+  numactl --interleave=all ../ss2pl.exe -clocks_per_us=$cpu_mhz -extime=$extime -max_ope=$maxope -rmw=1 -rratio=$rratio -thread_num=$thread -tuple_num=$tuple -ycsb=1 -zipf_skew=$skew > exp.txt
+  tmpTH=`grep throughput ./exp.txt | awk '{print $2}'`
+  tmpAR=`grep abort_rate ./exp.txt | awk '{print $2}'`
+  tmpHO=`grep write_lock_hold ./exp.txt | awk '{print $2}'`
+  tmpER=`grep early_releases ./exp.txt | awk '{print $2}'`
+  tmpCA=`grep cascading_aborts ./exp.txt | awk '{print $2}'`
+  echo "$bamboo $tmpTH $tmpAR $tmpHO $tmpER $tmpCA" >> $result
+done
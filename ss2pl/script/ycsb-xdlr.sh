@@ -0,0 +1,39 @@
+#ycsb-xdlr.sh(ss2pl)
+# compare dead lock resolutions (DLR0 timeout, DLR1 no-wait, DLR2 wait-die,
+# DLR3 wound-wait) on the same skewed workload.
+tuple=1000000
+maxope=16
+rratio=50
+skew=0.99
+cpu_mhz=2100
+extime=3
+
+host=`hostname`
+dbs11="dbs11"
+
+#basically
+thread=24
+if  test $host = $dbs11 ; then
+thread=224
+fi
+
+result=result_2pl_ycsbA_tuple1m_ope16_rmw_skew099_xdlr.dat
+rm $result
+echo "#dlr, tps, abort_counts, abort_rate, lock_wait_latency_rate, dies, wounds" >> $result
+
+for dlr in 0 1 2 3
+do
+  cd ../
+  make clean; make -j DLR=$dlr
+  cd script/
+
+  # DLR0 may deadlock, so the run is bounded.
+  timeout $((extime + 60)) numactl --interleave=all ../ss2pl.exe -clocks_per_us=$cpu_mhz -extime=$extime -max_ope=$maxope -rmw=1 -rratio=$rratio -thread_num=$thread -tuple_num=$tuple -ycsb=1 -zipf_skew=$skew > exp.txt
+  tmpTH=`grep throughput ./exp.txt | awk '{print $2}'`
+  tmpAC=`grep abort_counts ./exp.txt | awk '{print $2}'`
+  tmpAR=`grep abort_rate ./exp.txt | awk '{print $2}'`
+  tmpLW=`grep lock_wait_latency_rate ./exp.txt | awk '{print $2}'`
+  tmpDI=`grep "^dies" ./exp.txt | awk '{print $2}'`
+  tmpWO=`grep "^wounds" ./exp.txt | awk '{print $2}'`
+  echo "$dlr $tmpTH $tmpAC $tmpAR $tmpLW $tmpDI $tmpWO" >> $result
+done
@@ -0,0 +1,40 @@
+#ycsbC-xlock.sh(ss2pl)
+# scalability of record locks on read-only skewed YCSB-C: the counter
+# reader-writer lock (LOCK_KIND 0), BRAVO (6) and distributed reader
+# indicators (7) from 1 thread to all cores.
+tuple=1000000
+maxope=10
+rratio=100
+skew=0.99
+cpu_mhz=2100
+extime=3
+
+host=`hostname`
+dbs11="dbs11"
+
+#basically
+enth=24
+inc=4
+if  test $host = $dbs11 ; then
+enth=224
+inc=28
+fi
+
+result=result_2pl_ycsbC_tuple1m_skew099_xlock.dat
+rm $result
+echo "#lock_kind, thread, tps, abort_rate" >> $result
+
+for kind in 0 6 7
+do
+  cd ../
+  make clean; make -j LOCK_KIND=$kind
+  cd script/
+
+  for thread in 1 `seq $inc $inc $enth`
+  do
+    numactl --interleave=all ../ss2pl.exe -clocks_per_us=$cpu_mhz -extime=$extime -max_ope=$maxope -rratio=$rratio -thread_num=$thread -tuple_num=$tuple -ycsb=1 -zipf_skew=$skew > exp.txt
+    tmpTH=`grep throughput ./exp.txt | awk '{print $2}'`
+    tmpAR=`grep abort_rate ./exp.txt | awk '{print $2}'`
+    echo "$kind $thread $tmpTH $tmpAR" >> $result
+  done
+done
@@ -55,6 +55,7 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
   while (!loadAcquire(quit)) {
     makeProcedure(trans.pro_set_, rnd, zipf, FLAGS_tuple_num, FLAGS_max_ope, FLAGS_thread_num,
                   FLAGS_rratio, FLAGS_rmw, FLAGS_ycsb, false, thid, myres);
+    trans.allocatePriority();
   RETRY:
     if (loadAcquire(quit)) break;
     if (thid == 0) leaderBackoffWork(backoff, SS2PLResult);
@@ -79,6 +80,13 @@ void worker(size_t thid, char& ready, const bool& start, const bool& quit) {
     }
 
     trans.commit();
+#if BAMBOO
+    // a transaction it read from aborted.
+    if (trans.status_ == TransactionStatus::aborted) {
+      trans.abort();
+      goto RETRY;
+    }
+#endif
     /**
      * local_commit_counts is used at ../include/backoff.hh to calcurate about
      * backoff.
@@ -54,10 +54,21 @@ inline SetElement<Tuple> *TxExecutor::searchWriteSet(uint64_t key) {
  * @return void
  */
 void TxExecutor::abort() {
+#if BAMBOO
+  // transactions which depend on it abort as soon as they see this.
+  Outcomes[thid_].finish(false);
+  // restore the writes whose locks it still holds.
+  for (auto itr = write_set_.rbegin(); itr != write_set_.rend(); ++itr)
+    if (!(*itr).retired_) memcpy((*itr).rcdptr_->val_, (*itr).val_, VAL_SIZE);
+#endif
+
 	/**
 	 * Release locks
 	 */
   unlockList();
+#if BAMBOO
+  undoRetiredWrites();
+#endif
 
 	/**
 	 * Clean-up local read/write set.
@@ -83,15 +94,32 @@ void TxExecutor::abort() {
 
 /**
  * @brief success termination of transaction.
+ * @detail With BAMBOO, it waits until the transactions it depends on commit,
+ * and sets status_ aborted if one of them aborted.
  * @return void
  */
 void TxExecutor::commit() {
+#if BAMBOO
+  // writes are already in place.
+  if (!waitDependencies()) {
+    this->status_ = TransactionStatus::aborted;
+    return;
+  }
+  Outcomes[thid_].finish(true);
+  // later transactions need not depend on its writes.
+  for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
+    uint64_t token = dirty_token_;
+    if ((*itr).retired_)
+      (*itr).rcdptr_->dirty_.compare_exchange_strong(token, 0);
+  }
+#else
   for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
 		/**
 		 * update payload.
 		 */
     memcpy((*itr).rcdptr_->val_, write_val_, VAL_SIZE);
   }
+#endif
 
 	/**
 	 * Release locks.
@@ -105,12 +133,34 @@ void TxExecutor::commit() {
   write_set_.clear();
 }
 
+/**
+ * @brief Allocate the priority timestamp of a new transaction.
+ * @detail It is kept across retries of the transaction, so wait-die and
+ * wound-wait let it win eventually.
+ * @return void
+ */
+void TxExecutor::allocatePriority() {
+#if defined(DLR2) || defined(DLR3)
+  Priorities[thid_].ts_.store(rdtscp(), std::memory_order_release);
+#endif
+}
+
 /**
  * @brief Initialize function of transaction.
- * Allocate timestamp.
  * @return void
  */
-void TxExecutor::begin() { this->status_ = TransactionStatus::inFlight; }
+void TxExecutor::begin() {
+  this->status_ = TransactionStatus::inFlight;
+#ifdef DLR3
+  // wounds to the previous try are obsolete.
+  Priorities[thid_].wounded_.store(false, std::memory_order_release);
+#endif
+#if BAMBOO
+  dirty_token_ = makeDirtyToken(thid_, Outcomes[thid_].begin());
+  deps_.clear();
+  ope_idx_ = 0;
+#endif
+}
 
 /**
  * @brief Transaction read function.
@@ -120,6 +170,9 @@ void TxExecutor::read(uint64_t key) {
 #if ADD_ANALYSIS
   uint64_t start = rdtscp();
 #endif  // ADD_ANALYSIS
+#if BAMBOO
+  ++ope_idx_;
+#endif
 
   /**
    * read-own-writes or re-read from local read set.
@@ -139,7 +192,14 @@ void TxExecutor::read(uint64_t key) {
   tuple = get_tuple(Table, key);
 #endif
 
-#ifdef DLR0
+#if LOCK_TABLE
+  if (lockTable(key, false)) {
+    read_set_.emplace_back(key, tuple, tuple->val_);
+  } else {
+    this->status_ = TransactionStatus::aborted;
+    goto FINISH_READ;
+  }
+#elif defined(DLR0)
 	/**
 	 * Acquire lock with wait.
 	 */
@@ -157,6 +217,14 @@ void TxExecutor::read(uint64_t key) {
     this->status_ = TransactionStatus::aborted;
     goto FINISH_READ;
   }
+#elif defined(DLR2) || defined(DLR3)
+  if (lockByPriority(tuple, LockRequest::read)) {
+    r_lock_list_.emplace_back(&tuple->lock_);
+    read_set_.emplace_back(key, tuple, tuple->val_);
+  } else {
+    this->status_ = TransactionStatus::aborted;
+    goto FINISH_READ;
+  }
 #endif
 
 FINISH_READ:
@@ -176,32 +244,53 @@ void TxExecutor::write(uint64_t key) {
 #if ADD_ANALYSIS
   uint64_t start = rdtscp();
 #endif
+#if BAMBOO
+  ++ope_idx_;
+#endif
 
   // if it already wrote the key object once.
   if (searchWriteSet(key)) goto FINISH_WRITE;
 
   for (auto rItr = read_set_.begin(); rItr != read_set_.end(); ++rItr) {
     if ((*rItr).key_ == key) {  // hit
-#if DLR0
-      (*rItr).rcdptr_->lock_.upgrade();
+#if LOCK_TABLE
+      if (!LockTbl.upgrade(searchLockList(key))) {
+        this->status_ = TransactionStatus::aborted;
+        goto FINISH_WRITE;
+      }
+#elif DLR0
+      // queue reader-writer locks may fail to upgrade.
+      if (!(*rItr).rcdptr_->lock_.upgrade()) {
+        this->status_ = TransactionStatus::aborted;
+        goto FINISH_WRITE;
+      }
 #elif defined(DLR1)
       if (!(*rItr).rcdptr_->lock_.tryupgrade()) {
         this->status_ = TransactionStatus::aborted;
         goto FINISH_WRITE;
       }
+#elif defined(DLR2) || defined(DLR3)
+      if (!lockByPriority((*rItr).rcdptr_, LockRequest::upgrade)) {
+        this->status_ = TransactionStatus::aborted;
+        goto FINISH_WRITE;
+      }
 #endif
 
       // upgrade success
+#if LOCK_TABLE
+      addWriteSet(key, (*rItr).rcdptr_);
+#else
 			// remove old element of read lock list.
       for (auto lItr = r_lock_list_.begin(); lItr != r_lock_list_.end();
            ++lItr) {
         if (*lItr == &((*rItr).rcdptr_->lock_)) {
-          write_set_.emplace_back(key, (*rItr).rcdptr_);
           w_lock_list_.emplace_back(&(*rItr).rcdptr_->lock_);
+          addWriteSet(key, (*rItr).rcdptr_);
           r_lock_list_.erase(lItr);
           break;
         }
       }
+#endif
 
       read_set_.erase(rItr);
       goto FINISH_WRITE;
@@ -221,7 +310,12 @@ void TxExecutor::write(uint64_t key) {
   tuple = get_tuple(Table, key);
 #endif
 
-#if DLR0
+#if LOCK_TABLE
+  if (!lockTable(key, true)) {
+    this->status_ = TransactionStatus::aborted;
+    goto FINISH_WRITE;
+  }
+#elif DLR0
 	/**
 	 * Lock with wait.
 	 */
@@ -234,13 +328,20 @@ void TxExecutor::write(uint64_t key) {
     this->status_ = TransactionStatus::aborted;
     goto FINISH_WRITE;
   }
+#elif defined(DLR2) || defined(DLR3)
+  if (!lockByPriority(tuple, LockRequest::write)) {
+    this->status_ = TransactionStatus::aborted;
+    goto FINISH_WRITE;
+  }
 #endif
 
 	/**
 	 * Register the contents to write lock list and write set.
 	 */
+#if !LOCK_TABLE
   w_lock_list_.emplace_back(&tuple->lock_);
-  write_set_.emplace_back(key, tuple);
+#endif
+  addWriteSet(key, tuple);
 
 FINISH_WRITE:
 #if ADD_ANALYSIS
@@ -253,13 +354,26 @@ FINISH_WRITE:
  * @brief transaction readWrite (RMW) operation
  */
 void TxExecutor::readWrite(uint64_t key) {
+#if BAMBOO
+  ++ope_idx_;
+#endif
+
   // if it already wrote the key object once.
   if (searchWriteSet(key)) goto FINISH_WRITE;
 
   for (auto rItr = read_set_.begin(); rItr != read_set_.end(); ++rItr) {
     if ((*rItr).key_ == key) {  // hit
-#if DLR0
-      (*rItr).rcdptr_->lock_.upgrade();
+#if LOCK_TABLE
+      if (!LockTbl.upgrade(searchLockList(key))) {
+        this->status_ = TransactionStatus::aborted;
+        goto FINISH_WRITE;
+      }
+#elif DLR0
+      // queue reader-writer locks may fail to upgrade.
+      if (!(*rItr).rcdptr_->lock_.upgrade()) {
+        this->status_ = TransactionStatus::aborted;
+        goto FINISH_WRITE;
+      }
 #elif defined(DLR1)
       if (!(*rItr).rcdptr_->lock_.tryupgrade()) {
 				/**
@@ -268,19 +382,28 @@ void TxExecutor::readWrite(uint64_t key) {
         this->status_ = TransactionStatus::aborted;
         goto FINISH_WRITE;
       }
+#elif defined(DLR2) || defined(DLR3)
+      if (!lockByPriority((*rItr).rcdptr_, LockRequest::upgrade)) {
+        this->status_ = TransactionStatus::aborted;
+        goto FINISH_WRITE;
+      }
 #endif
 
       // upgrade success
+#if LOCK_TABLE
+      addWriteSet(key, (*rItr).rcdptr_);
+#else
 			// remove old element of read set.
       for (auto lItr = r_lock_list_.begin(); lItr != r_lock_list_.end();
            ++lItr) {
         if (*lItr == &((*rItr).rcdptr_->lock_)) {
-          write_set_.emplace_back(key, (*rItr).rcdptr_);
           w_lock_list_.emplace_back(&(*rItr).rcdptr_->lock_);
+          addWriteSet(key, (*rItr).rcdptr_);
           r_lock_list_.erase(lItr);
           break;
         }
       }
+#endif
 
       read_set_.erase(rItr);
       goto FINISH_WRITE;
@@ -300,7 +423,12 @@ void TxExecutor::readWrite(uint64_t key) {
   tuple = get_tuple(Table, key);
 #endif
 
-#if DLR0
+#if LOCK_TABLE
+  if (!lockTable(key, true)) {
+    this->status_ = TransactionStatus::aborted;
+    goto FINISH_WRITE;
+  }
+#elif DLR0
 	/**
 	 * Lock with wait.
 	 */
@@ -313,6 +441,11 @@ void TxExecutor::readWrite(uint64_t key) {
     this->status_ = TransactionStatus::aborted;
     goto FINISH_WRITE;
   }
+#elif defined(DLR2) || defined(DLR3)
+  if (!lockByPriority(tuple, LockRequest::write)) {
+    this->status_ = TransactionStatus::aborted;
+    goto FINISH_WRITE;
+  }
 #endif
 
   // read payload
@@ -322,8 +455,10 @@ void TxExecutor::readWrite(uint64_t key) {
 	/**
 	 * Register the contents to write lock list and write set.
 	 */
+#if !LOCK_TABLE
   w_lock_list_.emplace_back(&tuple->lock_);
-  write_set_.emplace_back(key, tuple);
+#endif
+  addWriteSet(key, tuple);
 
 FINISH_WRITE:
   return;
@@ -334,6 +469,30 @@ FINISH_WRITE:
  * @return void
  */
 void TxExecutor::unlockList() {
+#if ADD_ANALYSIS
+  uint64_t now = rdtscp();
+  for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr) {
+#if BAMBOO
+    if ((*itr).retired_) continue;
+#endif
+    sres_->local_write_lock_hold_ += now - (*itr).locked_at_;
+    ++sres_->local_write_locks_;
+  }
+#endif
+
+#if LOCK_TABLE
+  for (auto itr = lock_list_.begin(); itr != lock_list_.end(); ++itr)
+    LockTbl.unlock(*itr);
+  lock_list_.clear();
+#else
+#if defined(DLR2) || defined(DLR3)
+  // leave the owners before the locks are released.
+  for (auto itr = read_set_.begin(); itr != read_set_.end(); ++itr)
+    (*itr).rcdptr_->owners_.remove(thid_);
+  for (auto itr = write_set_.begin(); itr != write_set_.end(); ++itr)
+    (*itr).rcdptr_->owners_.remove(thid_);
+#endif
+
   for (auto itr = r_lock_list_.begin(); itr != r_lock_list_.end(); ++itr)
     (*itr)->r_unlock();
 
@@ -345,4 +504,267 @@ void TxExecutor::unlockList() {
 	 */
   r_lock_list_.clear();
   w_lock_list_.clear();
+#endif
+}
+
+/**
+ * @brief Register the record whose write lock it got to the write set.
+ * @param [in] key the key of key-value.
+ * @param [in] tuple the record.
+ */
+void TxExecutor::addWriteSet(uint64_t key, Tuple *tuple) {
+  write_set_.emplace_back(key, tuple);
+#if ADD_ANALYSIS
+  write_set_.back().locked_at_ = rdtscp();
+#endif
+#if BAMBOO
+  installWrite(write_set_.back());
+#endif
+}
+
+#if BAMBOO
+/**
+ * @brief Record the commit dependency on the uncommitted writer of the
+ * record, which released the lock early.
+ * @detail A transaction depends only on older ones, so dependencies can't
+ * form a cycle. For a younger writer, it wounds the writer and aborts, since
+ * the writer can't roll back the record while it holds the lock. It aborts
+ * too if the writer already aborted (cascading abort).
+ * @pre it got the lock of the record and joined the owners.
+ * @post the lock is released if it returns false.
+ * @param [in] tuple the record.
+ * @param [in] req read or write.
+ * @return false if the transaction must abort.
+ */
+bool TxExecutor::dependOn(Tuple *tuple, LockRequest req) {
+  uint64_t token = tuple->dirty_.load(std::memory_order_acquire);
+  if (token == 0) return true;
+
+  std::size_t writer = dirtyTokenThid(token);
+  TxOutcome::Status status = Outcomes[writer].check(dirtyTokenSeq(token));
+  if (status == TxOutcome::committed) return true;
+  if (status == TxOutcome::running) {
+    if (olderThan(Priorities, writer, thid_)) {
+      deps_.emplace_back(token);
+      return true;
+    }
+    if (!Priorities[writer].wounded_.exchange(true,
+                                              std::memory_order_acq_rel)) {
+#if ADD_ANALYSIS
+      ++sres_->local_wounds_;
+#endif
+    }
+  } else {
+#if ADD_ANALYSIS
+    ++sres_->local_cascading_aborts_;
+#endif
+  }
+
+  tuple->owners_.remove(thid_);
+  if (req == LockRequest::read)
+    tuple->lock_.r_unlock();
+  else
+    tuple->lock_.w_unlock();
+  return false;
+}
+
+/**
+ * @brief Write the record in place, and release the write lock if no later
+ * operation of the transaction accesses the record.
+ * @detail The record keeps the token of the try until it commits, so later
+ * transactions depend on it. The before image is kept to roll back.
+ * @pre it holds the write lock of the record, which is the last one of
+ * w_lock_list_.
+ * @param [in] we the element of the write set.
+ */
+void TxExecutor::installWrite(SetElement<Tuple> &we) {
+  Tuple *tuple = we.rcdptr_;
+  memcpy(we.val_, tuple->val_, VAL_SIZE);
+  memcpy(tuple->val_, write_val_, VAL_SIZE);
+  we.retired_ = false;
+  if (!lastAccess(we.key_)) return;
+
+  we.prev_dirty_ = tuple->dirty_.load(std::memory_order_acquire);
+  tuple->dirty_.store(dirty_token_, std::memory_order_release);
+  we.retired_ = true;
+  tuple->owners_.remove(thid_);
+  w_lock_list_.pop_back();
+  tuple->lock_.w_unlock();
+#if ADD_ANALYSIS
+  sres_->local_write_lock_hold_ += rdtscp() - we.locked_at_;
+  ++sres_->local_write_locks_;
+  ++sres_->local_early_releases_;
+#endif
+}
+
+/**
+ * @brief Whether no later operation of the transaction accesses the key.
+ * @param [in] key the key of key-value.
+ */
+bool TxExecutor::lastAccess(uint64_t key) {
+  for (auto itr = pro_set_.begin() + ope_idx_; itr != pro_set_.end(); ++itr)
+    if ((*itr).key_ == key) return false;
+  return true;
+}
+
+/**
+ * @brief Roll back the records whose write locks it released early.
+ * @detail Later writers of a record depend on it and abort too. They roll
+ * back first, which gives the token of this try back to the record, so the
+ * before images are restored in the reverse order of the writes.
+ * @pre it released all locks and published the abort.
+ */
+void TxExecutor::undoRetiredWrites() {
+  for (auto itr = write_set_.rbegin(); itr != write_set_.rend(); ++itr) {
+    if (!(*itr).retired_) continue;
+    Tuple *tuple = (*itr).rcdptr_;
+    for (;;) {
+      tuple->lock_.w_lock();
+      if (tuple->dirty_.load(std::memory_order_acquire) == dirty_token_) {
+        memcpy(tuple->val_, (*itr).val_, VAL_SIZE);
+        tuple->dirty_.store((*itr).prev_dirty_, std::memory_order_release);
+        tuple->lock_.w_unlock();
+        break;
+      }
+      tuple->lock_.w_unlock();
+      _mm_pause();
+    }
+  }
+}
+
+/**
+ * @brief Wait until the transactions it depends on commit.
+ * @return false if one of them aborted, or if it is wounded.
+ */
+bool TxExecutor::waitDependencies() {
+  for (auto itr = deps_.begin(); itr != deps_.end(); ++itr) {
+    TxOutcome &outcome = Outcomes[dirtyTokenThid(*itr)];
+    for (;;) {
+      TxOutcome::Status status = outcome.check(dirtyTokenSeq(*itr));
+      if (status == TxOutcome::committed) break;
+      if (status == TxOutcome::aborted) {
+#if ADD_ANALYSIS
+        ++sres_->local_cascading_aborts_;
+#endif
+        return false;
+      }
+      // an older transaction may wait for a lock it holds.
+      if (Priorities[thid_].wounded_.load(std::memory_order_acquire)) {
+#if ADD_ANALYSIS
+        ++sres_->local_wounded_aborts_;
+#endif
+        return false;
+      }
+      _mm_pause();
+    }
+  }
+  return true;
+}
+#endif
+
+#if LOCK_TABLE
+/**
+ * @brief Search the request of the lock table for the key.
+ * @param [in] key the key of key-value.
+ * @return granted request.
+ */
+LockTableNode *TxExecutor::searchLockList(uint64_t key) {
+  for (auto itr = lock_list_.begin(); itr != lock_list_.end(); ++itr)
+    if ((*itr)->key_ == key) return *itr;
+  ERR;
+}
+#elif defined(DLR2) || defined(DLR3)
+/**
+ * @brief Acquire the lock of the record by wait-die (DLR2) or wound-wait
+ * (DLR3).
+ * @detail It polls trylock and decides at each failure by the priorities of
+ * the current owners and waiters. Wait-die waits only for younger ones and
+ * dies otherwise. Wound-wait wounds younger owners, waits for the others, and
+ * aborts when it is wounded itself. An older transaction never waits for a
+ * younger one which can't be aborted, so it can't deadlock. trylock has no
+ * queue, so a requester doesn't overtake older waiters. Otherwise an aborted
+ * transaction could take the record again before the older waiter does.
+ * @param [in] tuple the record.
+ * @param [in] req read, write, or upgrade of the read lock held by me.
+ * @return false if the transaction must abort.
+ */
+bool TxExecutor::lockByPriority(Tuple *tuple, LockRequest req) {
+#if ADD_ANALYSIS
+  uint64_t start(0);
+#endif
+  bool locked = false;
+  bool waiting = false;
+  for (;;) {
+#ifdef DLR3
+    if (Priorities[thid_].wounded_.load(std::memory_order_acquire)) {
+#if ADD_ANALYSIS
+      ++sres_->local_wounded_aborts_;
+#endif
+      break;
+    }
+#endif
+
+    bool older_waiter = false;
+    tuple->waiters_.forEachOther(thid_, [&](size_t waiter) {
+      if (olderThan(Priorities, waiter, thid_)) older_waiter = true;
+    });
+    if (!older_waiter) {
+      if (req == LockRequest::read)
+        locked = tuple->lock_.r_trylock();
+      else if (req == LockRequest::write)
+        locked = tuple->lock_.w_trylock();
+      else
+        locked = tuple->lock_.tryupgrade();
+      if (locked) {
+        if (req != LockRequest::upgrade) {
+          tuple->owners_.add(thid_);
+#if BAMBOO
+          locked = dependOn(tuple, req);
+#endif
+        }
+        break;
+      }
+    }
+#if ADD_ANALYSIS
+    if (start == 0) start = rdtscp();
+#endif
+
+    [[maybe_unused]] bool die = older_waiter;
+    bool others = tuple->owners_.forEachOther(thid_, [&](size_t owner) {
+#ifdef DLR2
+      if (olderThan(Priorities, owner, thid_)) die = true;
+#else
+      if (olderThan(Priorities, thid_, owner) &&
+          !Priorities[owner].wounded_.exchange(true,
+                                               std::memory_order_acq_rel)) {
+#if ADD_ANALYSIS
+        ++sres_->local_wounds_;
+#endif
+      }
+#endif
+    });
+#ifdef DLR2
+    if (die) {
+#if ADD_ANALYSIS
+      ++sres_->local_dies_;
+#endif
+      break;
+    }
+#endif
+    // queue reader-writer locks can't upgrade after a later reader left, and
+    // nobody is there to wait for.
+    if (!others && !older_waiter && req == LockRequest::upgrade) break;
+    if (!waiting) {
+      tuple->waiters_.add(thid_);
+      waiting = true;
+    }
+    _mm_pause();
+  }
+
+  if (waiting) tuple->waiters_.remove(thid_);
+#if ADD_ANALYSIS
+  if (start) sres_->local_lock_wait_latency_ += rdtscp() - start;
+#endif
+  return locked;
 }
+#endif
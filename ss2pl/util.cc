@@ -36,6 +36,14 @@ void chkArg() {
     cout << "CPU_MHZ is less than 100. are your really?" << endl;
     ERR;
   }
+
+#if (defined(DLR2) || defined(DLR3)) && !LOCK_TABLE
+  if (FLAGS_thread_num > ThreadSet::kMaxThreads) {
+    cout << "DLR2 and DLR3 support up to " << ThreadSet::kMaxThreads
+         << " threads." << endl;
+    ERR;
+  }
+#endif
 }
 
 void displayDB() {
@@ -52,6 +60,7 @@ void displayDB() {
 void displayParameter() {
   cout << "#FLAGS_clocks_per_us:\t" << FLAGS_clocks_per_us << endl;
   cout << "#FLAGS_extime:\t\t" << FLAGS_extime << endl;
+  cout << "#FLAGS_lock_buckets:\t" << FLAGS_lock_buckets << endl;
   cout << "#FLAGS_max_ope:\t\t" << FLAGS_max_ope << endl;
   cout << "#FLAGS_rmw:\t\t" << FLAGS_rmw << endl;
   cout << "#FLAGS_rratio:\t\t" << FLAGS_rratio << endl;
@@ -70,6 +79,16 @@ void partTableInit([[maybe_unused]] size_t thid, uint64_t start, uint64_t end) {
   for (auto i = start; i <= end; ++i) {
     Table[i].val_[0] = 'a';
     Table[i].val_[1] = '\0';
+#if !LOCK_TABLE
+    Table[i].lock_.init();
+#if defined(DLR2) || defined(DLR3)
+    Table[i].owners_.init();
+    Table[i].waiters_.init();
+#endif
+#if BAMBOO
+    Table[i].dirty_.store(0, std::memory_order_relaxed);
+#endif
+#endif
 
 #if MASSTREE_USE
     MT.insert_value(i, &Table[i]);
@@ -90,6 +109,17 @@ void makeDB() {
   // 初期値はハードウェア最大値。
   // FLAGS_tuple_num を均等に分割できる最大スレッド数を求める。
   size_t maxthread = decideParallelBuildNumber(FLAGS_tuple_num);
+#if LOCK_TABLE
+  LockTbl.init(FLAGS_lock_buckets);
+#else
+  SelectedLock::initGlobal(FLAGS_thread_num);
+#endif
+#if defined(DLR2) || defined(DLR3)
+  Priorities = new TxPriority[FLAGS_thread_num];
+#endif
+#if BAMBOO
+  Outcomes = new TxOutcome[FLAGS_thread_num];
+#endif
 
   std::vector<std::thread> thv;
   // cout << "masstree 並列構築スレッド数 " << maxthread << endl;
@@ -106,10 +136,17 @@ ShowOptParameters()
   cout << "#ShowOptParameters()"
     << ": ADD_ANALYSIS " << ADD_ANALYSIS
     << ": BACK_OFF " << BACK_OFF
+    << ": BAMBOO " << BAMBOO
+    << ": LOCK_KIND " << LOCK_KIND << " (" << LockOf<LOCK_KIND>::name << ")"
+    << ": LOCK_TABLE " << LOCK_TABLE
 #ifdef DLR0
     << ": DLR0 "
 #elif defined DLR1
     << ": DLR1 "
+#elif defined DLR2
+    << ": DLR2 "
+#elif defined DLR3
+    << ": DLR3 "
 #endif
     << ": MASSTREE_USE " << MASSTREE_USE
     << ": KEY_SIZE " << KEY_SIZE
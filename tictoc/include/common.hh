@@ -39,6 +39,12 @@ DEFINE_uint64(max_ope, 10,
 DEFINE_bool(rmw, false,
             "True means read modify write, false means blind write.");
 DEFINE_uint64(rratio, 50, "read ratio of single transaction.");
+DEFINE_uint64(rts_lease, 16,
+              "Initial read timestamp lease. It is used by RTS_LEASE.");
+DEFINE_bool(rts_lease_adaptive, true,
+            "True adapts the lease by write aborts. It is used by RTS_LEASE.");
+DEFINE_uint64(rts_lease_max, 4096,
+              "Max read timestamp lease. It is used by RTS_LEASE.");
 DEFINE_uint64(thread_num, 10, "Total number of worker threads.");
 DEFINE_uint64(tuple_num, 1000000, "Total number of records.");
 DEFINE_bool(ycsb, true,
@@ -50,6 +56,9 @@ DECLARE_uint64(extime);
 DECLARE_uint64(max_ope);
 DECLARE_bool(rmw);
 DECLARE_uint64(rratio);
+DECLARE_uint64(rts_lease);
+DECLARE_bool(rts_lease_adaptive);
+DECLARE_uint64(rts_lease_max);
 DECLARE_uint64(thread_num);
 DECLARE_uint64(tuple_num);
 DECLARE_bool(ycsb);
@@ -40,10 +40,28 @@ class TxExecutor {
   vector<OpElement<Tuple>> cll_;  // current lock list;
   // use for lockWriteSet() to record locks;
 
+#if RTS_LEASE
+  /**
+   * A reader extends rts to commit_ts + lease_, so one CAS covers later
+   * readers. Large lease raises commit_ts of writers, so lease_ is halved when
+   * such write aborts exceed kLeaseAbortPercent of a window of
+   * kLeaseWindow transactions, and doubled otherwise.
+   */
+  static constexpr uint64_t kLeaseWindow = 1000;
+  static constexpr uint64_t kLeaseAbortPercent = 1;
+  uint64_t lease_;
+  uint64_t lease_commits_ = 0;
+  uint64_t lease_write_aborts_ = 0;
+  bool lease_abort_ = false;
+#endif
+
   char write_val_[VAL_SIZE];
   char return_val_[VAL_SIZE];
 
   TxExecutor(int thid, Result* tres) : thid_(thid), tres_(tres) {
+#if RTS_LEASE
+    lease_ = FLAGS_rts_lease;
+#endif
     read_set_.reserve(FLAGS_max_ope);
     write_set_.reserve(FLAGS_max_ope);
     cll_.reserve(FLAGS_max_ope);
@@ -57,7 +75,14 @@ class TxExecutor {
   void write(uint64_t key);
   bool validationPhase();
   bool preemptiveAborts(const TsWord& v1);
+#if TIMESTAMP_HISTORY
+  bool chkTimestampHistory(Tuple* tuple, uint64_t wts);
+  void pushTimestampHistory(Tuple* tuple);
+#endif
   void abort();
+#if RTS_LEASE
+  void adaptLease();
+#endif
   void writePhase();
   void lockWriteSet();
   void unlockCLL();
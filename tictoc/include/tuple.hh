@@ -33,9 +33,39 @@ struct TsWord {
 
   uint64_t rts() const { return wts + delta; }
 };
+#if TIMESTAMP_HISTORY
+/**
+ * @brief Interval [wts, wts + gap) in which an overwritten version was the
+ * latest one. gap saturates, which only shrinks the interval.
+ * @detail It is packed into a word, so readers get a consistent one without
+ * the lock. wts of a record strictly increases, so an entry whose wts matches
+ * the read version always describes that version.
+ */
+struct TsHistory {
+  union {
+    uint64_t obj_;
+    struct {
+      uint16_t gap : 16;
+      uint64_t wts : 48;
+    };
+  };
+
+  static constexpr uint64_t kMaxGap = 0xffff;
+
+  TsHistory() { obj_ = 0; }
+};
+#endif
+
 class Tuple {
  public:
   alignas(CACHE_LINE_SIZE) TsWord tsw_;
-  TsWord pre_tsw_;
+#if TIMESTAMP_HISTORY
+  /**
+   * ring of the last TIMESTAMP_HISTORY_DEPTH overwritten versions.
+   * history_head_ is the next slot. Writers update them under the lock.
+   */
+  uint32_t history_head_;
+  TsHistory history_[TIMESTAMP_HISTORY_DEPTH];
+#endif
   char val_[VAL_SIZE];
 };
@@ -131,6 +131,11 @@ int main(int argc, char* argv[]) try {
   }
   ShowOptParameters();
   TicTocResult[0].displayAllResult(FLAGS_clocks_per_us, FLAGS_extime, FLAGS_thread_num);
+#if TIMESTAMP_HISTORY
+  cout << "timestamp_history_bytes_per_record:\t"
+       << sizeof(Tuple::history_head_) + sizeof(Tuple::history_) << endl;
+#endif
+  cout << "tuple_bytes:\t" << sizeof(Tuple) << endl;
 
   return 0;
 } catch (bad_alloc) {
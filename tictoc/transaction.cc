@@ -59,6 +59,9 @@ void TxExecutor::begin() {
   this->status_ = TransactionStatus::inFlight;
   this->commit_ts_ = 0;
   this->appro_commit_ts_ = 0;
+#if RTS_LEASE
+  lease_abort_ = false;
+#endif
 }
 
 /**
@@ -86,6 +89,44 @@ bool TxExecutor::preemptiveAborts(const TsWord &v1) {
   return false;
 }
 
+#if TIMESTAMP_HISTORY
+/**
+ * @brief Check whether the overwritten version which this transaction read
+ * was the latest one at commit_ts_.
+ * @param [in] tuple record of the version.
+ * @param [in] wts write timestamp of the version.
+ * @return true it can be serialized at commit_ts_.
+ * @return false the version is not in the history or commit_ts_ is out of
+ * its interval.
+ */
+bool TxExecutor::chkTimestampHistory(Tuple *tuple, uint64_t wts) {
+  for (unsigned int i = 0; i < TIMESTAMP_HISTORY_DEPTH; ++i) {
+    TsHistory hist;
+    hist.obj_ = __atomic_load_n(&(tuple->history_[i].obj_), __ATOMIC_ACQUIRE);
+    if (hist.wts == wts) return commit_ts_ < hist.wts + hist.gap;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Push the version which this transaction overwrites into the
+ * timestamp history ring. The caller holds the lock of the record.
+ * @param [in] tuple record locked by this transaction.
+ * @return void
+ */
+void TxExecutor::pushTimestampHistory(Tuple *tuple) {
+  TsWord old;
+  old.obj_ = __atomic_load_n(&(tuple->tsw_.obj_), __ATOMIC_ACQUIRE);
+  TsHistory hist;
+  hist.wts = old.wts;
+  hist.gap = min(this->commit_ts_ - old.wts, TsHistory::kMaxGap);
+  __atomic_store_n(&(tuple->history_[tuple->history_head_].obj_), hist.obj_,
+                   __ATOMIC_RELAXED);
+  tuple->history_head_ = (tuple->history_head_ + 1) % TIMESTAMP_HISTORY_DEPTH;
+}
+#endif
+
 /**
  * @brief Transaction read function.
  * @param [in] key The key of key-value
@@ -229,6 +270,14 @@ bool TxExecutor::validationPhase() {
   //
   asm volatile("" ::: "memory");
 
+#if RTS_LEASE
+  /**
+   * If the write set decides commit_ts, leases of its records may raise it
+   * and fail the validation of the read set.
+   */
+  uint64_t write_ts = commit_ts_;
+#endif
+
   // step2, compute the commit timestamp
   for (auto itr = read_set_.begin(); itr != read_set_.end(); ++itr)
 		/**
@@ -240,6 +289,9 @@ bool TxExecutor::validationPhase() {
 		 * The result reduces two loops and improves performance. 
 		 */
     commit_ts_ = max(commit_ts_, (*itr).tsw_.wts);
+#if RTS_LEASE
+  lease_abort_ = !write_set_.empty() && write_ts == commit_ts_;
+#endif
 
   // step3, validate the read set.
   for (auto itr = read_set_.begin(); itr != read_set_.end(); ++itr) {
@@ -254,10 +306,7 @@ bool TxExecutor::validationPhase() {
         if ((*itr).tsw_.wts != v1.wts) {
           // start timestamp history processing
 #if TIMESTAMP_HISTORY
-          TsWord pre_v1;
-          pre_v1.obj_ = __atomic_load_n(&((*itr).rcdptr_->pre_tsw_.obj_),
-                                        __ATOMIC_ACQUIRE);
-          if (pre_v1.wts <= commit_ts_ && commit_ts_ < v1.wts) {
+          if (chkTimestampHistory((*itr).rcdptr_, (*itr).tsw_.wts)) {
 						/**
 						 * Success
 						 */
@@ -303,7 +352,11 @@ bool TxExecutor::validationPhase() {
         // extend the rts of the tuple
         if ((v1.rts()) < commit_ts_) {
           // Handle delta overflow
+#if RTS_LEASE
+          uint64_t delta = commit_ts_ + lease_ - v1.wts;
+#else
           uint64_t delta = commit_ts_ - v1.wts;
+#endif
           uint64_t shift = delta - (delta & 0x7fff);
           v2.obj_ = v1.obj_;
           v2.wts = v2.wts + shift;
@@ -323,12 +376,33 @@ bool TxExecutor::validationPhase() {
       }
     }
   }
+#if RTS_LEASE
+  lease_abort_ = false;
+#endif
 #if ADD_ANALYSIS
   tres_->local_vali_latency_ += rdtscp() - start;
 #endif
   return true;
 }
 
+#if RTS_LEASE
+/**
+ * @brief adapt lease_ at the end of each window of transactions.
+ * @return void
+ */
+void TxExecutor::adaptLease() {
+  if (!FLAGS_rts_lease_adaptive) return;
+  if (lease_commits_ + lease_write_aborts_ < kLeaseWindow) return;
+
+  if (lease_write_aborts_ * 100 > lease_commits_ * kLeaseAbortPercent)
+    lease_ /= 2;
+  else
+    lease_ = min(max(lease_ * 2, (uint64_t)1), FLAGS_rts_lease_max);
+  lease_commits_ = 0;
+  lease_write_aborts_ = 0;
+}
+#endif
+
 /**
  * @brief function about abort.
  * Clean-up local read/write set.
@@ -353,6 +427,13 @@ void TxExecutor::abort() {
 
   ++tres_->local_abort_counts_;
 
+#if RTS_LEASE
+  if (lease_abort_) {
+    ++lease_write_aborts_;
+    adaptLease();
+  }
+#endif
+
 #if BACK_OFF
 
 #if ADD_ANALYSIS
@@ -382,8 +463,7 @@ void TxExecutor::writePhase() {
     result.delta = 0;
     result.lock = 0;
 #if TIMESTAMP_HISTORY
-    __atomic_store_n(&((*itr).rcdptr_->pre_tsw_.obj_), (*itr).tsw_.obj_,
-                     __ATOMIC_RELAXED);
+    pushTimestampHistory((*itr).rcdptr_);
 #endif
     __atomic_store_n(&((*itr).rcdptr_->tsw_.obj_), result.obj_,
                      __ATOMIC_RELEASE);
@@ -395,6 +475,11 @@ void TxExecutor::writePhase() {
   read_set_.clear();
   write_set_.clear();
   cll_.clear();
+
+#if RTS_LEASE
+  ++lease_commits_;
+  adaptLease();
+#endif
 }
 
 /**
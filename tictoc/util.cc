@@ -62,6 +62,9 @@ void displayParameter() {
   cout << "#FLAGS_max_ope:\t\t" << FLAGS_max_ope << endl;
   cout << "#FLAGS_rmw:\t\t" << FLAGS_rmw << endl;
   cout << "#FLAGS_rratio:\t\t" << FLAGS_rratio << endl;
+  cout << "#FLAGS_rts_lease:\t" << FLAGS_rts_lease << endl;
+  cout << "#FLAGS_rts_lease_adaptive:\t" << FLAGS_rts_lease_adaptive << endl;
+  cout << "#FLAGS_rts_lease_max:\t" << FLAGS_rts_lease_max << endl;
   cout << "#FLAGS_thread_num:\t" << FLAGS_thread_num << endl;
   cout << "#FLAGS_tuple_num:\t" << FLAGS_tuple_num << endl;
   cout << "#FLAGS_ycsb:\t\t" << FLAGS_ycsb << endl;
@@ -76,7 +79,11 @@ void partTableInit([[maybe_unused]] size_t thid, uint64_t start, uint64_t end) {
   for (auto i = start; i <= end; ++i) {
     Tuple *tmp = &Table[i];
     tmp->tsw_.obj_ = 0;
-    tmp->pre_tsw_.obj_ = 0;
+#if TIMESTAMP_HISTORY
+    tmp->history_head_ = 0;
+    for (unsigned int j = 0; j < TIMESTAMP_HISTORY_DEPTH; ++j)
+      tmp->history_[j].obj_ = 0;
+#endif
     tmp->val_[0] = 'a';
     tmp->val_[1] = '\0';
 
@@ -91,8 +98,10 @@ void ShowOptParameters() {
        << ": ADD_ANALYSIS " << ADD_ANALYSIS << ": BACK_OFF " << BACK_OFF
        << ": KEY_SIZE " << KEY_SIZE << ": MASSTREE_USE " << MASSTREE_USE
        << ": NO_WAIT_LOCKING_IN_VALIDATION " << NO_WAIT_LOCKING_IN_VALIDATION
-       << ": PREEMPTIVE_ABORTS " << PREEMPTIVE_ABORTS << ": SLEEP_READ_PHASE "
+       << ": PREEMPTIVE_ABORTS " << PREEMPTIVE_ABORTS << ": RTS_LEASE "
+       << RTS_LEASE << ": SLEEP_READ_PHASE "
        << SLEEP_READ_PHASE << ": TIMESTAMP_HISTORY " << TIMESTAMP_HISTORY
+       << ": TIMESTAMP_HISTORY_DEPTH " << TIMESTAMP_HISTORY_DEPTH
        << ": VAL_SIZE " << VAL_SIZE << endl;
 }
 